@@ -13,11 +13,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 // sync submodule
 #include <sync/sync.h>
 
+// C linkage, for C++ callers
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Platform dependent macros
 #ifdef _WIN64
 #define DLLEXPORT extern __declspec(dllexport)
@@ -30,15 +36,145 @@
 #define PRIORITY_QUEUE_REALLOC(p, sz) realloc(p,sz)
 #endif
 
+// Latency histograms hold 16 buckets for each power of two, up to 2 ^ 40 nanoseconds
+#define PRIORITY_QUEUE_HISTOGRAM_BUCKETS 592
+
+// Bucket queues hold up to 4096 levels, 64 for each bit of the summary word
+#define PRIORITY_QUEUE_BUCKET_LEVELS_MAX 4096
+
 // Forward declarations
 struct priority_queue_s;
 
+// Enumeration definitions
+/** !
+ *  @brief Layouts of the heap in memory
+ */
+enum priority_queue_layout_e
+{
+    PRIORITY_QUEUE_LAYOUT_BINARY   = 0, // Implicit binary heap. The children of i are 2i + 1 and 2i + 2
+    PRIORITY_QUEUE_LAYOUT_BLOCKED  = 1, // Page blocked binary heap. Each page holds a complete subtree
+    PRIORITY_QUEUE_LAYOUT_SEQUENCE = 2  // Sequence heap. A small insertion heap, and groups of sorted sequences
+};
+
+/** !
+ *  @brief Types of priorities. Inline priorities are compared without a compare 
+ *         function, and lower priorities are dequeued first, like the default 
+ *         compare function
+ */
+enum priority_queue_priority_type_e
+{
+    PRIORITY_QUEUE_PRIORITY_COMPARATOR = 0, // Keys are ordered by the compare function
+    PRIORITY_QUEUE_PRIORITY_U32        = 1, // 32 bit unsigned integer priorities, stored inline
+    PRIORITY_QUEUE_PRIORITY_U64        = 2, // 64 bit unsigned integer priorities, stored inline
+    PRIORITY_QUEUE_PRIORITY_FLOAT      = 3, // Single precision floating point priorities, stored inline
+    PRIORITY_QUEUE_PRIORITY_LEVEL      = 4, // Small integer levels, in a bucket queue. See priority_queue_construct_bucket
+    PRIORITY_QUEUE_PRIORITY_INDEX      = 5  // 32 bit priorities of 32 bit indices, packed into 8 bytes. See priority_queue_enqueue_index
+};
+
+/** !
+ *  @brief Timed operations of a priority queue
+ */
+enum priority_queue_operation_e
+{
+    PRIORITY_QUEUE_OPERATION_ENQUEUE   = 0, // Enqueues, with or without an inline priority
+    PRIORITY_QUEUE_OPERATION_DEQUEUE   = 1, // Dequeues, with or without an inline priority
+    PRIORITY_QUEUE_OPERATION_DRAIN     = 2, // Sorted drains
+    PRIORITY_QUEUE_OPERATION_LOCK_WAIT = 3, // Waits to acquire the lock
+    PRIORITY_QUEUE_OPERATION_LOCK_HOLD = 4, // Time between acquiring and releasing the lock
+    PRIORITY_QUEUE_OPERATION_QUANTITY  = 5
+};
+
+// Structure definitions
+/** !
+ *  @brief Operation statistics of a priority queue. Only counted when the library
+ *         is built with PRIORITY_QUEUE_STATS
+ */
+struct priority_queue_statistics_s
+{
+    uint64_t enqueues,               // Keys added
+             dequeues,               // Keys removed
+             comparisons,            // Calls to the compare function
+             swaps,                  // Keys moved by sifts
+             sifts,                  // Sifts toward the root or the leaves
+             sift_levels,            // Levels moved by every sift
+             max_sift_depth,         // Levels moved by the deepest sift
+             high_water,             // Most keys held at once
+             overflows,              // Enqueues into a full priority queue
+             lock_acquisitions,      // Times the lock was acquired
+             contended_acquisitions, // Times the lock was held by another thread when requested
+             lock_wait_ns;           // Nanoseconds spent acquiring the lock
+};
+
+/** !
+ *  @brief A latency histogram, in nanoseconds. Only recorded when the library is 
+ *         built with PRIORITY_QUEUE_HISTOGRAMS
+ */
+struct priority_queue_histogram_s
+{
+    uint64_t counts[PRIORITY_QUEUE_HISTOGRAM_BUCKETS], // Latencies counted in each bucket
+             count,                                    // Latencies counted
+             sum,                                      // Sum of every latency
+             min,                                      // Smallest latency
+             max;                                      // Largest latency
+};
+
 // Type definitions
 /** !
  *  @brief The type definition of a priority queue struct
  */
 typedef struct priority_queue_s priority_queue;
 
+/** !
+ *  @brief The type definition of a priority queue layout
+ */
+typedef enum priority_queue_layout_e priority_queue_layout;
+
+/** !
+ *  @brief The type definition of a priority type
+ */
+typedef enum priority_queue_priority_type_e priority_queue_priority_type;
+
+/** !
+ *  @brief The type definition of a timed operation
+ */
+typedef enum priority_queue_operation_e priority_queue_operation;
+
+/** !
+ *  @brief The type definition of a latency histogram
+ */
+typedef struct priority_queue_histogram_s priority_queue_histogram;
+
+/** !
+ *  @brief The type definition of priority queue statistics
+ */
+typedef struct priority_queue_statistics_s priority_queue_statistics;
+
+/** !
+ *  @brief The type definition of a snapshot of the keys of a priority queue
+ */
+typedef struct priority_queue_snapshot_s priority_queue_snapshot;
+
+/** !
+ *  @brief The type definition of a fair queue, which shares dequeues between tenants
+ */
+typedef struct priority_queue_fair_s priority_queue_fair;
+
+/** !
+ *  @brief The type definition of a delay queue, whose keys are dequeued after a ready time
+ */
+typedef struct priority_queue_delay_s priority_queue_delay;
+
+/** !
+ *  @brief The type definition of an inline priority. The member in use is set by
+ *         the priority type of the priority queue
+ */
+typedef union
+{
+    uint32_t u32;
+    uint64_t u64;
+    float    f32;
+} priority_queue_priority;
+
 /** !
  *  @brief The type definition for a function that tests the equality of priorities
  * 
@@ -49,6 +185,111 @@ typedef struct priority_queue_s priority_queue;
  */
 typedef int (priority_queue_equal_fn)(const void *const p_a, const void *const p_b);
 
+/** !
+ *  @brief The type definition for a function that computes the priority of a key
+ * 
+ *  @param p_key the key
+ * 
+ *  @return the priority of the key
+ */
+typedef priority_queue_priority (priority_queue_priority_fn)(const void *const p_key);
+
+/** !
+ *  @brief The type definition for a function that serializes a key
+ * 
+ *  @param p_buffer the buffer to write the key to
+ *  @param size     the size of the buffer in bytes
+ *  @param p_key    the key
+ * 
+ *  @return the size of the serialized key in bytes, which may exceed size, or 0 on error
+ */
+typedef size_t (priority_queue_serialize_fn)(void *const p_buffer, size_t size, const void *const p_key);
+
+/** !
+ *  @brief The type definition for a function that deserializes a key
+ * 
+ *  @param pp_key   return
+ *  @param p_buffer the serialized key
+ *  @param size     the size of the serialized key in bytes
+ * 
+ *  @return 1 on success, 0 on error
+ */
+typedef int (priority_queue_deserialize_fn)(void **const pp_key, const void *const p_buffer, size_t size);
+
+/** !
+ *  @brief The type definition for a tracepoint of a key
+ * 
+ *  @param p_priority_queue the priority queue
+ *  @param p_key            the key that was enqueued or dequeued
+ *  @param p_context        the context of the callback table
+ * 
+ *  @return void
+ */
+typedef void (priority_queue_trace_key_fn)(const priority_queue *const p_priority_queue, const void *const p_key, void *const p_context);
+
+/** !
+ *  @brief The type definition for a tracepoint of heapify
+ * 
+ *  @param p_priority_queue the priority queue
+ *  @param index            the index the key came to rest at
+ *  @param levels           the quantity of levels the key moved
+ *  @param p_context        the context of the callback table
+ * 
+ *  @return void
+ */
+typedef void (priority_queue_trace_heapify_fn)(const priority_queue *const p_priority_queue, size_t index, size_t levels, void *const p_context);
+
+/** !
+ *  @brief The type definition for a tracepoint of the lock
+ * 
+ *  @param p_priority_queue the priority queue
+ *  @param p_context        the context of the callback table
+ * 
+ *  @return void
+ */
+typedef void (priority_queue_trace_lock_fn)(const priority_queue *const p_priority_queue, void *const p_context);
+
+/** !
+ *  @brief The type definition for a function that gives a key a new priority
+ * 
+ *  @param p_key      the key
+ *  @param p_priority the inline priority of the key, which may be changed, or 0 if 
+ *                    the priority queue orders keys by a compare function
+ *  @param p_context  the context passed to priority_queue_reprioritize
+ * 
+ *  @return the key to keep in its place, which may be p_key
+ */
+typedef void *(priority_queue_reprioritize_fn)(void *p_key, priority_queue_priority *p_priority, void *p_context);
+
+/** !
+ *  @brief The type definition for a function that visits a key
+ * 
+ *  @param p_key     the key
+ *  @param p_context the context passed to priority_queue_for_each
+ * 
+ *  @return 1 to visit the next key, 0 to stop
+ */
+typedef int (priority_queue_for_each_fn)(void *p_key, void *p_context);
+
+/** !
+ *  @brief Callbacks fired by the tracepoints of every priority queue. Only fired when 
+ *         the library is built with PRIORITY_QUEUE_TRACE. Any callback may be 0
+ */
+struct priority_queue_trace_s
+{
+    priority_queue_trace_key_fn     *pfn_enqueue;      // After a key is enqueued
+    priority_queue_trace_key_fn     *pfn_dequeue;      // After a key is dequeued
+    priority_queue_trace_heapify_fn *pfn_heapify;      // After a key is sifted toward the leaves
+    priority_queue_trace_lock_fn    *pfn_lock_acquire; // After the lock is acquired
+    priority_queue_trace_lock_fn    *pfn_lock_release; // Before the lock is released
+    void                            *p_context;        // Passed to each callback
+};
+
+/** !
+ *  @brief The type definition of a tracepoint callback table
+ */
+typedef struct priority_queue_trace_s priority_queue_trace;
+
 // Allocaters
 /** !
  *  Allocate memory for a priority queue
@@ -76,22 +317,206 @@ DLLEXPORT int priority_queue_create ( priority_queue **const pp_priority_queue )
  */
 DLLEXPORT int priority_queue_construct ( priority_queue **const pp_priority_queue, size_t size, priority_queue_equal_fn pfn_compare_function );
 
-// Constructors
 /** !
- *  Construct a priority queue with a specific number of entries
+ *  Construct a priority queue with a specific number of entries and layout. The
+ *  blocked layout keeps each sift within one page for several levels at a time, 
+ *  which keeps latency flat when the heap is much larger than the cache. The 
+ *  sequence layout sorts a cache sized insertion heap into a sequence each time it 
+ *  fills, and merges sequences with loser trees, so nearly every access to a large
+ *  queue is sequential
  *
  * @param pp_priority_queue    return
- * @param keys                 pointer to null terminated array of keys
  * @param size                 number of priority queue entries. 
  * @param pfn_compare_function pointer to a compare function, or 0 for default
+ * @param layout               the layout of the heap in memory
  *
- * @sa priority_queue_create
+ * @sa priority_queue_construct
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_construct_with_layout ( priority_queue **const pp_priority_queue, size_t size, priority_queue_equal_fn pfn_compare_function, priority_queue_layout layout );
+
+/** !
+ *  Construct a priority queue with a specific number of entries, that stores 
+ *  priorities inline. On x86, the best of 4 or 8 children is selected with SSE4 or
+ *  AVX2 when the processor supports it
+ * 
+ *  PRIORITY_QUEUE_PRIORITY_INDEX makes a compact priority queue, where each key is 
+ *  an index into a table owned by the caller, packed with its priority into 8 bytes. 
+ *  No key pointers are stored, and an arity of 8 fits the children of a key in one 
+ *  cache line. The low 32 bits of each key are kept, and equal priorities are 
+ *  dequeued in order of index
+ *
+ * @param pp_priority_queue return
+ * @param size              number of priority queue entries
+ * @param type              the type of the priorities
+ * @param arity             the number of children of each key; 2, 4, or 8
+ * @param pfn_priority      pointer to a function that computes the priority of a key, 
+ *                          or 0 to use the value of the key
+ *
+ * @sa priority_queue_enqueue_priority
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_construct_typed ( priority_queue **const pp_priority_queue, size_t size, priority_queue_priority_type type, size_t arity, priority_queue_priority_fn pfn_priority );
+
+/** !
+ *  Construct a bucket queue, for a small range of integer priorities. Each level 
+ *  holds its keys first in, first out, and the first occupied level is found with
+ *  two find first set instructions on a bitmap of the levels, so enqueue and 
+ *  dequeue take constant time. Lower levels are dequeued first, and levels past 
+ *  the last are stored in the last level
+ *
+ * @param pp_priority_queue return
+ * @param size              number of priority queue entries
+ * @param levels            the number of levels, up to PRIORITY_QUEUE_BUCKET_LEVELS_MAX
+ * @param pfn_priority      pointer to a function that computes the level of a key in 
+ *                          the u32 member, or 0 to use the value of the key
+ *
+ * @sa priority_queue_enqueue_priority
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_construct_bucket ( priority_queue **const pp_priority_queue, size_t size, size_t levels, priority_queue_priority_fn pfn_priority );
+
+/** !
+ *  Construct a fair queue. Each tenant owns a heap of its keys, ordered by 
+ *  the compare function. Dequeues are shared between tenants by weighted fair 
+ *  queuing: a tenant with twice the weight of another dequeues twice the cost, while
+ *  both have keys. The next tenant is found in a heap of tenants, in O(log tenants),
+ *  so a tenant with many keys can not delay the others
+ *
+ * @param pp_fair              return
+ * @param tenants              the quantity of tenants
+ * @param size                 the quantity of keys each tenant may hold
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ *
+ * @sa priority_queue_fair_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_fair_construct ( priority_queue_fair **const pp_fair, size_t tenants, size_t size, priority_queue_equal_fn pfn_compare_function );
+
+#ifndef _WIN64
+/** !
+ *  Construct a delay queue. Each key has a ready time, and waits in a heap of ready 
+ *  times until then. A dequeue moves every key that became ready into a priority 
+ *  queue, ordered by the compare function, and takes the highest priority key. Ready 
+ *  times are in the units of timer_high_precision
+ *
+ * @param pp_delay             return
+ * @param size                 the maximum quantity of keys
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ *
+ * @sa priority_queue_delay_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_delay_construct ( priority_queue_delay **const pp_delay, size_t size, priority_queue_equal_fn pfn_compare_function );
+#endif
+
+// Constructors
+/** !
+ *  Construct a priority queue from an array of keys, in linear time. Large arrays are
+ *  built with one thread per processor
+ *
+ * @param pp_priority_queue    return
+ * @param keys                 pointer to an array of keys
+ * @param size                 the quantity of keys, and of priority queue entries. A null key ends the array early
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ *
+ * @sa priority_queue_from_keys_parallel
  * @sa priority_queue_destroy
  *
  * @return 1 on success, 0 on error
  */
 DLLEXPORT int priority_queue_from_keys ( const priority_queue **const pp_priority_queue, const char **const keys, size_t size, priority_queue_equal_fn pfn_compare_function );
 
+/** !
+ *  Construct a priority queue from an array of keys, in linear time, with a specific 
+ *  quantity of threads. Worker threads build independent subtrees, and the calling 
+ *  thread finishes the top levels
+ *
+ * @param pp_priority_queue    return
+ * @param keys                 pointer to an array of keys
+ * @param size                 the quantity of keys, and of priority queue entries. A null key ends the array early
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ * @param threads              the quantity of threads, or 0 for one per processor
+ *
+ * @sa priority_queue_from_keys
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_from_keys_parallel ( const priority_queue **const pp_priority_queue, const char **const keys, size_t size, priority_queue_equal_fn pfn_compare_function, size_t threads );
+
+#ifndef _WIN64
+/** !
+ *  Construct a priority queue whose entries live in a memory mapped file. If the 
+ *  file holds a valid priority queue, it is mapped and validated in constant time. 
+ *  Else, a new priority queue with "size" entries is written to the file. 
+ * 
+ *  Keys are stored by value, so they must be integers, offsets, or indices, 
+ *  never raw pointers. Changes become durable at each call to priority_queue_checkpoint
+ *
+ * @param pp_priority_queue    return
+ * @param path                 path to the backing file
+ * @param size                 number of priority queue entries, if the file is created
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ *
+ * @sa priority_queue_checkpoint
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_construct_mapped ( priority_queue **const pp_priority_queue, const char *const path, size_t size, priority_queue_equal_fn pfn_compare_function );
+
+/** !
+ *  Construct a priority queue from a file descriptor positioned at the start of a 
+ *  saved priority queue. Keys are read in heap order, so the heap is not rebuilt
+ *
+ * @param pp_priority_queue    return
+ * @param fd                   the file descriptor to read from
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ * @param pfn_deserialize      pointer to a deserializer, or 0 to read each key by value
+ *
+ * @sa priority_queue_save
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_load ( priority_queue **const pp_priority_queue, int fd, priority_queue_equal_fn pfn_compare_function, priority_queue_deserialize_fn pfn_deserialize );
+
+/** !
+ *  Construct an external memory priority queue, that holds more keys than fit in 
+ *  memory. Half of the memory budget holds an in memory heap. When the heap is full,
+ *  it is sorted and written to an unlinked temporary file as one sequential run. 
+ *  The other half of the budget holds one read buffer per run, and the runs are 
+ *  merged with a loser tree. When there is no room for another read buffer, every 
+ *  run is merged into one
+ * 
+ *  Keys that reach the disk are recreated with pfn_deserialize when they are 
+ *  dequeued. The priority queue does not free the keys it serializes
+ *
+ * @param pp_priority_queue    return
+ * @param memory_budget        the size of the heap and the read buffers in bytes; 
+ *                             at least 4 blocks
+ * @param block_size           the size of each read and write in bytes; at least 64
+ * @param directory            the directory of the temporary files, or 0 for TMPDIR or /tmp
+ * @param pfn_compare_function pointer to a compare function, or 0 for default
+ * @param pfn_serialize        pointer to a serializer, or 0 to write each key by value
+ * @param pfn_deserialize      pointer to a deserializer, or 0 to read each key by value
+ *
+ * @sa priority_queue_destroy
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_construct_external ( priority_queue **const pp_priority_queue, size_t memory_budget, size_t block_size, const char *const directory, priority_queue_equal_fn pfn_compare_function, priority_queue_serialize_fn pfn_serialize, priority_queue_deserialize_fn pfn_deserialize );
+#endif
+
 // Accessors
 /** !
  * Is the priority queue empty?
@@ -102,6 +527,181 @@ DLLEXPORT int priority_queue_from_keys ( const priority_queue **const pp_priorit
  */
 DLLEXPORT bool priority_queue_empty ( priority_queue *const p_priority_queue );
 
+/** !
+ * Check if a fair queue is empty
+ *
+ * @param p_fair the fair queue
+ *
+ * @return true if every tenant is empty, else false
+ */
+DLLEXPORT bool priority_queue_fair_empty ( priority_queue_fair *const p_fair );
+
+#ifndef _WIN64
+/** !
+ * Get the time the next key of a delay queue is ready
+ *
+ * @param p_delay the delay queue
+ * @param p_ready return, now if a key is ready, else the earliest ready time
+ *
+ * @return 1 on success, 0 if the delay queue is empty or on error
+ */
+DLLEXPORT int priority_queue_delay_next ( priority_queue_delay *const p_delay, timestamp *p_ready );
+#endif
+
+/** !
+ * Get the key in the front of the priority queue, without removing it
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ * 
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_peek ( priority_queue *const p_priority_queue, void **pp_key );
+
+/** !
+ * Copy every key of the priority queue, in order of priority. The queue is locked 
+ * only to snapshot its keys. The snapshot is sorted in partitions on worker threads, 
+ * and the partitions are merged. The priority queue is not modified
+ * 
+ * @param p_priority_queue the priority queue
+ * @param ppp_keys         return, the highest priority key first. Free with PRIORITY_QUEUE_REALLOC(keys, 0)
+ * @param p_count          return, the quantity of keys
+ * @param threads          the quantity of threads, or 0 for one per processor
+ * 
+ * @sa priority_queue_drain_sorted
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_sorted_copy_parallel ( priority_queue *const p_priority_queue, void ***ppp_keys, size_t *p_count, size_t threads );
+
+/** !
+ * Get an eventfd that is readable while the priority queue holds keys, for epoll
+ * and other event loops. The eventfd is written when the priority queue becomes
+ * non empty, and read when it becomes empty, so a burst of enqueues costs one
+ * write. Do not read or close the eventfd. The eventfd is made on the first call, 
+ * which should come before other threads use the priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return a file descriptor on success, -1 on error or if eventfd is not available
+*/
+DLLEXPORT int priority_queue_get_fd ( priority_queue *const p_priority_queue );
+
+/** !
+ * Visit every key of the priority queue, in no particular order, under the lock. 
+ * The callback must not call the priority queue. Invalidated keys that were not 
+ * compacted yet are visited
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pfn_for_each     the callback
+ * @param p_context        passed to the callback
+ * 
+ * @sa priority_queue_snapshot_acquire
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_for_each ( priority_queue *const p_priority_queue, priority_queue_for_each_fn *pfn_for_each, void *p_context );
+
+/** !
+ * Take a snapshot of the keys of the priority queue, for long scans that should not
+ * hold the lock. The snapshot shares the entries of the priority queue, so taking 
+ * one costs no copy. The next modification copies the entries, and leaves the old 
+ * ones to the snapshot. Snapshots taken between modifications share one copy
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_snapshot      return
+ * 
+ * @sa priority_queue_snapshot_release
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_snapshot_acquire ( priority_queue *const p_priority_queue, priority_queue_snapshot **const pp_snapshot );
+
+/** !
+ * Get the quantity of keys in a snapshot
+ * 
+ * @param p_snapshot the snapshot
+ * 
+ * @return the quantity of keys
+*/
+DLLEXPORT size_t priority_queue_snapshot_count ( const priority_queue_snapshot *const p_snapshot );
+
+/** !
+ * Visit every key of a snapshot, in no particular order, without locking the 
+ * priority queue
+ * 
+ * @param p_snapshot   the snapshot
+ * @param pfn_for_each the callback
+ * @param p_context    passed to the callback
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_snapshot_for_each ( const priority_queue_snapshot *const p_snapshot, priority_queue_for_each_fn *pfn_for_each, void *p_context );
+
+/** !
+ * Get the operation statistics of the priority queue. Each thread counts into its 
+ * own stripe, and the stripes are merged here
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_statistics     return
+ * 
+ * @sa priority_queue_stats_reset
+ * 
+ * @return 1 on success, 0 on error or if statistics are not compiled in
+ */
+DLLEXPORT int priority_queue_stats ( priority_queue *const p_priority_queue, priority_queue_statistics *const p_statistics );
+
+/** !
+ * Copy the latency histogram of an operation of the priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * @param operation        the operation
+ * @param p_histogram      return
+ * 
+ * @sa priority_queue_histogram_percentile
+ * 
+ * @return 1 on success, 0 on error or if histograms are not compiled in
+ */
+DLLEXPORT int priority_queue_histogram_snapshot ( priority_queue *const p_priority_queue, priority_queue_operation operation, priority_queue_histogram *const p_histogram );
+
+/** !
+ * Get a percentile of a latency histogram. The result is the largest latency of the
+ * bucket holding the percentile, so it is within 1/16 of the exact latency
+ * 
+ * @param p_histogram the histogram
+ * @param percentile  the percentile, from 0 to 100. For example, 99.9
+ * 
+ * @return the latency in nanoseconds, or 0 if the histogram is empty
+ */
+DLLEXPORT uint64_t priority_queue_histogram_percentile ( const priority_queue_histogram *const p_histogram, double percentile );
+
+/** !
+ * Print the count, mean, and percentiles of a latency histogram
+ * 
+ * @param p_file      the file to print to
+ * @param name        the name of the histogram
+ * @param p_histogram the histogram
+ * 
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_histogram_print ( FILE *p_file, const char *const name, const priority_queue_histogram *const p_histogram );
+
+#ifndef _WIN64
+/** !
+ * Write the priority queue to a file descriptor, in heap order. Each key is written 
+ * as a length prefixed record
+ * 
+ * @param p_priority_queue the priority queue
+ * @param fd               the file descriptor to write to
+ * @param pfn_serialize    pointer to a serializer, or 0 to write each key by value
+ * 
+ * @sa priority_queue_load
+ * 
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_save ( priority_queue *const p_priority_queue, int fd, priority_queue_serialize_fn pfn_serialize );
+#endif
+
 // Mutators
 /** !
  * Add a key to the back of the priority queue
@@ -123,6 +723,263 @@ DLLEXPORT int priority_queue_enqueue ( priority_queue *const p_priority_queue, v
 */
 DLLEXPORT int priority_queue_dequeue ( priority_queue *const p_priority_queue, void **pp_key );
 
+/** !
+ * Add a key with an explicit priority to a priority queue with inline priorities
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key to insert
+ * @param priority         the priority of the key
+ * 
+ * @sa priority_queue_construct_typed
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_enqueue_priority ( priority_queue *const p_priority_queue, void *p_key, priority_queue_priority priority );
+
+/** !
+ * Remove the key in the front of a priority queue with inline priorities, and its priority
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ * @param p_priority       return, or 0
+ * 
+ * @sa priority_queue_construct_typed
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_dequeue_priority ( priority_queue *const p_priority_queue, void **pp_key, priority_queue_priority *p_priority );
+
+/** !
+ * Add an index with a priority to a compact priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * @param index            the index
+ * @param priority         the priority of the index
+ * 
+ * @sa priority_queue_construct_typed
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_enqueue_index ( priority_queue *const p_priority_queue, uint32_t index, uint32_t priority );
+
+/** !
+ * Remove the index with the lowest priority from a compact priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_index          return
+ * @param p_priority       return, or 0
+ * 
+ * @sa priority_queue_construct_typed
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_dequeue_index ( priority_queue *const p_priority_queue, uint32_t *p_index, uint32_t *p_priority );
+
+/** !
+ * Set the weight of a tenant. Keys enqueued later are charged cost / weight; keys 
+ * already enqueued keep their place
+ *
+ * @param p_fair the fair queue
+ * @param tenant the tenant
+ * @param weight the weight, 1 by default
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_fair_weight_set ( priority_queue_fair *const p_fair, size_t tenant, uint32_t weight );
+
+/** !
+ * Add a key to a tenant of a fair queue. The cost is the share of the dequeues the
+ * key uses, in any unit, such as bytes or expected run time
+ *
+ * @param p_fair the fair queue
+ * @param tenant the tenant
+ * @param p_key  the key
+ * @param cost   the cost of the key
+ *
+ * @return 1 on success, 0 if the tenant is full or on error
+ */
+DLLEXPORT int priority_queue_fair_enqueue ( priority_queue_fair *const p_fair, size_t tenant, void *p_key, uint32_t cost );
+
+/** !
+ * Remove the highest priority key of the tenant next in fair order
+ *
+ * @param p_fair   the fair queue
+ * @param pp_key   return
+ * @param p_tenant return, the tenant of the key, or null
+ *
+ * @return 1 on success, 0 if the fair queue is empty or on error
+ */
+DLLEXPORT int priority_queue_fair_dequeue ( priority_queue_fair *const p_fair, void **pp_key, size_t *p_tenant );
+
+#ifndef _WIN64
+/** !
+ * Add a key to a delay queue. A key whose ready time has passed is ready at once
+ *
+ * @param p_delay the delay queue
+ * @param p_key   the key
+ * @param ready   the ready time, from timer_high_precision
+ *
+ * @return 1 on success, 0 if the delay queue is full or on error
+ */
+DLLEXPORT int priority_queue_delay_enqueue ( priority_queue_delay *const p_delay, void *p_key, timestamp ready );
+
+/** !
+ * Remove the highest priority key that is ready, without waiting
+ *
+ * @param p_delay the delay queue
+ * @param pp_key  return
+ *
+ * @return 1 on success, 0 if no key is ready or on error
+ */
+DLLEXPORT int priority_queue_delay_dequeue ( priority_queue_delay *const p_delay, void **pp_key );
+
+/** !
+ * Remove the highest priority key that is ready, sleeping until the next ready time
+ * while no key is ready. An enqueue wakes the sleeping thread
+ *
+ * @param p_delay  the delay queue
+ * @param pp_key   return
+ * @param deadline the time to give up, from timer_high_precision, or 0 to wait forever
+ *
+ * @return 1 on success, 0 at the deadline or on error
+ */
+DLLEXPORT int priority_queue_delay_dequeue_wait ( priority_queue_delay *const p_delay, void **pp_key, timestamp deadline );
+#endif
+
+/** !
+ * Remove every key from the priority queue, in order of priority. The keys are 
+ * sorted in place under one lock, and the sorted array is handed to the caller
+ * 
+ * @param p_priority_queue the priority queue
+ * @param ppp_keys         return, the highest priority key first. Free with PRIORITY_QUEUE_REALLOC(keys, 0)
+ * @param p_count          return, the quantity of keys
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_drain_sorted ( priority_queue *const p_priority_queue, void ***ppp_keys, size_t *p_count );
+
+/** !
+ * Zero the operation statistics of the priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @sa priority_queue_stats
+ * 
+ * @return 1 on success, 0 on error or if statistics are not compiled in
+*/
+DLLEXPORT int priority_queue_stats_reset ( priority_queue *const p_priority_queue );
+
+/** !
+ * Add the latencies of one histogram to another. Use this to combine the histograms
+ * of several priority queues, or several snapshots
+ * 
+ * @param p_histogram the histogram to add to
+ * @param p_other     the histogram to add
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_histogram_merge ( priority_queue_histogram *const p_histogram, const priority_queue_histogram *const p_other );
+
+/** !
+ * Set the callbacks fired by the tracepoints of every priority queue. The callback 
+ * table is not copied, and must outlive its use. The callbacks run on the thread of 
+ * the operation, and the lock callbacks run with the lock held
+ * 
+ * @param p_trace the callback table, or 0 to remove the callbacks
+ * 
+ * @return 1 on success, 0 if tracepoints are not compiled in
+*/
+DLLEXPORT int priority_queue_trace_set ( const priority_queue_trace *const p_trace );
+
+/** !
+ * Age the keys of a priority queue, so low priority keys can not starve. Each 
+ * enqueue adds the rate to a bias, and a key is ordered by its priority plus the 
+ * bias when it was enqueued. So a key gains the rate on every key enqueued after 
+ * it, with no work per key. dequeue_priority returns the priority lowered by the 
+ * rate for each later enqueue, but not below 0
+ * 
+ * @param p_priority_queue the priority queue, with PRIORITY_QUEUE_PRIORITY_U64 priorities
+ * @param rate             the priority gained per enqueue, or 0 to stop aging
+ * 
+ * @sa priority_queue_construct_typed
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_aging_set ( priority_queue *const p_priority_queue, uint64_t rate );
+
+/** !
+ * Mark a key as dead in constant time. The key stays in the heap until it reaches 
+ * the front, where dequeue and peek skip it, or until more than the compaction 
+ * threshold of the keys are dead, when the heap is compacted and rebuilt. The key 
+ * must be in the priority queue. If it is in the priority queue more than once, 
+ * one copy is dead. The key of a compact priority queue is its index, cast to a 
+ * pointer
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * 
+ * @sa priority_queue_compact_threshold_set
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_invalidate ( priority_queue *const p_priority_queue, void *p_key );
+
+/** !
+ * Set the fraction of dead keys that starts a compaction
+ * 
+ * @param p_priority_queue the priority queue
+ * @param threshold        between 0 and 1, or 0 for the default of one half
+ * 
+ * @sa priority_queue_invalidate
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_compact_threshold_set ( priority_queue *const p_priority_queue, double threshold );
+
+/** !
+ * Give every key a new priority, in one sweep under the lock, and rebuild the heap
+ * from the bottom up. The callback may change the key, or what the compare function
+ * reads from it, or the inline priority of the key. Dead keys are removed first
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pfn_reprioritize the callback
+ * @param p_context        passed to the callback
+ * 
+ * @sa priority_queue_reprioritize_parallel
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_reprioritize ( priority_queue *const p_priority_queue, priority_queue_reprioritize_fn *pfn_reprioritize, void *p_context );
+
+/** !
+ * Give every key a new priority, with the sweep split across worker threads, and 
+ * rebuild the heap from the bottom up. Binary heaps of keys are also rebuilt in 
+ * parallel. The callback must be safe to call from several threads at once. 
+ * Small priority queues are swept on the calling thread
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pfn_reprioritize the callback
+ * @param p_context        passed to the callback
+ * @param threads          the quantity of threads, or 0 for one per processor
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_reprioritize_parallel ( priority_queue *const p_priority_queue, priority_queue_reprioritize_fn *pfn_reprioritize, void *p_context, size_t threads );
+
+#ifndef _WIN64
+/** !
+ * Durably commit the contents of a memory mapped priority queue to its backing file. 
+ * After a crash, the priority queue reopens in the state of the last checkpoint
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @sa priority_queue_construct_mapped
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_checkpoint ( priority_queue *const p_priority_queue );
+#endif
+
 // Destructors
 /** !
  *  Destroy and deallocate a priority queue
@@ -134,3 +991,43 @@ DLLEXPORT int priority_queue_dequeue ( priority_queue *const p_priority_queue, v
  * @return 1 on success, 0 on error
  */
 DLLEXPORT int priority_queue_destroy ( priority_queue **const pp_priority_queue );
+
+/** !
+ * Release a snapshot. A snapshot may be released on any thread, before, after, or 
+ * while its priority queue is destroyed
+ * 
+ * @param pp_snapshot pointer to snapshot pointer
+ * 
+ * @sa priority_queue_snapshot_acquire
+ * 
+ * @return 1 on success, 0 on error
+*/
+DLLEXPORT int priority_queue_snapshot_release ( priority_queue_snapshot **const pp_snapshot );
+
+/** !
+ * Destroy and deallocate a fair queue, and the priority queue of each tenant
+ *
+ * @param pp_fair pointer to fair queue pointer
+ *
+ * @sa priority_queue_fair_construct
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_fair_destroy ( priority_queue_fair **const pp_fair );
+
+#ifndef _WIN64
+/** !
+ * Destroy and deallocate a delay queue. No thread may be waiting
+ *
+ * @param pp_delay pointer to delay queue pointer
+ *
+ * @sa priority_queue_delay_construct
+ *
+ * @return 1 on success, 0 on error
+ */
+DLLEXPORT int priority_queue_delay_destroy ( priority_queue_delay **const pp_delay );
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,357 @@
+/** !
+ * C++20 coroutine header for priority queue library
+ *
+ * pq::async_queue owns a priority queue, and lets coroutines co_await pop(). A pop
+ * of an empty priority queue suspends the coroutine, without blocking the thread.
+ * The next push dequeues a key for the longest waiting coroutine, and resumes it on
+ * the pushing thread, or on the executor given to the constructor. No thread is
+ * made for a waiter. A pop with a std::stop_token is cancelled when a stop is
+ * requested, and resumes with no key
+ *
+ * Keys must be pushed through the async_queue to wake waiters. Keys enqueued with
+ * priority_queue_enqueue on native() are popped, but do not wake a waiter
+ *
+ * @file priority_queue/priority_queue.hpp
+ * @author Jacob Smith
+ * @date Feb 14, 2024
+ */
+
+// Include guard
+#pragma once
+
+// Standard library
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+// priority queue module
+#include <priority_queue/priority_queue.h>
+
+namespace pq
+{
+
+    /** !
+     *  @brief A priority queue of keys that coroutines can co_await
+     */
+    class async_queue
+    {
+        public:
+
+            // Type definitions
+            using executor = std::function<void(std::coroutine_handle<>)>;
+
+            class pop_awaiter;
+
+            // Constructors
+            /** !
+             * Construct an async priority queue
+             *
+             * @param size                 the maximum quantity of keys
+             * @param pfn_compare_function the compare function, or nullptr for the default
+             * @param resume               resumes waiters, or empty to resume them on the pushing thread
+             */
+            explicit async_queue ( std::size_t size, priority_queue_equal_fn pfn_compare_function = nullptr, executor resume = {} )
+                : m_resume(std::move(resume))
+            {
+
+                // Construct the priority queue
+                if ( priority_queue_construct(&m_p_priority_queue, size, pfn_compare_function) == 0 ) throw std::bad_alloc();
+            }
+
+            async_queue ( const async_queue & ) = delete;
+            async_queue &operator= ( const async_queue & ) = delete;
+
+            // Destructors
+            /** !
+             * Destroy the priority queue. No coroutine may be waiting
+             */
+            ~async_queue ( )
+            {
+
+                // Destroy the priority queue
+                priority_queue_destroy(&m_p_priority_queue);
+            }
+
+            // Mutators
+            /** !
+             * Add a key to the priority queue, and resume the longest waiting coroutine
+             * with the highest priority key
+             *
+             * @param p_key the key
+             *
+             * @return true on success, false if the priority queue is full
+             */
+            bool push ( void *p_key )
+            {
+
+                // Initialized data
+                pop_awaiter *p_waiter = nullptr;
+
+                // Add the key
+                if ( priority_queue_enqueue(m_p_priority_queue, p_key) == 0 ) return false;
+
+                // Hand the front key to the first waiter
+                {
+                    std::lock_guard<std::mutex> guard(m_waiters_lock);
+
+                    // Fast exit
+                    if ( m_p_head == nullptr ) return true;
+
+                    // Take the front key. A concurrent try_pop may have taken it first
+                    if ( take(&m_p_head->m_p_key) == false ) return true;
+
+                    // Remove the waiter
+                    p_waiter = m_p_head;
+                    unlink(p_waiter);
+                    p_waiter->m_result = p_waiter->m_p_key;
+                }
+
+                // Resume the waiter, outside of the lock
+                resume(p_waiter->m_handle);
+
+                // Success
+                return true;
+            }
+
+            /** !
+             * Remove the front key, without waiting
+             *
+             * @return the key, or no key if the priority queue is empty
+             */
+            std::optional<void *> try_pop ( void )
+            {
+
+                // Initialized data
+                void *p_key = nullptr;
+
+                // Remove the front key
+                if ( take(&p_key) == false ) return std::nullopt;
+
+                // Success
+                return p_key;
+            }
+
+            /** !
+             * Remove the front key, suspending the coroutine while the priority queue is empty
+             *
+             * @return an awaitable, which resumes with the key
+             */
+            pop_awaiter pop ( void ) { return pop_awaiter(*this, std::stop_token()); }
+
+            /** !
+             * Remove the front key, suspending the coroutine while the priority queue is
+             * empty, until a stop is requested
+             *
+             * @param token the stop token
+             *
+             * @return an awaitable, which resumes with the key, or no key if a stop was requested
+             */
+            pop_awaiter pop ( std::stop_token token ) { return pop_awaiter(*this, std::move(token)); }
+
+            // Accessors
+            /** !
+             * Check if the priority queue is empty
+             *
+             * @return true if empty, else false
+             */
+            bool empty ( void ) { return priority_queue_empty(m_p_priority_queue); }
+
+            /** !
+             * Get the priority queue
+             *
+             * @return the priority queue
+             */
+            priority_queue *native ( void ) { return m_p_priority_queue; }
+
+            /** !
+             *  @brief Awaits the front key of an async priority queue
+             */
+            class pop_awaiter
+            {
+                public:
+
+                    pop_awaiter ( async_queue &queue, std::stop_token token )
+                        : m_queue(queue), m_token(std::move(token)) { }
+
+                    pop_awaiter ( const pop_awaiter & ) = delete;
+                    pop_awaiter &operator= ( const pop_awaiter & ) = delete;
+
+                    /** !
+                     * Take the front key without suspending, if there is one
+                     *
+                     * @return true if the coroutine does not need to suspend
+                     */
+                    bool await_ready ( void )
+                    {
+
+                        // A stop was already requested
+                        if ( m_token.stop_requested() ) return true;
+
+                        // Take the front key
+                        if ( m_queue.take(&m_p_key) ) m_result = m_p_key;
+
+                        // Done
+                        return m_result.has_value();
+                    }
+
+                    /** !
+                     * Wait for a key
+                     *
+                     * @param handle the suspended coroutine
+                     *
+                     * @return true if the coroutine stays suspended
+                     */
+                    bool await_suspend ( std::coroutine_handle<> handle )
+                    {
+
+                        // Store the coroutine
+                        m_handle = handle;
+
+                        // Watch for a stop request. When the stop is already requested, the
+                        // callback runs here, before the waiter is added
+                        if ( m_token.stop_possible() ) m_stop.emplace(m_token, stop_callback { this });
+
+                        // Add the waiter
+                        {
+                            std::lock_guard<std::mutex> guard(m_queue.m_waiters_lock);
+
+                            // Do not suspend when a stop was requested ...
+                            if ( m_cancelled ) return false;
+
+                            // ... or when a key arrived after await_ready
+                            if ( m_queue.take(&m_p_key) ) return m_result = m_p_key, false;
+
+                            // Wait at the back
+                            m_queue.link(this);
+                        }
+
+                        // Suspend
+                        return true;
+                    }
+
+                    /** !
+                     * Get the key
+                     *
+                     * @return the key, or no key if a stop was requested
+                     */
+                    std::optional<void *> await_resume ( void ) { return m_result; }
+
+                private:
+
+                    friend class async_queue;
+
+                    /** !
+                     *  @brief Removes a waiter when a stop is requested
+                     */
+                    struct stop_callback
+                    {
+                        pop_awaiter *p_waiter;
+
+                        void operator() ( void )
+                        {
+
+                            // Initialized data
+                            bool waiting = false;
+
+                            // Remove the waiter, if no key was handed to it
+                            {
+                                std::lock_guard<std::mutex> guard(p_waiter->m_queue.m_waiters_lock);
+
+                                // Cancel the wait
+                                p_waiter->m_cancelled = true;
+                                waiting               = p_waiter->m_linked;
+                                if ( waiting ) p_waiter->m_queue.unlink(p_waiter);
+                            }
+
+                            // Resume the waiter with no key
+                            if ( waiting ) p_waiter->m_queue.resume(p_waiter->m_handle);
+                        }
+                    };
+
+                    async_queue                                       &m_queue;
+                    std::stop_token                                    m_token;
+                    std::optional<std::stop_callback<stop_callback>>   m_stop;
+                    std::coroutine_handle<>                            m_handle;
+                    std::optional<void *>                              m_result;
+                    void                                              *m_p_key    = nullptr;
+                    pop_awaiter                                       *m_p_prev   = nullptr,
+                                                                      *m_p_next   = nullptr;
+                    bool                                               m_linked    = false,
+                                                                       m_cancelled = false;
+            };
+
+        private:
+
+            /** !
+             * Add a waiter to the back of the list. The caller holds m_waiters_lock
+             *
+             * @param p_waiter the waiter
+             */
+            void link ( pop_awaiter *p_waiter )
+            {
+
+                // Add the waiter
+                p_waiter->m_p_prev = m_p_tail;
+                p_waiter->m_p_next = nullptr;
+                if ( m_p_tail ) m_p_tail->m_p_next = p_waiter;
+                else            m_p_head           = p_waiter;
+                m_p_tail           = p_waiter;
+                p_waiter->m_linked = true;
+            }
+
+            /** !
+             * Remove a waiter from the list. The caller holds m_waiters_lock
+             *
+             * @param p_waiter the waiter
+             */
+            void unlink ( pop_awaiter *p_waiter )
+            {
+
+                // Remove the waiter
+                if ( p_waiter->m_p_prev ) p_waiter->m_p_prev->m_p_next = p_waiter->m_p_next;
+                else                      m_p_head                     = p_waiter->m_p_next;
+                if ( p_waiter->m_p_next ) p_waiter->m_p_next->m_p_prev = p_waiter->m_p_prev;
+                else                      m_p_tail                     = p_waiter->m_p_prev;
+                p_waiter->m_linked = false;
+            }
+
+            /** !
+             * Remove the front key, if there is one. Checking first keeps an empty 
+             * priority queue from reporting an underflow
+             *
+             * @param pp_key return
+             *
+             * @return true if a key was removed, else false
+             */
+            bool take ( void **pp_key )
+            {
+
+                // Remove the front key
+                return priority_queue_empty(m_p_priority_queue) == false && priority_queue_dequeue(m_p_priority_queue, pp_key);
+            }
+
+            /** !
+             * Resume a waiter, on the executor if there is one
+             *
+             * @param handle the waiting coroutine
+             */
+            void resume ( std::coroutine_handle<> handle )
+            {
+
+                // Resume the coroutine
+                if ( m_resume ) m_resume(handle);
+                else            handle.resume();
+            }
+
+            priority_queue *m_p_priority_queue = nullptr;
+            executor        m_resume;
+            std::mutex      m_waiters_lock;
+            pop_awaiter    *m_p_head = nullptr,
+                           *m_p_tail = nullptr;
+    };
+}
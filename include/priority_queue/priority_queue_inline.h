@@ -0,0 +1,231 @@
+/** !
+ * Inline fast path header for priority queue library
+ *
+ * Include this header instead of priority_queue/priority_queue.h to inline enqueue,
+ * dequeue, and peek into the caller. The _unchecked functions do not check their
+ * arguments, and do not print errors. They handle binary heaps of keys ordered by a
+ * compare function. Other priority queues, and libraries built with statistics,
+ * histograms, or tracepoints, fall back to the checked functions
+ *
+ * @file priority_queue/priority_queue_inline.h
+ * @author Jacob Smith
+ * @date Feb 14, 2024
+ */
+
+// Include guard
+#pragma once
+
+// priority queue module
+#include <priority_queue/priority_queue.h>
+
+// Structure definitions
+/** !
+ *  @brief The first members of every priority queue. The library keeps
+ *         struct priority_queue_s in step with this struct
+ */
+struct priority_queue_inline_s
+{
+    struct
+    {
+        void   **data;
+        void    *p_allocation;
+        size_t   max,
+                 count;
+    } entries;
+
+    mutex                    _lock;
+    priority_queue_equal_fn *pfn_compare_function;
+    bool                     inline_path; // The _unchecked functions may operate on this priority queue
+    void                    *p_snapshot;  // A snapshot shares the entries, so the checked functions copy them first
+};
+
+// Mutators
+/** !
+ * Add a key to the back of the priority queue, without checking the arguments
+ *
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key to insert
+ *
+ * @return 1 on success, 0 if the priority queue is full
+*/
+static inline int priority_queue_enqueue_unchecked ( priority_queue *const p_priority_queue, void *p_key )
+{
+
+    // Initialized data
+    struct priority_queue_inline_s *p_inline = (struct priority_queue_inline_s *) p_priority_queue;
+    void                          **data     = (void *) 0;
+    size_t                          i        = 0;
+
+    // Lock
+    mutex_lock(p_inline->_lock);
+
+    // State check. Other priority queues take the checked path. The entries may be
+    // replaced, and the fast path disabled, by other functions while they hold the lock
+    if ( p_inline->inline_path == false                   ) goto checked;
+    if ( p_inline->p_snapshot                             ) goto checked;
+    if ( p_inline->entries.count >= p_inline->entries.max ) goto heap_overflow;
+
+    // Initialized data
+    data = p_inline->entries.data;
+
+    // Move the hole up from the back of the heap until the key fits
+    for (i = p_inline->entries.count++; i > 0 && p_inline->pfn_compare_function(data[( i - 1 ) / 2], p_key) < 0; i = ( i - 1 ) / 2)
+        data[i] = data[( i - 1 ) / 2];
+
+    // Fill the hole
+    data[i] = p_key;
+
+    // Unlock
+    mutex_unlock(p_inline->_lock);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+        checked:
+
+            // Unlock
+            mutex_unlock(p_inline->_lock);
+
+            // Take the checked path
+            return priority_queue_enqueue(p_priority_queue, p_key);
+
+        heap_overflow:
+
+            // Unlock
+            mutex_unlock(p_inline->_lock);
+
+            // Error
+            return 0;
+    }
+}
+
+/** !
+ * Remove the key in the front of the priority queue, without checking the arguments
+ *
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ *
+ * @return 1 on success, 0 if the priority queue is empty
+*/
+static inline int priority_queue_dequeue_unchecked ( priority_queue *const p_priority_queue, void **pp_key )
+{
+
+    // Initialized data
+    struct priority_queue_inline_s *p_inline = (struct priority_queue_inline_s *) p_priority_queue;
+    void                          **data     = (void *) 0;
+    void                           *p_last   = (void *) 0;
+    size_t                          count    = 0,
+                                    i        = 0;
+
+    // Lock
+    mutex_lock(p_inline->_lock);
+
+    // State check. Other priority queues take the checked path
+    if ( p_inline->inline_path == false ) goto checked;
+    if ( p_inline->p_snapshot           ) goto checked;
+    if ( p_inline->entries.count == 0   ) goto underflow;
+
+    // Initialized data
+    data = p_inline->entries.data;
+
+    // Take the front, and the last key
+    *pp_key     = data[0];
+    count       = --p_inline->entries.count;
+    p_last      = data[count];
+    data[count] = (void *) 0;
+
+    // Move the hole down from the front of the heap until the last key fits
+    for (;;)
+    {
+
+        // Initialized data
+        size_t child = 2 * i + 1;
+
+        // Stop at a leaf
+        if ( child >= count ) break;
+
+        // Pick the child with the higher priority
+        if ( child + 1 < count && p_inline->pfn_compare_function(data[child + 1], data[child]) > 0 ) child++;
+
+        // Stop when the heap property holds
+        if ( p_inline->pfn_compare_function(data[child], p_last) <= 0 ) break;
+
+        // Move the child into the hole
+        data[i] = data[child];
+        i       = child;
+    }
+
+    // Fill the hole
+    if ( count ) data[i] = p_last;
+
+    // Unlock
+    mutex_unlock(p_inline->_lock);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+        checked:
+
+            // Unlock
+            mutex_unlock(p_inline->_lock);
+
+            // Take the checked path
+            return priority_queue_dequeue(p_priority_queue, pp_key);
+
+        underflow:
+
+            // Unlock
+            mutex_unlock(p_inline->_lock);
+
+            // Error
+            return 0;
+    }
+}
+
+// Accessors
+/** !
+ * Get the key in the front of the priority queue, without removing it, and without
+ * checking the arguments
+ *
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ *
+ * @return 1 on success, 0 if the priority queue is empty
+*/
+static inline int priority_queue_peek_unchecked ( priority_queue *const p_priority_queue, void **pp_key )
+{
+
+    // Initialized data
+    struct priority_queue_inline_s *p_inline = (struct priority_queue_inline_s *) p_priority_queue;
+    int                             ret      = 0;
+
+    // Lock
+    mutex_lock(p_inline->_lock);
+
+    // Other priority queues take the checked path
+    if ( p_inline->inline_path == false ) goto checked;
+
+    // Get the front of the heap
+    if ( p_inline->entries.count ) *pp_key = p_inline->entries.data[0], ret = 1;
+
+    // Unlock
+    mutex_unlock(p_inline->_lock);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+        checked:
+
+            // Unlock
+            mutex_unlock(p_inline->_lock);
+
+            // Take the checked path
+            return priority_queue_peek(p_priority_queue, pp_key);
+    }
+}
@@ -7,131 +7,8282 @@
  */
 
 // Headers
+#include <stddef.h>
+#include <stdint.h>
 #include <priority_queue/priority_queue.h>
+#include <priority_queue/priority_queue_inline.h>
+
+// Platform dependent headers
+#if ( defined(__x86_64__) || defined(__i386__) ) && ( defined(__GNUC__) || defined(__clang__) )
+    #define PRIORITY_QUEUE_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+#include <stdatomic.h>
+
+#if defined(PRIORITY_QUEUE_TRACE) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #define PRIORITY_QUEUE_USDT
+        #include <sys/sdt.h>
+    #endif
+#endif
+
+#if !defined(_WIN64) && defined(__has_include)
+    #if __has_include(<sys/eventfd.h>)
+        #define PRIORITY_QUEUE_EVENTFD
+        #include <sys/eventfd.h>
+    #endif
+#endif
+
+#ifndef _WIN64
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <time.h>
+#endif
 
 // Preprocessor macros
 #define PRIORITY_QUEUE_PARENT(i) (i - 1) / 2
 #define PRIORITY_QUEUE_LEFT(i)   (2 * i) + 1
 #define PRIORITY_QUEUE_RIGHT(i)  (2 * i) + 2 
 
+// Page blocked layout
+// 
+// Each block of PRIORITY_QUEUE_BLOCK_SLOTS slots fills one page, and holds a complete 
+// subtree of PRIORITY_QUEUE_BLOCK_KEYS keys in binary heap order. The last slot of each
+// block is unused. The children of the leaves of block b are the roots of blocks 
+// b * PRIORITY_QUEUE_BLOCK_SLOTS + 1 ... b * PRIORITY_QUEUE_BLOCK_SLOTS + PRIORITY_QUEUE_BLOCK_SLOTS, 
+// so a sift touches a new page once every log2(PRIORITY_QUEUE_BLOCK_SLOTS) levels, 
+// instead of once per level. Indices into entries.data are physical slots. The 
+// logical index of a key, which is compared with entries.count, skips unused slots
+#define PRIORITY_QUEUE_PAGE_SIZE      4096
+#define PRIORITY_QUEUE_BLOCK_SLOTS    ( PRIORITY_QUEUE_PAGE_SIZE / sizeof(void *) )
+#define PRIORITY_QUEUE_BLOCK_KEYS     ( PRIORITY_QUEUE_BLOCK_SLOTS - 1 )
+#define PRIORITY_QUEUE_BLOCK_INTERNAL ( PRIORITY_QUEUE_BLOCK_SLOTS / 2 - 1 )
+
+// Sequence layout
+// 
+// Inserts go to an insertion heap of PRIORITY_QUEUE_SEQUENCE_INSERTION keys, which 
+// stays in the cache. When it fills, it is sorted into a sequence, and the sequence 
+// joins group 0. Each group merges up to PRIORITY_QUEUE_SEQUENCE_ARITY sequences with
+// a loser tree. When a group is full, its sequences are merged into one sequence, 
+// which joins the next group. The front of the queue is the best of the root of the 
+// insertion heap and the winner of each group, and every sequence is read in order
+#define PRIORITY_QUEUE_SEQUENCE_INSERTION 1024
+#define PRIORITY_QUEUE_SEQUENCE_ARITY     64
+
+// Parallel heap construction
+// 
+// Below PRIORITY_QUEUE_PARALLEL_BUILD_MIN keys, a heap is built on the calling thread.
+// Otherwise, the heap is split at the first level with PRIORITY_QUEUE_PARALLEL_BUILD_SPLIT
+// subtrees per thread. Each thread builds whole subtrees, bottom up, and the calling 
+// thread then finishes the levels above the split
+#define PRIORITY_QUEUE_PARALLEL_BUILD_MIN   65536
+#define PRIORITY_QUEUE_PARALLEL_BUILD_SPLIT 4
+
+// Parallel sorted copy
+// 
+// A snapshot of the keys is split into one partition per thread, with at least 
+// PRIORITY_QUEUE_PARALLEL_SORT_MIN keys each. Each partition is merge sorted, from 
+// insertion sorted runs of PRIORITY_QUEUE_SORT_RUN keys, and the sorted partitions 
+// are merged with a loser tree
+#define PRIORITY_QUEUE_PARALLEL_SORT_MIN 16384
+#define PRIORITY_QUEUE_SORT_RUN          16
+
+// Tombstones
+// 
+// Invalidated keys stay in the heap, and are counted in a hash table of dead keys.
+// Dequeues skip dead keys at the root. When more than the threshold of the keys are 
+// dead, the heap is compacted and rebuilt
+#define PRIORITY_QUEUE_TOMBSTONE_THRESHOLD 0.5
+#define PRIORITY_QUEUE_TOMBSTONE_HASH(p)   ( (size_t) ( ( (uint64_t) (uintptr_t) (p) * UINT64_C(0x9E3779B97F4A7C15) ) >> 32 ) )
+
+// Fair queuing
+// 
+// Each tenant owns a binary heap of its keys, each stored with its cost / weight. A
+// tenant that joins the backlog at virtual time V starts at the later of V and the
+// finish of its last dequeued key, and finishes the cost of the key at its front 
+// after that. Backlogged tenants wait in a typed heap, by finish time. A dequeue 
+// takes the highest priority key of the first tenant, charges the tenant the cost of
+// that key, and advances the virtual time to its finish, so the clock is self timed.
+// Finish times are fixed point, with PRIORITY_QUEUE_FAIR_SCALE parts for each unit 
+// of cost
+#define PRIORITY_QUEUE_FAIR_SCALE 65536
+#define PRIORITY_QUEUE_FAIR_ARITY 4
+
+// Delay queues
+// 
+// Keys that are not ready wait in a typed heap, by ready time. Keys that are ready 
+// wait in a priority queue, by the compare function. Each dequeue reads the timer 
+// once, and moves every key that became ready since the last dequeue, in one batch.
+// A blocking dequeue sleeps on a condition variable until the next ready time, or 
+// until an enqueue changes it
+#define PRIORITY_QUEUE_DELAY_ARITY 4
+
+// Compact heaps
+// 
+// Each entry of a compact heap packs a 32 bit priority above a 32 bit index into a 
+// table owned by the caller. Entries compare as 64 bit priorities, so equal priorities
+// come out in order of index, and 8 children fill one cache line
+#define PRIORITY_QUEUE_COMPACT_ENTRY(priority, index) ( (uint64_t) (uint32_t) (priority) << 32 | (uint32_t) (index) )
+#define PRIORITY_QUEUE_COMPACT_INDEX(entry)           ( (uint32_t) (entry) )
+
+// Padded typed heaps
+// 
+// With PRIORITY_QUEUE_PADDING, the priorities of a typed heap are followed by a full 
+// group of spare slots, and every slot past the last key holds the lowest priority, 
+// all bits set. The last internal node always has a full group of children, so sift 
+// down runs the kernel on every group without checking for a partial group. A padded 
+// slot never moves, because it never has a strictly higher priority than a key
+#ifdef PRIORITY_QUEUE_PADDING
+    #define PRIORITY_QUEUE_PADDING_SLOTS(arity)                                      (arity)
+    #define PRIORITY_QUEUE_BEST_CHILD(pfn_kernel, pfn_scalar, p, first, arity, count) (pfn_kernel)(p, first, arity)
+#else
+    #define PRIORITY_QUEUE_PADDING_SLOTS(arity)                                      0
+    #define PRIORITY_QUEUE_BEST_CHILD(pfn_kernel, pfn_scalar, p, first, arity, count) ( ( (first) + (arity) <= (count) ) ? (pfn_kernel)(p, first, arity) : (pfn_scalar)(p, first, (count) - (first)) )
+#endif
+
+// Prefetch
+#if defined(__GNUC__) || defined(__clang__)
+    #define PRIORITY_QUEUE_PREFETCH(p) __builtin_prefetch(p)
+#else
+    #define PRIORITY_QUEUE_PREFETCH(p)
+#endif
+
+// Memory mapped file format
+// 
+// [ header 0 ][ header 1 ][ region 0 ][ region 1 ]
+// 
+// Each header occupies its own page. Each region holds "max" keys. The valid header 
+// with the largest sequence number names the region holding the committed heap. A
+// checkpoint copies the heap into the other region, flushes it, and then writes and 
+// flushes a header with the next sequence number into the other header slot. A crash 
+// at any point leaves at least one valid header naming a complete region
+#define PRIORITY_QUEUE_MAPPED_MAGIC   0x3130504d41515150ULL /* "PQQAMP01" */
+#define PRIORITY_QUEUE_MAPPED_VERSION 1
+
+// Saved priority queue format
+// 
+// [ header ][ length 0 ][ key 0 ] ... [ length n-1 ][ key n-1 ]
+// 
+// Keys are written in heap order, so loading does not rebuild the heap. Each length
+// is a 32 bit byte count. Fields are written in native byte order, and the magic 
+// number rejects files written with a different byte order
+#define PRIORITY_QUEUE_SAVE_MAGIC          0x31304e5341515150ULL /* "PQQASN01" */
+#define PRIORITY_QUEUE_SAVE_VERSION        1
+#define PRIORITY_QUEUE_STREAM_BUFFER_SIZE  65536
+
+// Statistics
+// 
+// When PRIORITY_QUEUE_STATS is defined, each priority queue counts its operations in
+// PRIORITY_QUEUE_STATS_STRIPES padded stripes. Each thread adds to its own
+// stripe with relaxed atomics, so counting does not contend, and priority_queue_stats
+// merges the stripes. Otherwise, every counter compiles to nothing
+#define PRIORITY_QUEUE_STATS_STRIPES 16
+
+#ifdef PRIORITY_QUEUE_STATS
+    #define PRIORITY_QUEUE_STAT_ADD(p, field, n)  atomic_fetch_add_explicit(&priority_queue_stats_stripe(p)->field, (uint64_t) (n), memory_order_relaxed)
+    #define PRIORITY_QUEUE_STAT_MAX(p, field, n)  priority_queue_stats_max(&priority_queue_stats_stripe(p)->field, (uint64_t) (n))
+    #define PRIORITY_QUEUE_STAT_SIFT(p, levels)   priority_queue_stats_sift((p), (levels))
+#else
+    #define PRIORITY_QUEUE_STAT_ADD(p, field, n)  ( (void) 0 )
+    #define PRIORITY_QUEUE_STAT_MAX(p, field, n)  ( (void) 0 )
+    #define PRIORITY_QUEUE_STAT_SIFT(p, levels)   ( (void) (levels) )
+#endif
+
+// Latency histograms
+// 
+// When PRIORITY_QUEUE_HISTOGRAMS is defined, each priority queue times its public 
+// operations, and the wait for and hold of its lock, with timer_high_precision. Each 
+// latency in nanoseconds is counted in a log bucketed histogram. Values below 
+// PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKETS have a bucket each. Above that, each power of 
+// two is split into PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKETS linear buckets, so a bucket 
+// is never wider than 1/16 of its value. Otherwise, timing compiles to nothing
+#define PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS 4
+
+#ifdef PRIORITY_QUEUE_HISTOGRAMS
+    #define PRIORITY_QUEUE_HISTOGRAM_START(t0)            timestamp t0 = timer_high_precision()
+    #define PRIORITY_QUEUE_HISTOGRAM_RECORD(p, op, t0)    priority_queue_histogram_record((p), (op), timer_high_precision() - (t0))
+#else
+    #define PRIORITY_QUEUE_HISTOGRAM_START(t0)            ( (void) 0 )
+    #define PRIORITY_QUEUE_HISTOGRAM_RECORD(p, op, t0)    ( (void) 0 )
+#endif
+
+// Tracing
+// 
+// When PRIORITY_QUEUE_TRACE is defined, enqueues, dequeues, heapify, and the lock 
+// fire tracepoints. Each tracepoint is a USDT probe in the "priority_queue" provider,
+// where <sys/sdt.h> is available, and a call to the callback table set with 
+// priority_queue_trace_set, if there is one. A USDT probe is a nop until a tracer 
+// attaches to it. Otherwise, every tracepoint compiles to nothing
+#ifdef PRIORITY_QUEUE_USDT
+    #define PRIORITY_QUEUE_USDT_PROBE1(name, a)       DTRACE_PROBE1(priority_queue, name, a)
+    #define PRIORITY_QUEUE_USDT_PROBE2(name, a, b)    DTRACE_PROBE2(priority_queue, name, a, b)
+    #define PRIORITY_QUEUE_USDT_PROBE3(name, a, b, c) DTRACE_PROBE3(priority_queue, name, a, b, c)
+#else
+    #define PRIORITY_QUEUE_USDT_PROBE1(name, a)       ( (void) 0 )
+    #define PRIORITY_QUEUE_USDT_PROBE2(name, a, b)    ( (void) 0 )
+    #define PRIORITY_QUEUE_USDT_PROBE3(name, a, b, c) ( (void) 0 )
+#endif
+
+#ifdef PRIORITY_QUEUE_TRACE
+    #define PRIORITY_QUEUE_TRACE_CALL(pfn, ...)                                                                             \
+        do                                                                                                                  \
+        {                                                                                                                   \
+            const priority_queue_trace *_p_trace = atomic_load_explicit(&priority_queue_trace_callbacks, memory_order_acquire); \
+            if ( _p_trace && _p_trace->pfn ) _p_trace->pfn(__VA_ARGS__, _p_trace->p_context);                               \
+        } while (0)
+    #define PRIORITY_QUEUE_TRACE_ENQUEUE(p, p_key)          do { PRIORITY_QUEUE_USDT_PROBE2(enqueue, p, p_key);          PRIORITY_QUEUE_TRACE_CALL(pfn_enqueue, p, p_key);          } while (0)
+    #define PRIORITY_QUEUE_TRACE_DEQUEUE(p, p_key)          do { PRIORITY_QUEUE_USDT_PROBE2(dequeue, p, p_key);          PRIORITY_QUEUE_TRACE_CALL(pfn_dequeue, p, p_key);          } while (0)
+    #define PRIORITY_QUEUE_TRACE_HEAPIFY(p, index, levels)  do { PRIORITY_QUEUE_USDT_PROBE3(heapify, p, index, levels); PRIORITY_QUEUE_TRACE_CALL(pfn_heapify, p, index, levels); } while (0)
+    #define PRIORITY_QUEUE_TRACE_LOCK_ACQUIRE(p)            do { PRIORITY_QUEUE_USDT_PROBE1(lock_acquire, p);            PRIORITY_QUEUE_TRACE_CALL(pfn_lock_acquire, p);            } while (0)
+    #define PRIORITY_QUEUE_TRACE_LOCK_RELEASE(p)            do { PRIORITY_QUEUE_USDT_PROBE1(lock_release, p);            PRIORITY_QUEUE_TRACE_CALL(pfn_lock_release, p);            } while (0)
+#else
+    #define PRIORITY_QUEUE_TRACE_ENQUEUE(p, p_key)          ( (void) 0 )
+    #define PRIORITY_QUEUE_TRACE_DEQUEUE(p, p_key)          ( (void) 0 )
+    #define PRIORITY_QUEUE_TRACE_HEAPIFY(p, index, levels)  ( (void) 0 )
+    #define PRIORITY_QUEUE_TRACE_LOCK_ACQUIRE(p)            ( (void) 0 )
+    #define PRIORITY_QUEUE_TRACE_LOCK_RELEASE(p)            ( (void) 0 )
+#endif
+
+// Inline fast path
+// 
+// The _unchecked functions of priority_queue_inline.h operate on binary heaps of keys
+// ordered by a compare function. They can not count, time, or trace operations, so 
+// libraries built with statistics, histograms, or tracepoints send every priority 
+// queue down the checked path
+#if defined(PRIORITY_QUEUE_STATS) || defined(PRIORITY_QUEUE_HISTOGRAMS) || defined(PRIORITY_QUEUE_TRACE)
+    #define PRIORITY_QUEUE_INLINE_PATH false
+#else
+    #define PRIORITY_QUEUE_INLINE_PATH true
+#endif
+
+// Cold error reporting
+#if defined(__GNUC__) || defined(__clang__)
+    #define PRIORITY_QUEUE_COLD __attribute__((cold, noinline))
+#else
+    #define PRIORITY_QUEUE_COLD
+#endif
+
+// Type definitions
+typedef size_t (priority_queue_best_child_fn)(const void *const p_priorities, size_t first, size_t arity);
+
 // Structure definitions
+struct priority_queue_mapped_header_s
+{
+    uint64_t magic;
+    uint32_t version,
+             key_size;
+    uint64_t sequence,
+             max,
+             count,
+             region,
+             checksum;
+};
+
+struct priority_queue_save_header_s
+{
+    uint64_t magic;
+    uint32_t version,
+             key_size;
+    uint64_t count,
+             max;
+    uint32_t layout,
+             reserved;
+};
+
+struct priority_queue_stream_s
+{
+    unsigned char *p_buffer,
+                  *p_record;
+    size_t         capacity,
+                   offset,
+                   length,
+                   record_capacity;
+    int            fd;
+};
+
+struct priority_queue_run_s
+{
+    struct priority_queue_stream_s   stream;
+    void                           **p_keys,
+                                    *p_head;
+    size_t                           offset,
+                                     remaining,
+                                     level; // Spilled runs are level 0. Merging runs makes a run one level higher
+};
+
+struct priority_queue_merger_s
+{
+    struct priority_queue_run_s *p_runs;
+    size_t                      *p_tree,
+                                *p_winners,
+                                 run_count,
+                                 count;
+};
+
+struct priority_queue_build_task_s
+{
+    priority_queue *p_priority_queue;
+    size_t          depth,
+                    worker,
+                    workers;
+};
+
+struct priority_queue_snapshot_s
+{
+    void                  **p_keys;
+    void                   *p_allocation; // The entries left to the snapshot, freed with the last reference
+    size_t                  count;
+    priority_queue_layout   layout;
+    atomic_size_t           references;   // One for each caller, and one for the priority queue while it shares the keys
+};
+
+struct priority_queue_reprioritize_task_s
+{
+    priority_queue                 *p_priority_queue;
+    priority_queue_reprioritize_fn *pfn_reprioritize;
+    void                           *p_context;
+    size_t                          lo,
+                                    hi;
+};
+
+struct priority_queue_tombstone_s
+{
+    void   *p_key;
+    size_t  count;
+};
+
+struct priority_queue_fair_entry_s
+{
+    void     *p_key;
+    uint64_t  cost; // The cost over the weight of the tenant, in fixed point
+};
+
+struct priority_queue_fair_tenant_s
+{
+    struct priority_queue_fair_entry_s *p_entries; // The heap of the keys of the tenant
+    size_t                              count;
+    uint64_t                            start,     // The start time of the key at the front, while backlogged
+                                        last;      // The finish time of the last key dequeued
+    uint32_t                            weight;
+};
+
+#ifndef _WIN64
+struct priority_queue_delay_s
+{
+    pthread_mutex_t  _lock;
+    pthread_cond_t   changed;    // Signaled when a key is enqueued, while a thread waits
+    priority_queue  *p_delayed;  // Keys that are not ready, by ready time
+    priority_queue  *p_eligible; // Keys that are ready, by the compare function
+    size_t           size,
+                     count,
+                     waiters;
+};
+#endif
+
+struct priority_queue_fair_s
+{
+    mutex                                _lock;
+    priority_queue                      *p_backlog;  // Backlogged tenants, by the finish time of their next key
+    struct priority_queue_fair_tenant_s *p_tenants;
+    struct priority_queue_fair_entry_s  *p_entries;  // The heaps of every tenant
+    priority_queue_equal_fn             *pfn_compare_function;
+    size_t                               tenants,
+                                         size,
+                                         count;
+    uint64_t                             virtual_time;
+};
+
+struct priority_queue_sort_task_s
+{
+    const priority_queue  *p_priority_queue;
+    void                 **p_keys,
+                         **p_scratch;
+    size_t                 count;
+};
+
+#ifdef PRIORITY_QUEUE_STATS
+struct priority_queue_stats_stripe_s
+{
+    _Atomic uint64_t enqueues,
+                     dequeues,
+                     comparisons,
+                     swaps,
+                     sifts,
+                     sift_levels,
+                     max_sift_depth,
+                     high_water,
+                     overflows,
+                     lock_acquisitions,
+                     contended_acquisitions,
+                     lock_wait_ns;
+
+    // A cache line of padding keeps neighbouring stripes off each other's lines,
+    // without aligning the allocation of the priority queue
+    uint8_t          _pad[64];
+};
+#endif
+
+#ifdef PRIORITY_QUEUE_HISTOGRAMS
+struct priority_queue_histogram_atomic_s
+{
+    _Atomic uint64_t counts[PRIORITY_QUEUE_HISTOGRAM_BUCKETS],
+                     sum,
+                     lowest, // The complement of the smallest value, so that zero means no values
+                     highest;
+};
+#endif
+
 struct priority_queue_s
 {
+
+    // The first members match struct priority_queue_inline_s
     struct 
     {        
         void   **data;
+        void    *p_allocation;
         size_t   max,
                  count;
     } entries; 
 
-    mutex                    _lock;
-    priority_queue_equal_fn *pfn_compare_function;
+    mutex                             _lock;
+    priority_queue_equal_fn          *pfn_compare_function;
+    bool                              inline_path;
+    struct priority_queue_snapshot_s *p_snapshot; // The snapshot sharing the entries, or 0
+
+    priority_queue_layout layout;
+
+    struct
+    {
+        void                         *p_priorities,
+                                     *p_allocation;
+        size_t                        arity,
+                                      width;
+        priority_queue_priority_type  type;
+        priority_queue_priority_fn   *pfn_priority;
+        priority_queue_best_child_fn *pfn_best_child;
+    } typed;
+
+    struct
+    {
+        size_t   *p_next,     // The next slot of the same level, or the next free slot
+                 *p_head,     // The first slot of each level, or SIZE_MAX
+                 *p_tail,     // The last slot of each level
+                  free,       // The first free slot, or SIZE_MAX
+                  levels;
+        uint64_t *p_occupied, // Bit l % 64 of word l / 64 is set when level l holds keys
+                  summary;    // Bit w is set when word w of p_occupied is not zero
+    } bucket;
+
+    struct
+    {
+        struct priority_queue_tombstone_s *p_slots;
+        size_t                             capacity,  // A power of two, or 0
+                                           used,      // Slots holding a key
+                                           count;     // Dead keys in the heap
+        double                             threshold; // Fraction of dead keys that starts a compaction, or 0 for the default
+    } tombstones;
+
+    struct
+    {
+        uint64_t rate, // Added to the bias on each enqueue
+                 bias; // Added to the priority of each enqueued key
+    } aging;
+
+    struct
+    {
+        struct priority_queue_merger_s  merger;
+        size_t                          fan_in,
+                                        block_size;
+        char                           *p_directory;
+        priority_queue_serialize_fn    *pfn_serialize;
+        priority_queue_deserialize_fn  *pfn_deserialize;
+    } external;
+
+    struct
+    {
+        struct priority_queue_merger_s *p_groups;
+        size_t                          group_count,
+                                        max,
+                                        count;
+    } sequence;
+
+    struct
+    {
+        void     *p_base;
+        size_t    length,
+                  page_size,
+                  region_size;
+        uint64_t  sequence,
+                  region,
+                  slot;
+        int       fd;
+    } mapped;
+
+    struct
+    {
+        int  fd;
+        bool open,     // An eventfd was made by priority_queue_get_fd
+             readable; // The eventfd was written, and not yet read
+    } notify;
+
+    #ifdef PRIORITY_QUEUE_STATS
+        struct
+        {
+            struct priority_queue_stats_stripe_s stripes[PRIORITY_QUEUE_STATS_STRIPES];
+            atomic_bool                          held;
+        } stats;
+    #endif
+
+    #ifdef PRIORITY_QUEUE_HISTOGRAMS
+        struct
+        {
+            struct priority_queue_histogram_atomic_s operations[PRIORITY_QUEUE_OPERATION_QUANTITY];
+            timestamp                                locked_at;
+        } histograms;
+    #endif
 };
 
+// The inline fast path reads the first members of a priority queue
+_Static_assert(offsetof(struct priority_queue_s, entries)              == offsetof(struct priority_queue_inline_s, entries)             , "priority_queue_inline.h is out of date");
+_Static_assert(offsetof(struct priority_queue_s, _lock)                == offsetof(struct priority_queue_inline_s, _lock)               , "priority_queue_inline.h is out of date");
+_Static_assert(offsetof(struct priority_queue_s, pfn_compare_function) == offsetof(struct priority_queue_inline_s, pfn_compare_function), "priority_queue_inline.h is out of date");
+_Static_assert(offsetof(struct priority_queue_s, inline_path)          == offsetof(struct priority_queue_inline_s, inline_path)         , "priority_queue_inline.h is out of date");
+_Static_assert(offsetof(struct priority_queue_s, p_snapshot)           == offsetof(struct priority_queue_inline_s, p_snapshot)          , "priority_queue_inline.h is out of date");
+
+#ifdef PRIORITY_QUEUE_TRACE
+
+// Data
+static const priority_queue_trace *_Atomic priority_queue_trace_callbacks = (void *) 0;
+#endif
+
+#ifdef PRIORITY_QUEUE_STATS
+
+// Data
+static _Thread_local size_t priority_queue_stats_thread_stripe = SIZE_MAX;
+static atomic_size_t        priority_queue_stats_next_stripe   = 0;
+
 /** !
- * Compare a to b
+ * Get the statistics stripe of the calling thread
  * 
- * @param a pointer to a
- * @param b pointer to b
+ * @param p_priority_queue the priority queue
  * 
- * @return 0 if a == b else -1 if a > b else 1
+ * @return pointer to the stripe
  */
-int priority_queue_compare_function ( const void *const a, const void *const b )
+static inline struct priority_queue_stats_stripe_s *priority_queue_stats_stripe ( const priority_queue *const p_priority_queue )
 {
-    
-    // Return
-    return ( a == b ) ? 0 : ( a < b ) ? 1 : -1;
+
+    // Give each thread a stripe, the first time it counts
+    if ( priority_queue_stats_thread_stripe == SIZE_MAX )
+        priority_queue_stats_thread_stripe = atomic_fetch_add_explicit(&priority_queue_stats_next_stripe, 1, memory_order_relaxed) % PRIORITY_QUEUE_STATS_STRIPES;
+
+    // Success
+    return (struct priority_queue_stats_stripe_s *) &p_priority_queue->stats.stripes[priority_queue_stats_thread_stripe];
 }
 
 /** !
- * Recursively build the max heap
+ * Raise a counter to a value, if the value is larger
+ * 
+ * @param p_counter the counter
+ * @param value     the value
+ * 
+ * @return void
+ */
+static inline void priority_queue_stats_max ( _Atomic uint64_t *p_counter, uint64_t value )
+{
+
+    // Initialized data
+    uint64_t current = atomic_load_explicit(p_counter, memory_order_relaxed);
+
+    // Retry until the counter is at least the value
+    while ( value > current && !atomic_compare_exchange_weak_explicit(p_counter, &current, value, memory_order_relaxed, memory_order_relaxed) );
+}
+
+/** !
+ * Count a sift
  * 
  * @param p_priority_queue the priority queue
- * @param i                the index to start building from
+ * @param levels           the quantity of levels the key moved
  * 
- * @return 1 on success, 0 on error
-*/
-int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i );
+ * @return void
+ */
+static inline void priority_queue_stats_sift ( const priority_queue *const p_priority_queue, size_t levels )
+{
+
+    // Initialized data
+    struct priority_queue_stats_stripe_s *p_stripe = priority_queue_stats_stripe(p_priority_queue);
+
+    // Count the sift, and each level it moved
+    atomic_fetch_add_explicit(&p_stripe->sifts      , 1     , memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_stripe->sift_levels, levels, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_stripe->swaps      , levels, memory_order_relaxed);
+
+    // Track the deepest sift
+    priority_queue_stats_max(&p_stripe->max_sift_depth, levels);
+}
+#endif
 
+#ifndef NDEBUG
 /** !
- * Build a max heap 
+ * Report a null pointer argument. Out of line and cold, so the hot path stays small
+ * 
+ * @param parameter the name of the parameter
+ * @param function  the name of the function
+ * 
+ * @return void
+ */
+static PRIORITY_QUEUE_COLD void priority_queue_error_null ( const char *parameter, const char *function )
+{
+
+    // Report the error
+    printf("[priority queue] Null pointer provided for parameter \"%s\" in call to function \"%s\"\n", parameter, function);
+}
+
+/** !
+ * Report a failed call. Out of line and cold, so the hot path stays small
+ * 
+ * @param callee   the name of the function that failed
+ * @param function the name of the calling function
+ * 
+ * @return void
+ */
+static PRIORITY_QUEUE_COLD void priority_queue_error_call ( const char *callee, const char *function )
+{
+
+    // Report the error
+    printf("[priority queue] Call to function \"%s\" returned an erroneous value in call to function \"%s\"\n", callee, function);
+}
+
+/** !
+ * Report an error. Out of line and cold, so the hot path stays small
+ * 
+ * @param message  the error
+ * @param function the name of the function
+ * 
+ * @return void
+ */
+static PRIORITY_QUEUE_COLD void priority_queue_error ( const char *message, const char *function )
+{
+
+    // Report the error
+    printf("[priority queue] %s in call to function \"%s\"\n", message, function);
+}
+
+/** !
+ * Report a failed call to the standard library. Out of line and cold, so the hot 
+ * path stays small
+ * 
+ * @param message  the error
+ * @param function the name of the function
+ * 
+ * @return void
+ */
+static PRIORITY_QUEUE_COLD void priority_queue_error_standard ( const char *message, const char *function )
+{
+
+    // Report the error
+    printf("[Standard Library] %s in call to function \"%s\"\n", message, function);
+}
+
+/** !
+ * Report an error with a file. Out of line and cold, so the hot path stays small
+ * 
+ * @param message  the error
+ * @param path     the path of the file
+ * @param function the name of the function
+ * 
+ * @return void
+ */
+static PRIORITY_QUEUE_COLD void priority_queue_error_file ( const char *message, const char *path, const char *function )
+{
+
+    // Report the error
+    printf("[Standard Library] %s \"%s\" in call to function \"%s\"\n", message, path, function);
+}
+#endif
+
+/** !
+ * Get the histogram bucket of a latency
+ * 
+ * @param ns the latency in nanoseconds
+ * 
+ * @return the index of the bucket
+ */
+static inline size_t priority_queue_histogram_bucket ( uint64_t ns )
+{
+
+    // Initialized data
+    size_t msb = 0;
+
+    // Values below the sub bucket count have a bucket each
+    if ( ns < ( 1 << PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) ) return (size_t) ns;
+
+    // Find the most significant bit
+    #if defined(__GNUC__) || defined(__clang__)
+        msb = 63 - (size_t) __builtin_clzll(ns);
+    #else
+        while ( ns >> ( msb + 1 ) ) msb++;
+    #endif
+
+    // Clamp values past the last power of two into the last bucket
+    if ( msb >= PRIORITY_QUEUE_HISTOGRAM_BUCKETS / ( 1 << PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) + PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS - 1 ) return PRIORITY_QUEUE_HISTOGRAM_BUCKETS - 1;
+
+    // Otherwise, the power of two picks the row, and the next bits pick the bucket
+    return ( msb - PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS + 1 ) * ( 1 << PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) 
+         + ( ( ns >> ( msb - PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) ) & ( ( 1 << PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) - 1 ) );
+}
+
+/** !
+ * Get the largest latency counted in a histogram bucket
+ * 
+ * @param bucket the index of the bucket
+ * 
+ * @return the largest latency in nanoseconds
+ */
+static inline uint64_t priority_queue_histogram_bucket_highest ( size_t bucket )
+{
+
+    // Initialized data
+    size_t row   = bucket >> PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS,
+           shift = 0;
+
+    // Values below the sub bucket count have a bucket each
+    if ( row == 0 ) return (uint64_t) bucket;
+
+    // Otherwise, the bucket is 2 ^ ( row - 1 ) wide
+    shift = row - 1;
+
+    // Success
+    return ( ( (uint64_t) ( bucket - ( row - 1 ) * ( 1 << PRIORITY_QUEUE_HISTOGRAM_SUB_BUCKET_BITS ) ) + 1 ) << shift ) - 1;
+}
+
+#ifdef PRIORITY_QUEUE_HISTOGRAMS
+/** !
+ * Count a latency in a histogram of a priority queue
  * 
  * @param p_priority_queue the priority queue
+ * @param operation        the operation that was timed
+ * @param elapsed          the latency, in timer ticks
  * 
- * @return 1 on success, 0 on error
+ * @return void
  */
-int priority_queue_build_max_heap ( priority_queue *const p_priority_queue );
+static inline void priority_queue_histogram_record ( priority_queue *const p_priority_queue, priority_queue_operation operation, timestamp elapsed )
+{
+
+    // Initialized data
+    struct priority_queue_histogram_atomic_s *p_histogram = &p_priority_queue->histograms.operations[operation];
+    uint64_t                                  ns          = (uint64_t) ( (double) elapsed * 1e9 / (double) timer_seconds_divisor() ),
+                                              current     = 0;
+
+    // Count the latency
+    atomic_fetch_add_explicit(&p_histogram->counts[priority_queue_histogram_bucket(ns)], 1 , memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_histogram->sum                                        , ns, memory_order_relaxed);
+
+    // Track the smallest latency
+    current = atomic_load_explicit(&p_histogram->lowest, memory_order_relaxed);
+    while ( ~ns > current && !atomic_compare_exchange_weak_explicit(&p_histogram->lowest, &current, ~ns, memory_order_relaxed, memory_order_relaxed) );
+
+    // Track the largest latency
+    current = atomic_load_explicit(&p_histogram->highest, memory_order_relaxed);
+    while ( ns > current && !atomic_compare_exchange_weak_explicit(&p_histogram->highest, &current, ns, memory_order_relaxed, memory_order_relaxed) );
+}
+#endif
 
 /** !
- * Sort a max heap 
+ * Count the live keys of a priority queue
  * 
  * @param p_priority_queue the priority queue
  * 
- * @return 1 on success, 0 on error
+ * @return the quantity of keys, less the dead keys
  */
-int priority_queue_build_heap_sort ( priority_queue *const p_priority_queue );
+static inline size_t priority_queue_live ( const priority_queue *const p_priority_queue )
+{
 
+    // Initialized data
+    size_t count = p_priority_queue->entries.count + p_priority_queue->external.merger.count + p_priority_queue->sequence.count;
+
+    // Success
+    return ( count > p_priority_queue->tombstones.count ) ? count - p_priority_queue->tombstones.count : 0;
+}
+
+#ifdef PRIORITY_QUEUE_EVENTFD
 /** !
- * Get the maximum element in the heap
+ * Make the eventfd of a priority queue readable when the priority queue holds keys, 
+ * and not readable when it is empty. The eventfd is only written or read when the 
+ * priority queue changes between empty and not empty, so a burst of enqueues costs
+ * one write
  * 
- * @param p_priority_queue the priority queue 
- * @param pp_value         return 
+ * @param p_priority_queue the priority queue
  * 
- * @return 1 on success, 0 on error
+ * @return void
  */
-int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value );
+static void priority_queue_notify ( priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    bool     empty = ( priority_queue_live(p_priority_queue) == 0 );
+    uint64_t value = 1;
+
+    // The priority queue became non empty
+    if ( empty == false && p_priority_queue->notify.readable == false )
+        p_priority_queue->notify.readable = ( write(p_priority_queue->notify.fd, &value, sizeof(value)) == sizeof(value) );
+
+    // The priority queue became empty
+    else if ( empty && p_priority_queue->notify.readable )
+        p_priority_queue->notify.readable = ( read(p_priority_queue->notify.fd, &value, sizeof(value)) != sizeof(value) );
+
+    // Done
+    return;
+}
+#endif
 
 /** !
- * Get the maximum element in the heap
+ * Lock a priority queue. When statistics are enabled, count the acquisition, whether
+ * the lock was already held, and the time spent waiting. When histograms are enabled,
+ * time the wait, and start timing the hold
  * 
- * @param p_priority_queue the priority queue 
- * @param pp_value         return 
+ * @param p_priority_queue the priority queue
  * 
- * @return 1 on success, 0 on error
+ * @return void
  */
-int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **pp_value );
+static inline void priority_queue_lock ( priority_queue *const p_priority_queue )
+{
+
+    #if defined(PRIORITY_QUEUE_STATS) || defined(PRIORITY_QUEUE_HISTOGRAMS)
+
+        // Initialized data
+        timestamp t0 = timer_high_precision(),
+                  t1 = 0;
+    #endif
+
+    #ifdef PRIORITY_QUEUE_STATS
+
+        // Initialized data
+        bool contended = atomic_load_explicit(&p_priority_queue->stats.held, memory_order_relaxed);
+    #endif
+
+    // Lock
+    mutex_lock(p_priority_queue->_lock);
+
+    #if defined(PRIORITY_QUEUE_STATS) || defined(PRIORITY_QUEUE_HISTOGRAMS)
+
+        // Stop waiting
+        t1 = timer_high_precision();
+    #endif
+
+    #ifdef PRIORITY_QUEUE_STATS
+
+        // Mark the lock as held
+        atomic_store_explicit(&p_priority_queue->stats.held, true, memory_order_relaxed);
+
+        // Count the acquisition
+        PRIORITY_QUEUE_STAT_ADD(p_priority_queue, lock_acquisitions, 1);
+        PRIORITY_QUEUE_STAT_ADD(p_priority_queue, contended_acquisitions, contended);
+        PRIORITY_QUEUE_STAT_ADD(p_priority_queue, lock_wait_ns, (double) ( t1 - t0 ) * 1e9 / (double) timer_seconds_divisor());
+    #endif
+
+    #ifdef PRIORITY_QUEUE_HISTOGRAMS
+
+        // Time the wait, and start timing the hold
+        priority_queue_histogram_record(p_priority_queue, PRIORITY_QUEUE_OPERATION_LOCK_WAIT, t1 - t0);
+        p_priority_queue->histograms.locked_at = t1;
+    #endif
+
+    // Trace the acquisition
+    PRIORITY_QUEUE_TRACE_LOCK_ACQUIRE(p_priority_queue);
+}
 
 /** !
- * Increase the priority of a key in the heap
+ * Unlock a priority queue
  * 
- * @param p_priority_queue the priority queue 
- * @param index            the index of the key to increase
- * @param p_key            the key
+ * @param p_priority_queue the priority queue
  * 
- * @return 1 on success, 0 on error
+ * @return void
  */
-int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t index, void *p_key );
+static inline void priority_queue_unlock ( priority_queue *const p_priority_queue )
+{
+
+    #ifdef PRIORITY_QUEUE_STATS
+
+        // Mark the lock as free
+        atomic_store_explicit(&p_priority_queue->stats.held, false, memory_order_relaxed);
+    #endif
+
+    #ifdef PRIORITY_QUEUE_HISTOGRAMS
+
+        // Time the hold
+        PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_LOCK_HOLD, p_priority_queue->histograms.locked_at);
+    #endif
+
+    #ifdef PRIORITY_QUEUE_EVENTFD
+
+        // Update the readiness of the eventfd
+        if ( p_priority_queue->notify.open ) priority_queue_notify(p_priority_queue);
+    #endif
+
+    // Trace the release
+    PRIORITY_QUEUE_TRACE_LOCK_RELEASE(p_priority_queue);
+
+    // Unlock
+    mutex_unlock(p_priority_queue->_lock);
+}
 
 /** !
- * Insert an element into the max heap
+ * Compare two keys with the compare function of a priority queue
  * 
- * @param p_priority_queue the priority queue 
- * @param p_key            the key to be inserted into the heap
+ * @param p_priority_queue the priority queue
+ * @param p_a              a key
+ * @param p_b              another key
  * 
- * @return 1 on success, 0 on error
+ * @return the result of the compare function
  */
-int priority_queue_insert ( priority_queue *const pp_priority_queue, void *p_key );
+static inline int priority_queue_compare ( const priority_queue *const p_priority_queue, const void *const p_a, const void *const p_b )
+{
+
+    // Count the comparison
+    PRIORITY_QUEUE_STAT_ADD(p_priority_queue, comparisons, 1);
+
+    // Compare
+    return p_priority_queue->pfn_compare_function(p_a, p_b);
+}
+
+/** !
+ * Compare a to b
+ * 
+ * @param a pointer to a
+ * @param b pointer to b
+ * 
+ * @return 0 if a == b else -1 if a > b else 1
+ */
+int priority_queue_compare_function ( const void *const a, const void *const b )
+{
+    
+    // Return
+    return ( a == b ) ? 0 : ( a < b ) ? 1 : -1;
+}
+
+/** !
+ * Compute the index of the left child of a key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the physical index of the key
+ * 
+ * @return the physical index of the left child
+ */
+static inline size_t priority_queue_left ( const priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Binary layout, and the insertion heap of the sequence layout
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BLOCKED ) return PRIORITY_QUEUE_LEFT(i);
+
+    // Initialized data
+    size_t block  = i / PRIORITY_QUEUE_BLOCK_SLOTS,
+           offset = i % PRIORITY_QUEUE_BLOCK_SLOTS;
+
+    // Internal keys of a block have children in the same block ...
+    if ( offset < PRIORITY_QUEUE_BLOCK_INTERNAL ) return i + offset + 1;
+
+    // ... and leaves of a block have children at the roots of other blocks
+    return ( block * PRIORITY_QUEUE_BLOCK_SLOTS + 2 * ( offset - PRIORITY_QUEUE_BLOCK_INTERNAL ) + 1 ) * PRIORITY_QUEUE_BLOCK_SLOTS;
+}
+
+/** !
+ * Compute the index of the right child of a key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the physical index of the key
+ * 
+ * @return the physical index of the right child
+ */
+static inline size_t priority_queue_right ( const priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Binary layout, and the insertion heap of the sequence layout
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BLOCKED ) return PRIORITY_QUEUE_RIGHT(i);
+
+    // The right child follows the left child, in the same block or in the next block
+    return priority_queue_left(p_priority_queue, i) + ( ( i % PRIORITY_QUEUE_BLOCK_SLOTS < PRIORITY_QUEUE_BLOCK_INTERNAL ) ? 1 : PRIORITY_QUEUE_BLOCK_SLOTS );
+}
+
+/** !
+ * Compute the index of the parent of a key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the physical index of the key, which is not the root
+ * 
+ * @return the physical index of the parent
+ */
+static inline size_t priority_queue_parent ( const priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Binary layout, and the insertion heap of the sequence layout
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BLOCKED ) return PRIORITY_QUEUE_PARENT(i);
+
+    // Initialized data
+    size_t block  = i / PRIORITY_QUEUE_BLOCK_SLOTS,
+           offset = i % PRIORITY_QUEUE_BLOCK_SLOTS;
+
+    // Keys in a block have parents in the same block ...
+    if ( offset ) return i - offset + ( offset - 1 ) / 2;
+
+    // ... and the root of a block has a parent at a leaf of another block
+    return ( ( block - 1 ) / PRIORITY_QUEUE_BLOCK_SLOTS ) * PRIORITY_QUEUE_BLOCK_SLOTS + PRIORITY_QUEUE_BLOCK_INTERNAL + ( ( block - 1 ) % PRIORITY_QUEUE_BLOCK_SLOTS ) / 2;
+}
+
+/** !
+ * Compute the physical index of the nth key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param n                the logical index of the key
+ * 
+ * @return the physical index of the key
+ */
+static inline size_t priority_queue_physical ( const priority_queue *const p_priority_queue, size_t n )
+{
+
+    // Binary layout, and the insertion heap of the sequence layout
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BLOCKED ) return n;
+
+    // Skip the unused slot of each block
+    return ( n / PRIORITY_QUEUE_BLOCK_KEYS ) * PRIORITY_QUEUE_BLOCK_SLOTS + n % PRIORITY_QUEUE_BLOCK_KEYS;
+}
+
+/** !
+ * Test if a physical index holds a key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the physical index
+ * 
+ * @return true if the index is in the heap, else false
+ */
+static inline bool priority_queue_in_heap ( const priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Binary layout, and the insertion heap of the sequence layout
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BLOCKED ) return i < p_priority_queue->entries.count;
+
+    // Compare the logical index with the quantity of keys
+    return i - i / PRIORITY_QUEUE_BLOCK_SLOTS < p_priority_queue->entries.count;
+}
+
+// Typed heaps
+// 
+// A typed heap keeps priorities inline, in an array parallel to the keys, and orders 
+// them without calling a compare function. Lower priorities are dequeued first. Each
+// key has "arity" children, and the children of i start at arity * i + 1. The
+// priorities are aligned so every group of children starts on a 64 byte boundary. 
+// Floating point priorities are stored as 32 bit integers with an order preserving 
+// transform, so they share the 32 bit kernels
+
+/** !
+ * Transform a float into a 32 bit integer with the same order
+ * 
+ * @param f the float
+ * 
+ * @return the ordered integer
+ */
+static inline uint32_t priority_queue_float_to_ordered ( float f )
+{
+
+    // Initialized data
+    uint32_t u = 0;
+
+    // Get the bits of the float
+    memcpy(&u, &f, sizeof(u));
+
+    // Negative floats are reversed, positive floats are moved above them
+    return ( u & 0x80000000U ) ? ~u : ( u | 0x80000000U );
+}
+
+/** !
+ * Transform an ordered 32 bit integer back into a float
+ * 
+ * @param u the ordered integer
+ * 
+ * @return the float
+ */
+static inline float priority_queue_ordered_to_float ( uint32_t u )
+{
+
+    // Initialized data
+    float f = 0.f;
+
+    // Undo the transform
+    u = ( u & 0x80000000U ) ? ( u & 0x7fffffffU ) : ~u;
+
+    // Get the float
+    memcpy(&f, &u, sizeof(f));
+
+    // Success
+    return f;
+}
+
+/** !
+ * Find the child with the lowest 32 bit priority
+ * 
+ * @param p_priorities the priorities
+ * @param first        the index of the first child
+ * @param arity        the number of children
+ * 
+ * @return the index of the best child
+ */
+static size_t priority_queue_best_child_u32 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const uint32_t *p    = (const uint32_t *) p_priorities;
+    size_t          best = first;
+
+    // Compare each child, with a conditional move instead of a branch
+    for (size_t c = first + 1; c < first + arity; c++)
+        best = ( p[c] < p[best] ) ? c : best;
+
+    // Success
+    return best;
+}
+
+/** !
+ * Find the better of two children with 32 bit priorities, without a branch
+ * 
+ * @param p_priorities the priorities
+ * @param first        the index of the first child
+ * @param arity        unused; always 2
+ * 
+ * @return the index of the best child
+ */
+static size_t priority_queue_best_child_u32x2 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const uint32_t *p = (const uint32_t *) p_priorities;
+
+    // Unused
+    (void) arity;
+
+    // The second child wins only when it is strictly lower
+    return first + ( p[first + 1] < p[first] );
+}
+
+/** !
+ * Find the child with the lowest 64 bit priority
+ * 
+ * @param p_priorities the priorities
+ * @param first        the index of the first child
+ * @param arity        the number of children
+ * 
+ * @return the index of the best child
+ */
+static size_t priority_queue_best_child_u64 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const uint64_t *p    = (const uint64_t *) p_priorities;
+    size_t          best = first;
+
+    // Compare each child, with a conditional move instead of a branch
+    for (size_t c = first + 1; c < first + arity; c++)
+        best = ( p[c] < p[best] ) ? c : best;
+
+    // Success
+    return best;
+}
+
+/** !
+ * Find the better of two children with 64 bit priorities, without a branch
+ * 
+ * @param p_priorities the priorities
+ * @param first        the index of the first child
+ * @param arity        unused; always 2
+ * 
+ * @return the index of the best child
+ */
+static size_t priority_queue_best_child_u64x2 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const uint64_t *p = (const uint64_t *) p_priorities;
+
+    // Unused
+    (void) arity;
+
+    // The second child wins only when it is strictly lower
+    return first + ( p[first + 1] < p[first] );
+}
+
+#ifdef PRIORITY_QUEUE_X86_KERNELS
+
+// Each vector kernel reduces the children to their minimum, broadcasts it, and finds
+// the first child equal to it with a compare and a movemask. 64 bit kernels flip the
+// sign bit, because x86 only has signed 64 bit compares
+
+__attribute__((target("sse4.1")))
+static size_t priority_queue_best_child_u32x4_sse41 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    __m128i v = _mm_loadu_si128((const __m128i *) ( (const uint32_t *) p_priorities + first ));
+    __m128i m = _mm_min_epu32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, m))));
+}
+
+__attribute__((target("sse4.1")))
+static size_t priority_queue_best_child_u32x8_sse41 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    __m128i a = _mm_loadu_si128((const __m128i *) ( (const uint32_t *) p_priorities + first ));
+    __m128i b = _mm_loadu_si128((const __m128i *) ( (const uint32_t *) p_priorities + first + 4 ));
+    __m128i m = _mm_min_epu32(a, b);
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) ( _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, m))) | ( _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(b, m))) << 4 ) ));
+}
+
+__attribute__((target("avx2")))
+static size_t priority_queue_best_child_u32x8_avx2 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    __m256i v = _mm256_loadu_si256((const __m256i *) ( (const uint32_t *) p_priorities + first ));
+    __m256i m = _mm256_min_epu32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    m = _mm256_min_epu32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm256_min_epu32(m, _mm256_permute2x128_si256(m, m, 1));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, m))));
+}
+
+__attribute__((target("sse4.2")))
+static size_t priority_queue_best_child_u64x4_sse42 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+    __m128i       a    = _mm_xor_si128(_mm_loadu_si128((const __m128i *) ( (const uint64_t *) p_priorities + first )), bias);
+    __m128i       b    = _mm_xor_si128(_mm_loadu_si128((const __m128i *) ( (const uint64_t *) p_priorities + first + 2 )), bias);
+    __m128i       m    = _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b));
+    __m128i       t    = _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2));
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    m = _mm_blendv_epi8(m, t, _mm_cmpgt_epi64(m, t));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) ( _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a, m))) | ( _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(b, m))) << 2 ) ));
+}
+
+__attribute__((target("avx2")))
+static size_t priority_queue_best_child_u64x4_avx2 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i       v    = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) ( (const uint64_t *) p_priorities + first )), bias);
+    __m256i       t    = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2));
+    __m256i       m    = _mm256_blendv_epi8(v, t, _mm256_cmpgt_epi64(v, t));
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    t = _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2));
+    m = _mm256_blendv_epi8(m, t, _mm256_cmpgt_epi64(m, t));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, m))));
+}
+
+__attribute__((target("avx2")))
+static size_t priority_queue_best_child_u64x8_avx2 ( const void *const p_priorities, size_t first, size_t arity )
+{
+
+    // Initialized data
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i       a    = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) ( (const uint64_t *) p_priorities + first )), bias);
+    __m256i       b    = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) ( (const uint64_t *) p_priorities + first + 4 )), bias);
+    __m256i       m    = _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    __m256i       t    = _mm256_permute4x64_epi64(m, _MM_SHUFFLE(1, 0, 3, 2));
+
+    // Unused
+    (void) arity;
+
+    // Reduce
+    m = _mm256_blendv_epi8(m, t, _mm256_cmpgt_epi64(m, t));
+    t = _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2));
+    m = _mm256_blendv_epi8(m, t, _mm256_cmpgt_epi64(m, t));
+
+    // Find the first minimum
+    return first + (size_t) __builtin_ctz((unsigned) ( _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, m))) | ( _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(b, m))) << 4 ) ));
+}
+#endif
+
+/** !
+ * Choose the fastest kernel that finds the best of a full group of children
+ * 
+ * @param width the size of each priority in bytes
+ * @param arity the number of children
+ * 
+ * @return pointer to the kernel
+ */
+static priority_queue_best_child_fn *priority_queue_best_child_kernel ( size_t width, size_t arity )
+{
+
+    #ifdef PRIORITY_QUEUE_X86_KERNELS
+
+        // Detect the features of the processor
+        __builtin_cpu_init();
+
+        // Vector kernels for 4 children
+        if ( arity == 4 && width == sizeof(uint32_t) && __builtin_cpu_supports("sse4.1") ) return priority_queue_best_child_u32x4_sse41;
+        if ( arity == 4 && width == sizeof(uint64_t) && __builtin_cpu_supports("avx2")   ) return priority_queue_best_child_u64x4_avx2;
+        if ( arity == 4 && width == sizeof(uint64_t) && __builtin_cpu_supports("sse4.2") ) return priority_queue_best_child_u64x4_sse42;
+
+        // Vector kernels for 8 children
+        if ( arity == 8 && width == sizeof(uint32_t) && __builtin_cpu_supports("avx2")   ) return priority_queue_best_child_u32x8_avx2;
+        if ( arity == 8 && width == sizeof(uint32_t) && __builtin_cpu_supports("sse4.1") ) return priority_queue_best_child_u32x8_sse41;
+        if ( arity == 8 && width == sizeof(uint64_t) && __builtin_cpu_supports("avx2")   ) return priority_queue_best_child_u64x8_avx2;
+    #endif
+
+    // Index arithmetic for 2 children
+    if ( arity == 2 ) return ( width == sizeof(uint32_t) ) ? priority_queue_best_child_u32x2 : priority_queue_best_child_u64x2;
+
+    // Scalar kernels
+    return ( width == sizeof(uint32_t) ) ? priority_queue_best_child_u32 : priority_queue_best_child_u64;
+}
+
+/** !
+ * Move a key in a typed heap with 32 bit priorities toward the leaves
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * @param count            the quantity of keys in the heap
+ * 
+ * @return void
+ */
+static void priority_queue_typed_sift_down_u32 ( priority_queue *const p_priority_queue, size_t i, size_t count )
+{
+
+    // Initialized data
+    uint32_t                     *p_priorities   = (uint32_t *) p_priority_queue->typed.p_priorities;
+    void                        **data           = p_priority_queue->entries.data;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    uint32_t                      priority       = p_priorities[i];
+    void                         *p_key          = data[i];
+    size_t                        levels         = 0;
+
+    // Move the hole down until the key fits
+    for (;;)
+    {
+
+        // Initialized data
+        size_t first = arity * i + 1,
+               best  = 0;
+
+        // Stop at a leaf
+        if ( first >= count ) break;
+
+        // Find the best child of a full group with the kernel, or of a partial group with a loop
+        best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u32, p_priorities, first, arity, count);
+
+        // Stop when the heap property holds
+        if ( p_priorities[best] >= priority ) break;
+
+        // Move the child into the hole
+        p_priorities[i] = p_priorities[best];
+        data[i]         = data[best];
+
+        // Continue from the child
+        i = best;
+        levels++;
+    }
+
+    // Fill the hole
+    p_priorities[i] = priority;
+    data[i]         = p_key;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move a key in a typed heap with 64 bit priorities toward the leaves
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * @param count            the quantity of keys in the heap
+ * 
+ * @return void
+ */
+static void priority_queue_typed_sift_down_u64 ( priority_queue *const p_priority_queue, size_t i, size_t count )
+{
+
+    // Initialized data
+    uint64_t                     *p_priorities   = (uint64_t *) p_priority_queue->typed.p_priorities;
+    void                        **data           = p_priority_queue->entries.data;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    uint64_t                      priority       = p_priorities[i];
+    void                         *p_key          = data[i];
+    size_t                        levels         = 0;
+
+    // Move the hole down until the key fits
+    for (;;)
+    {
+
+        // Initialized data
+        size_t first = arity * i + 1,
+               best  = 0;
+
+        // Stop at a leaf
+        if ( first >= count ) break;
+
+        // Find the best child of a full group with the kernel, or of a partial group with a loop
+        best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u64, p_priorities, first, arity, count);
+
+        // Stop when the heap property holds
+        if ( p_priorities[best] >= priority ) break;
+
+        // Move the child into the hole
+        p_priorities[i] = p_priorities[best];
+        data[i]         = data[best];
+
+        // Continue from the child
+        i = best;
+        levels++;
+    }
+
+    // Fill the hole
+    p_priorities[i] = priority;
+    data[i]         = p_key;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move a key in a typed heap with 32 bit priorities toward the root
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * 
+ * @return void
+ */
+static void priority_queue_typed_sift_up_u32 ( priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Initialized data
+    uint32_t  *p_priorities = (uint32_t *) p_priority_queue->typed.p_priorities;
+    void     **data         = p_priority_queue->entries.data;
+    size_t     arity        = p_priority_queue->typed.arity;
+    uint32_t   priority     = p_priorities[i];
+    void      *p_key        = data[i];
+    size_t     levels       = 0;
+
+    // Move the hole up until the key fits
+    while ( i > 0 )
+    {
+
+        // Initialized data
+        size_t parent = ( i - 1 ) / arity;
+
+        // Stop when the heap property holds
+        if ( p_priorities[parent] <= priority ) break;
+
+        // Move the parent into the hole
+        p_priorities[i] = p_priorities[parent];
+        data[i]         = data[parent];
+
+        // Continue from the parent
+        i = parent;
+        levels++;
+    }
+
+    // Fill the hole
+    p_priorities[i] = priority;
+    data[i]         = p_key;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move a key in a typed heap with 64 bit priorities toward the root
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * 
+ * @return void
+ */
+static void priority_queue_typed_sift_up_u64 ( priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Initialized data
+    uint64_t  *p_priorities = (uint64_t *) p_priority_queue->typed.p_priorities;
+    void     **data         = p_priority_queue->entries.data;
+    size_t     arity        = p_priority_queue->typed.arity;
+    uint64_t   priority     = p_priorities[i];
+    void      *p_key        = data[i];
+    size_t     levels       = 0;
+
+    // Move the hole up until the key fits
+    while ( i > 0 )
+    {
+
+        // Initialized data
+        size_t parent = ( i - 1 ) / arity;
+
+        // Stop when the heap property holds
+        if ( p_priorities[parent] <= priority ) break;
+
+        // Move the parent into the hole
+        p_priorities[i] = p_priorities[parent];
+        data[i]         = data[parent];
+
+        // Continue from the parent
+        i = parent;
+        levels++;
+    }
+
+    // Fill the hole
+    p_priorities[i] = priority;
+    data[i]         = p_key;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move an entry in a compact heap toward the leaves. Each entry packs a 32 bit 
+ * priority above a 32 bit index, so entries compare as 64 bit priorities, and there 
+ * are no keys to move
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the entry
+ * @param count            the quantity of entries in the heap
+ * 
+ * @return void
+ */
+static void priority_queue_compact_sift_down ( priority_queue *const p_priority_queue, size_t i, size_t count )
+{
+
+    // Initialized data
+    uint64_t                     *p_entries      = (uint64_t *) p_priority_queue->typed.p_priorities;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    uint64_t                      entry          = p_entries[i];
+    size_t                        levels         = 0;
+
+    // Move the hole down until the entry fits
+    for (;;)
+    {
+
+        // Initialized data
+        size_t first = arity * i + 1,
+               best  = 0;
+
+        // Stop at a leaf
+        if ( first >= count ) break;
+
+        // Find the best child of a full group with the kernel, or of a partial group with a loop
+        best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u64, p_entries, first, arity, count);
+
+        // Stop when the heap property holds
+        if ( p_entries[best] >= entry ) break;
+
+        // Move the child into the hole
+        p_entries[i] = p_entries[best];
+
+        // Continue from the child
+        i = best;
+        levels++;
+    }
+
+    // Fill the hole
+    p_entries[i] = entry;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move an entry in a compact heap toward the root
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the entry
+ * 
+ * @return void
+ */
+static void priority_queue_compact_sift_up ( priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Initialized data
+    uint64_t *p_entries = (uint64_t *) p_priority_queue->typed.p_priorities;
+    size_t    arity     = p_priority_queue->typed.arity;
+    uint64_t  entry     = p_entries[i];
+    size_t    levels    = 0;
+
+    // Move the hole up until the entry fits
+    while ( i > 0 )
+    {
+
+        // Initialized data
+        size_t parent = ( i - 1 ) / arity;
+
+        // Stop when the heap property holds
+        if ( p_entries[parent] <= entry ) break;
+
+        // Move the parent into the hole
+        p_entries[i] = p_entries[parent];
+
+        // Continue from the parent
+        i = parent;
+        levels++;
+    }
+
+    // Fill the hole
+    p_entries[i] = entry;
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Done
+    return;
+}
+
+/** !
+ * Move a hole in a typed heap with 32 bit priorities from the root to a leaf, by 
+ * moving the best child of each level up. Nothing is compared with the key that
+ * fills the hole, so the only branch is the bound of the loop
+ * 
+ * @param p_priority_queue the priority queue
+ * @param count            the quantity of keys in the heap
+ * 
+ * @return the index of the hole
+ */
+static size_t priority_queue_typed_descend_u32 ( priority_queue *const p_priority_queue, size_t count )
+{
+
+    // Initialized data
+    uint32_t                     *p_priorities   = (uint32_t *) p_priority_queue->typed.p_priorities;
+    void                        **data           = p_priority_queue->entries.data;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    size_t                        i              = 0,
+                                  levels         = 0;
+
+    // Move the hole down to a leaf
+    for (size_t first = 1; first < count; first = arity * i + 1)
+    {
+
+        // Initialized data
+        size_t best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u32, p_priorities, first, arity, count);
+
+        // Move the child into the hole
+        p_priorities[i] = p_priorities[best];
+        data[i]         = data[best];
+
+        // Continue from the child
+        i = best;
+        levels++;
+    }
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Success
+    return i;
+}
+
+/** !
+ * Move a hole in a typed heap with 64 bit priorities from the root to a leaf
+ * 
+ * @param p_priority_queue the priority queue
+ * @param count            the quantity of keys in the heap
+ * 
+ * @return the index of the hole
+ */
+static size_t priority_queue_typed_descend_u64 ( priority_queue *const p_priority_queue, size_t count )
+{
+
+    // Initialized data
+    uint64_t                     *p_priorities   = (uint64_t *) p_priority_queue->typed.p_priorities;
+    void                        **data           = p_priority_queue->entries.data;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    size_t                        i              = 0,
+                                  levels         = 0;
+
+    // Move the hole down to a leaf
+    for (size_t first = 1; first < count; first = arity * i + 1)
+    {
+
+        // Initialized data
+        size_t best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u64, p_priorities, first, arity, count);
+
+        // Move the child into the hole
+        p_priorities[i] = p_priorities[best];
+        data[i]         = data[best];
+
+        // Continue from the child
+        i = best;
+        levels++;
+    }
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Success
+    return i;
+}
+
+/** !
+ * Move a hole in a compact heap from the root to a leaf
+ * 
+ * @param p_priority_queue the priority queue
+ * @param count            the quantity of entries in the heap
+ * 
+ * @return the index of the hole
+ */
+static size_t priority_queue_compact_descend ( priority_queue *const p_priority_queue, size_t count )
+{
+
+    // Initialized data
+    uint64_t                     *p_entries      = (uint64_t *) p_priority_queue->typed.p_priorities;
+    size_t                        arity          = p_priority_queue->typed.arity;
+    priority_queue_best_child_fn *pfn_best_child = p_priority_queue->typed.pfn_best_child;
+    size_t                        i              = 0,
+                                  levels         = 0;
+
+    // Move the hole down to a leaf
+    for (size_t first = 1; first < count; first = arity * i + 1)
+    {
+
+        // Initialized data
+        size_t best = PRIORITY_QUEUE_BEST_CHILD(pfn_best_child, priority_queue_best_child_u64, p_entries, first, arity, count);
+
+        // Move the child into the hole, and continue from the child
+        p_entries[i] = p_entries[best];
+        i            = best;
+        levels++;
+    }
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Success
+    return i;
+}
+
+/** !
+ * Move a key in a typed heap toward the leaves
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * @param count            the quantity of keys in the heap
+ * 
+ * @return void
+ */
+static inline void priority_queue_typed_sift_down ( priority_queue *const p_priority_queue, size_t i, size_t count )
+{
+
+    // Dispatch on the width of the priorities
+    if      ( p_priority_queue->typed.width == sizeof(uint32_t)           ) priority_queue_typed_sift_down_u32(p_priority_queue, i, count);
+    else if ( p_priority_queue->typed.type  == PRIORITY_QUEUE_PRIORITY_INDEX ) priority_queue_compact_sift_down(p_priority_queue, i, count);
+    else                                                                      priority_queue_typed_sift_down_u64(p_priority_queue, i, count);
+}
+
+/** !
+ * Move a key in a typed heap toward the root
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * 
+ * @return void
+ */
+static inline void priority_queue_typed_sift_up ( priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Dispatch on the width of the priorities
+    if      ( p_priority_queue->typed.width == sizeof(uint32_t)           ) priority_queue_typed_sift_up_u32(p_priority_queue, i);
+    else if ( p_priority_queue->typed.type  == PRIORITY_QUEUE_PRIORITY_INDEX ) priority_queue_compact_sift_up(p_priority_queue, i);
+    else                                                                      priority_queue_typed_sift_up_u64(p_priority_queue, i);
+}
+
+/** !
+ * Store a priority in a typed heap
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * @param priority         the priority
+ * 
+ * @return void
+ */
+static inline void priority_queue_typed_store ( priority_queue *const p_priority_queue, size_t i, priority_queue_priority priority )
+{
+
+    // Store the priority in the representation of its type
+    switch ( p_priority_queue->typed.type )
+    {
+        case PRIORITY_QUEUE_PRIORITY_U32:   ( (uint32_t *) p_priority_queue->typed.p_priorities )[i] = priority.u32; break;
+        case PRIORITY_QUEUE_PRIORITY_FLOAT: ( (uint32_t *) p_priority_queue->typed.p_priorities )[i] = priority_queue_float_to_ordered(priority.f32); break;
+        case PRIORITY_QUEUE_PRIORITY_INDEX: ( (uint64_t *) p_priority_queue->typed.p_priorities )[i] = PRIORITY_QUEUE_COMPACT_ENTRY(priority.u32, ( (uint64_t *) p_priority_queue->typed.p_priorities )[i]); break;
+        default:                            ( (uint64_t *) p_priority_queue->typed.p_priorities )[i] = priority.u64; break;
+    }
+}
+
+/** !
+ * Load a priority from a typed heap
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index of the key
+ * 
+ * @return the priority
+ */
+static inline priority_queue_priority priority_queue_typed_load ( const priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Initialized data
+    priority_queue_priority priority = { 0 };
+
+    // Load the priority from the representation of its type
+    switch ( p_priority_queue->typed.type )
+    {
+        case PRIORITY_QUEUE_PRIORITY_U32:   priority.u32 = ( (const uint32_t *) p_priority_queue->typed.p_priorities )[i]; break;
+        case PRIORITY_QUEUE_PRIORITY_FLOAT: priority.f32 = priority_queue_ordered_to_float(( (const uint32_t *) p_priority_queue->typed.p_priorities )[i]); break;
+        case PRIORITY_QUEUE_PRIORITY_INDEX: priority.u32 = (uint32_t) ( ( (const uint64_t *) p_priority_queue->typed.p_priorities )[i] >> 32 ); break;
+        default:                            priority.u64 = ( (const uint64_t *) p_priority_queue->typed.p_priorities )[i]; break;
+    }
+
+    // Success
+    return priority;
+}
+
+/** !
+ * Compute the priority of a key in a typed heap
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * 
+ * @return the priority
+ */
+static inline priority_queue_priority priority_queue_typed_priority ( const priority_queue *const p_priority_queue, const void *const p_key )
+{
+
+    // Initialized data
+    priority_queue_priority priority = { 0 };
+
+    // Use the priority function, if there is one
+    if ( p_priority_queue->typed.pfn_priority ) return p_priority_queue->typed.pfn_priority(p_key);
+
+    // Otherwise, use the value of the key
+    switch ( p_priority_queue->typed.type )
+    {
+        case PRIORITY_QUEUE_PRIORITY_U32:
+        case PRIORITY_QUEUE_PRIORITY_LEVEL:
+        case PRIORITY_QUEUE_PRIORITY_INDEX: priority.u32 = (uint32_t) (uintptr_t) p_key; break;
+        case PRIORITY_QUEUE_PRIORITY_FLOAT: priority.f32 = (float) (uintptr_t) p_key; break;
+        default:                            priority.u64 = (uint64_t) (uintptr_t) p_key; break;
+    }
+
+    // Success
+    return priority;
+}
+
+/** !
+ * Find the first occupied level of a bucket queue. The caller checks for underflow
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return the level
+ */
+static inline size_t priority_queue_bucket_first ( const priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    uint64_t summary = p_priority_queue->bucket.summary,
+             word    = 0;
+    size_t   w       = 0,
+             b       = 0;
+
+    // Find the first non zero word, then the first set bit of the word
+    #if defined(__GNUC__) || defined(__clang__)
+        w    = (size_t) __builtin_ctzll(summary);
+        word = p_priority_queue->bucket.p_occupied[w];
+        b    = (size_t) __builtin_ctzll(word);
+    #else
+        while ( ( summary >> w & 1 ) == 0 ) w++;
+        word = p_priority_queue->bucket.p_occupied[w];
+        while ( ( word    >> b & 1 ) == 0 ) b++;
+    #endif
+
+    // Success
+    return w * 64 + b;
+}
+
+/** !
+ * Add a key to the back of its level in a bucket queue. The caller checks for 
+ * overflow. Levels past the last are stored in the last level
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * @param level            the level
+ * 
+ * @return void
+ */
+static void priority_queue_bucket_push ( priority_queue *const p_priority_queue, void *p_key, size_t level )
+{
+
+    // Initialized data
+    size_t slot = p_priority_queue->bucket.free;
+
+    // Clamp the level
+    if ( level >= p_priority_queue->bucket.levels ) level = p_priority_queue->bucket.levels - 1;
+
+    // Take a slot from the free list
+    p_priority_queue->bucket.free         = p_priority_queue->bucket.p_next[slot];
+    p_priority_queue->bucket.p_next[slot] = SIZE_MAX;
+    p_priority_queue->entries.data[slot]  = p_key;
+
+    // Link the slot behind the last key of the level ...
+    if ( p_priority_queue->bucket.p_head[level] != SIZE_MAX )
+        p_priority_queue->bucket.p_next[p_priority_queue->bucket.p_tail[level]] = slot;
+
+    // ... or make the level occupied
+    else
+    {
+        p_priority_queue->bucket.p_head[level]            = slot;
+        p_priority_queue->bucket.p_occupied[level / 64] |= UINT64_C(1) << ( level % 64 );
+        p_priority_queue->bucket.summary                 |= UINT64_C(1) << ( level / 64 );
+    }
+
+    // The slot is the back of the level
+    p_priority_queue->bucket.p_tail[level] = slot;
+    p_priority_queue->entries.count++;
+
+    // Done
+    return;
+}
+
+/** !
+ * Remove the key in the front of the first occupied level of a bucket queue. The 
+ * caller checks for underflow
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return, or 0
+ * @param p_priority       return, the level, or 0
+ * 
+ * @return void
+ */
+static void priority_queue_bucket_pop ( priority_queue *const p_priority_queue, void **pp_key, priority_queue_priority *p_priority )
+{
+
+    // Initialized data
+    size_t level = priority_queue_bucket_first(p_priority_queue),
+           slot  = p_priority_queue->bucket.p_head[level];
+
+    // Return the key and its level to the caller
+    if ( pp_key     ) *pp_key          = p_priority_queue->entries.data[slot];
+    if ( p_priority ) p_priority->u32 = (uint32_t) level;
+
+    // Unlink the slot
+    p_priority_queue->bucket.p_head[level] = p_priority_queue->bucket.p_next[slot];
+
+    // Clear the bits of an empty level
+    if ( p_priority_queue->bucket.p_head[level] == SIZE_MAX )
+    {
+        p_priority_queue->bucket.p_occupied[level / 64] &= ~( UINT64_C(1) << ( level % 64 ) );
+        if ( p_priority_queue->bucket.p_occupied[level / 64] == 0 ) p_priority_queue->bucket.summary &= ~( UINT64_C(1) << ( level / 64 ) );
+    }
+
+    // Return the slot to the free list
+    p_priority_queue->entries.data[slot]  = (void *) 0;
+    p_priority_queue->bucket.p_next[slot] = p_priority_queue->bucket.free;
+    p_priority_queue->bucket.free         = slot;
+    p_priority_queue->entries.count--;
+
+    // Done
+    return;
+}
+
+/** !
+ * Age a priority. Each enqueue adds the rate to a bias, and the bias is added to the
+ * priority, so a key gains on every key enqueued after it, without updating the heap.
+ * When the bias would overflow, it and every stored priority are lowered by the same
+ * amount, which keeps the heap in order. Priorities that would overflow saturate
+ * 
+ * @param p_priority_queue the priority queue
+ * @param priority         the priority
+ * 
+ * @return the aged priority
+ */
+static uint64_t priority_queue_aging_apply ( priority_queue *const p_priority_queue, uint64_t priority )
+{
+
+    // Initialized data
+    uint64_t *p_priorities = p_priority_queue->typed.p_priorities,
+              rate         = p_priority_queue->aging.rate,
+              base         = p_priority_queue->aging.bias;
+
+    // Rebase, if the bias would overflow
+    if ( p_priority_queue->aging.bias > UINT64_MAX - rate )
+    {
+
+        // The root has the lowest priority of the heap
+        if ( p_priority_queue->entries.count && p_priorities[0] < base ) base = p_priorities[0];
+
+        // Lower every priority, and the bias
+        for (size_t i = 0; i < p_priority_queue->entries.count; i++) p_priorities[i] -= base;
+        p_priority_queue->aging.bias -= base;
+    }
+
+    // Advance the bias
+    p_priority_queue->aging.bias = ( p_priority_queue->aging.bias > UINT64_MAX - rate ) ? UINT64_MAX : p_priority_queue->aging.bias + rate;
+
+    // Success
+    return ( priority > UINT64_MAX - p_priority_queue->aging.bias ) ? UINT64_MAX : priority + p_priority_queue->aging.bias;
+}
+
+/** !
+ * Insert a key into a typed heap. The caller checks for overflow
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * @param priority         the priority of the key
+ * 
+ * @return void
+ */
+static void priority_queue_typed_insert ( priority_queue *const p_priority_queue, void *p_key, priority_queue_priority priority )
+{
+
+    // Initialized data
+    size_t i = p_priority_queue->entries.count;
+
+    // Bucket queues add the key to its level
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL )
+    {
+
+        // Add the key
+        priority_queue_bucket_push(p_priority_queue, p_key, priority.u32);
+
+        // Done
+        return;
+    }
+
+    // Compact heaps pack the index with its priority
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX )
+    {
+
+        // Store the entry in the first leaf
+        p_priority_queue->entries.count++;
+        ( (uint64_t *) p_priority_queue->typed.p_priorities )[i] = PRIORITY_QUEUE_COMPACT_ENTRY(priority.u32, (uintptr_t) p_key);
+
+        // Position the entry correctly
+        priority_queue_compact_sift_up(p_priority_queue, i);
+
+        // Done
+        return;
+    }
+
+    // Age the priority
+    if ( p_priority_queue->aging.rate ) priority.u64 = priority_queue_aging_apply(p_priority_queue, priority.u64);
+
+    // Store the key in the first leaf
+    p_priority_queue->entries.count++;
+    p_priority_queue->entries.data[i] = p_key;
+    priority_queue_typed_store(p_priority_queue, i, priority);
+
+    // Position the key correctly
+    priority_queue_typed_sift_up(p_priority_queue, i);
+
+    // Done
+    return;
+}
+
+/** !
+ * Remove the key with the lowest priority from a typed heap. The caller checks for underflow
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ * @param p_priority       return, or 0
+ * 
+ * @return void
+ */
+static void priority_queue_typed_extract ( priority_queue *const p_priority_queue, void **pp_key, priority_queue_priority *p_priority )
+{
+
+    // Bucket queues remove the key from the first occupied level
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL )
+    {
+
+        // Remove the key
+        priority_queue_bucket_pop(p_priority_queue, pp_key, p_priority);
+
+        // Done
+        return;
+    }
+
+    // Initialized data
+    size_t last  = --p_priority_queue->entries.count;
+    size_t width = p_priority_queue->typed.width;
+
+    // Compact heaps unpack the index and its priority
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX )
+    {
+
+        // Initialized data
+        uint64_t *p_entries = (uint64_t *) p_priority_queue->typed.p_priorities,
+                  root      = p_entries[0];
+
+        // Return the root to the caller
+        if ( pp_key     ) *pp_key          = (void *) (uintptr_t) PRIORITY_QUEUE_COMPACT_INDEX(root);
+        if ( p_priority ) p_priority->u32 = (uint32_t) ( root >> 32 );
+
+        // Initialized data
+        uint64_t entry = p_entries[last];
+        size_t   hole  = 0;
+
+        // Pad the slot of the last entry
+        #ifdef PRIORITY_QUEUE_PADDING
+            p_entries[last] = UINT64_MAX;
+        #endif
+
+        // Move the hole to a leaf, then move the last entry up from the hole
+        hole            = priority_queue_compact_descend(p_priority_queue, last);
+        p_entries[hole] = entry;
+        priority_queue_compact_sift_up(p_priority_queue, hole);
+
+        // Done
+        return;
+    }
+
+    // Return the root to the caller
+    if ( pp_key     ) *pp_key     = p_priority_queue->entries.data[0];
+    if ( p_priority ) *p_priority = priority_queue_typed_load(p_priority_queue, 0);
+
+    // Remove the bias of an aged priority, which leaves the priority lowered by the 
+    // rate for each later enqueue
+    if ( p_priority && p_priority_queue->aging.bias ) p_priority->u64 = ( p_priority->u64 > p_priority_queue->aging.bias ) ? p_priority->u64 - p_priority_queue->aging.bias : 0;
+
+    // Initialized data
+    unsigned char *p_priorities = p_priority_queue->typed.p_priorities;
+    void          *p_key        = p_priority_queue->entries.data[last];
+    uint64_t       priority     = 0;
+    size_t         hole         = 0;
+
+    // Take the last key
+    memcpy(&priority, p_priorities + last * width, width);
+    p_priority_queue->entries.data[last] = (void *) 0;
+
+    // Pad the slot of the last key
+    #ifdef PRIORITY_QUEUE_PADDING
+        memset(p_priorities + last * width, 0xFF, width);
+    #endif
+
+    // Move the hole from the root to a leaf. The last key was a leaf, so it usually 
+    // belongs near the leaves, and moving it up from the hole takes few comparisons
+    hole = ( width == sizeof(uint32_t) ) ? priority_queue_typed_descend_u32(p_priority_queue, last) : priority_queue_typed_descend_u64(p_priority_queue, last);
+
+    // Fill the hole with the last key, and move it up
+    p_priority_queue->entries.data[hole] = p_key;
+    memcpy(p_priorities + hole * width, &priority, width);
+    priority_queue_typed_sift_up(p_priority_queue, hole);
+
+    // Done
+    return;
+}
+
+/** !
+ * Remove every key of a typed heap, in ascending order of priority. Sorting in place
+ * would leave sorted priorities in the padding of the last group of children
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_keys           return; one slot for each key
+ * 
+ * @return void
+ */
+static void priority_queue_typed_sort ( priority_queue *const p_priority_queue, void **p_keys )
+{
+
+    // Remove the root, and store it behind the keys that follow it
+    for (size_t i = p_priority_queue->entries.count; i-- > 0;)
+        priority_queue_typed_extract(p_priority_queue, &p_keys[i], (void *) 0);
+
+    // Done
+    return;
+}
+
+// Loser trees
+// 
+// A loser tree merges k sorted runs. Each internal node holds the run that lost the 
+// match played there, and node 0 holds the overall winner. Leaves are implicit; run i
+// sits at node k + i. After the winner advances, one match per level is replayed on 
+// the path from its leaf to the root, so each key costs log2(k) comparisons and no 
+// swaps between siblings
+
+/** !
+ * Test if the head of one run should be merged before the head of another
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_merger         the merger
+ * @param a                the index of a run
+ * @param b                the index of another run
+ * 
+ * @return true if run a wins, else false
+ */
+static inline bool priority_queue_run_beats ( const priority_queue *const p_priority_queue, const struct priority_queue_merger_s *const p_merger, size_t a, size_t b )
+{
+
+    // Initialized data
+    int result = 0;
+
+    // Exhausted runs always lose
+    if ( p_merger->p_runs[a].remaining == 0 ) return false;
+    if ( p_merger->p_runs[b].remaining == 0 ) return true;
+
+    // Compare the heads
+    result = priority_queue_compare(p_priority_queue, p_merger->p_runs[a].p_head, p_merger->p_runs[b].p_head);
+
+    // Break ties by run, so older runs win
+    return ( result > 0 ) || ( result == 0 && a < b );
+}
+
+/** !
+ * Play every match of a loser tree
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_merger         the merger
+ * 
+ * @return void
+ */
+static void priority_queue_loser_tree_build ( const priority_queue *const p_priority_queue, struct priority_queue_merger_s *const p_merger )
+{
+
+    // Initialized data
+    size_t  k         = p_merger->run_count;
+    size_t *p_winners = p_merger->p_winners;
+
+    // Fast exit
+    if ( k == 0 ) return;
+
+    // Each run enters at its leaf
+    for (size_t i = 0; i < k; i++) p_winners[k + i] = i;
+
+    // Play the matches from the leaves to the root
+    for (size_t n = k - 1; n > 0; n--)
+    {
+
+        // Initialized data
+        size_t l = p_winners[2 * n],
+               r = p_winners[2 * n + 1];
+
+        // The winner moves up, and the loser stays
+        if ( priority_queue_run_beats(p_priority_queue, p_merger, l, r) ) p_winners[n] = l, p_merger->p_tree[n] = r;
+        else                                                              p_winners[n] = r, p_merger->p_tree[n] = l;
+    }
+
+    // Store the overall winner
+    p_merger->p_tree[0] = ( k > 1 ) ? p_winners[1] : 0;
+
+    // Done
+    return;
+}
+
+/** !
+ * Replay the matches of the last winner of a loser tree, after its head changed
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_merger         the merger
+ * 
+ * @return void
+ */
+static void priority_queue_loser_tree_replay ( const priority_queue *const p_priority_queue, struct priority_queue_merger_s *const p_merger )
+{
+
+    // Initialized data
+    size_t  k      = p_merger->run_count;
+    size_t  winner = p_merger->p_tree[0];
+    size_t *p_tree = p_merger->p_tree;
+
+    // Play each match on the path to the root
+    for (size_t n = ( k + winner ) / 2; n > 0; n /= 2)
+    {
+
+        // The loser of the match stays at the node
+        if ( priority_queue_run_beats(p_priority_queue, p_merger, p_tree[n], winner) )
+        {
+
+            // Swap the winner with the loser
+            size_t tmp = p_tree[n];
+            p_tree[n]  = winner;
+            winner     = tmp;
+        }
+    }
+
+    // Store the overall winner
+    p_tree[0] = winner;
+
+    // Done
+    return;
+}
+
+/** !
+ * Test if the front of an external priority queue is on disk
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return true if the front of the merged runs beats the front of the heap, else false
+ */
+static inline bool priority_queue_external_first ( const priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    const struct priority_queue_merger_s *p_merger = &p_priority_queue->external.merger;
+
+    // Nothing is on disk
+    if ( p_merger->count == 0 ) return false;
+
+    // Nothing is in memory
+    if ( p_priority_queue->entries.count == 0 ) return true;
+
+    // Compare the winner of the runs with the root of the heap
+    return priority_queue_compare(p_priority_queue, p_merger->p_runs[p_merger->p_tree[0]].p_head, p_priority_queue->entries.data[0]) > 0;
+}
+
+/** !
+ * Find the front of a sequence heap
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return the index of the group whose winner is the front, or SIZE_MAX if the root 
+ *         of the insertion heap is the front
+ */
+static inline size_t priority_queue_sequence_front ( const priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    size_t  front   = SIZE_MAX;
+    void   *p_front = ( p_priority_queue->entries.count ) ? p_priority_queue->entries.data[0] : (void *) 0;
+
+    // Play the winner of each group against the front
+    for (size_t g = 0; g < p_priority_queue->sequence.group_count; g++)
+    {
+
+        // Initialized data
+        const struct priority_queue_merger_s *p_group = &p_priority_queue->sequence.p_groups[g];
+
+        // Skip empty groups
+        if ( p_group->count == 0 ) continue;
+
+        // Initialized data
+        void *p_head = p_group->p_runs[p_group->p_tree[0]].p_head;
+
+        // The first group with a better head is the new front
+        if ( p_front == (void *) 0 || priority_queue_compare(p_priority_queue, p_head, p_front) > 0 ) front = g, p_front = p_head;
+    }
+
+    // Success
+    return front;
+}
+
+/** !
+ * Remove the winner of a group of a sequence heap
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_group          the group
+ * 
+ * @return the key
+ */
+static inline void *priority_queue_sequence_pop ( const priority_queue *const p_priority_queue, struct priority_queue_merger_s *const p_group )
+{
+
+    // Initialized data
+    struct priority_queue_run_s *p_run = &p_group->p_runs[p_group->p_tree[0]];
+    void                        *p_key = p_run->p_head;
+
+    // Remove the key
+    p_run->remaining--,
+    p_group->count--;
+
+    // The next key of the sequence is the new head
+    if ( p_run->remaining ) p_run->p_head = p_run->p_keys[++p_run->offset];
+
+    // Find the next winner
+    priority_queue_loser_tree_replay(p_priority_queue, p_group);
+
+    // Success
+    return p_key;
+}
+
+/** !
+ * Add a sorted sequence to a group of a sequence heap. A full group is merged into
+ * one sequence, which is added to the next group
+ * 
+ * @param p_priority_queue the priority queue
+ * @param g                the index of the group
+ * @param p_keys           the keys, in descending order of priority. The group owns them
+ * @param count            the quantity of keys
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_sequence_push ( priority_queue *const p_priority_queue, size_t g, void **p_keys, size_t count );
+
+/** !
+ * Sort the insertion heap of a sequence heap into a sequence, add it to the first 
+ * group, and empty the insertion heap
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_sequence_spill ( priority_queue *const p_priority_queue );
+
+/** !
+ * Recursively build the max heap
+ * 
+ * @param p_priority_queue the priority queue
+ * @param i                the index to start building from
+ * 
+ * @return 1 on success, 0 on error
+*/
+int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i );
+
+/** !
+ * Build a max heap 
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_build_max_heap ( priority_queue *const p_priority_queue );
+
+/** !
+ * Build a max heap, with worker threads building independent subtrees
+ * 
+ * @param p_priority_queue the priority queue, with the binary layout
+ * @param threads          the quantity of threads, or 0 for one per processor
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_build_max_heap_parallel ( priority_queue *const p_priority_queue, size_t threads );
+
+/** !
+ * Sort a max heap. Afterwards, the keys are in ascending order of priority, and
+ * no longer form a heap
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_build_heap_sort ( priority_queue *const p_priority_queue );
+
+/** !
+ * Get the maximum element in the heap
+ * 
+ * @param p_priority_queue the priority queue 
+ * @param pp_value         return 
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value );
+
+/** !
+ * Get the maximum element in the heap
+ * 
+ * @param p_priority_queue the priority queue 
+ * @param pp_value         return 
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **pp_value );
+
+/** !
+ * Increase the priority of a key in the heap
+ * 
+ * @param p_priority_queue the priority queue 
+ * @param index            the index of the key to increase
+ * @param p_key            the key
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t index, void *p_key );
+
+/** !
+ * Insert an element into the max heap
+ * 
+ * @param p_priority_queue the priority queue 
+ * @param p_key            the key to be inserted into the heap
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_insert ( priority_queue *const pp_priority_queue, void *p_key );
+
+#ifndef _WIN64
+/** !
+ * Compute the checksum of a memory mapped priority queue header
+ * 
+ * @param p_header the header
+ * 
+ * @return FNV-1a hash of every field of the header except the checksum
+ */
+uint64_t priority_queue_mapped_checksum ( const struct priority_queue_mapped_header_s *const p_header );
+
+/** !
+ * Write the heap to the uncommitted region of the backing file, flush it, and then
+ * write and flush a header that commits it. The caller must hold the lock
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_mapped_commit ( priority_queue *const p_priority_queue );
+
+/** !
+ * Write the buffered contents of a stream to its file descriptor
+ * 
+ * @param p_stream the stream
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_stream_flush ( struct priority_queue_stream_s *const p_stream );
+
+/** !
+ * Write data to a stream. Data larger than the buffer bypasses it
+ * 
+ * @param p_stream the stream
+ * @param p_data   the data
+ * @param size     the size of the data in bytes
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_stream_write ( struct priority_queue_stream_s *const p_stream, const void *const p_data, size_t size );
+
+/** !
+ * Buffer at least size bytes of a stream, starting at its offset
+ * 
+ * @param p_stream the stream
+ * @param size     the number of bytes, no larger than the capacity of the stream
+ * 
+ * @return 1 on success, 0 on error or end of file
+ */
+int priority_queue_stream_fill ( struct priority_queue_stream_s *const p_stream, size_t size );
+
+/** !
+ * Read data from a stream. Data larger than the buffer bypasses it
+ * 
+ * @param p_stream the stream
+ * @param p_data   return
+ * @param size     the size of the data in bytes
+ * 
+ * @return 1 on success, 0 on error or end of file
+ */
+int priority_queue_stream_read ( struct priority_queue_stream_s *const p_stream, void *const p_data, size_t size );
+
+/** !
+ * Write a key to a stream, as a length prefixed record. Keys are serialized in place 
+ * when they fit in the buffer, and into the scratch buffer of the stream otherwise
+ * 
+ * @param p_stream      the stream
+ * @param p_key         the key
+ * @param pfn_serialize pointer to a function that serializes a key, or 0 to write the key by value
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_stream_write_key ( struct priority_queue_stream_s *const p_stream, void *p_key, priority_queue_serialize_fn *pfn_serialize );
+
+/** !
+ * Read a length prefixed record from a stream, and deserialize it
+ * 
+ * @param p_stream        the stream
+ * @param pp_key          return
+ * @param pfn_deserialize pointer to a function that deserializes a key, or 0 to read the key by value
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_stream_read_key ( struct priority_queue_stream_s *const p_stream, void **pp_key, priority_queue_deserialize_fn *pfn_deserialize );
+
+/** !
+ * Create an unlinked temporary file for a run of an external priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_run            return
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_external_open ( priority_queue *const p_priority_queue, struct priority_queue_run_s *const p_run );
+
+/** !
+ * Close a run of an external priority queue, and release its buffers
+ * 
+ * @param p_run the run
+ * 
+ * @return void
+ */
+void priority_queue_external_close ( struct priority_queue_run_s *const p_run );
+
+/** !
+ * Seek to the start of a written run, and read its first key
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_run            the run
+ * @param count            the quantity of keys in the run
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_external_rewind ( priority_queue *const p_priority_queue, struct priority_queue_run_s *const p_run, size_t count );
+
+/** !
+ * Remove the front key of the runs of an external priority queue, and refill the head 
+ * of its run
+ * 
+ * @param p_priority_queue the priority queue
+ * @param pp_key           return
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_external_pop ( priority_queue *const p_priority_queue, void **pp_key );
+
+/** !
+ * Make room for another run of an external priority queue. Exhausted runs are closed.
+ * Else, the runs of the lowest levels are merged into one run of the next level, so
+ * each key is rewritten once per level, instead of once per merge
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_external_merge ( priority_queue *const p_priority_queue );
+
+/** !
+ * Sort the heap of an external priority queue, write it to a new run, and empty the heap
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+int priority_queue_external_spill ( priority_queue *const p_priority_queue );
+#endif
+
+/** !
+ * Find the slot of a key in the tombstone table of a priority queue
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * 
+ * @return the index of the slot holding the key, or of the empty slot where it belongs
+ */
+static inline size_t priority_queue_tombstone_slot ( const priority_queue *const p_priority_queue, const void *const p_key )
+{
+
+    // Initialized data
+    size_t mask = p_priority_queue->tombstones.capacity - 1,
+           i    = PRIORITY_QUEUE_TOMBSTONE_HASH(p_key) & mask;
+
+    // Probe until the key, or an empty slot
+    while ( p_priority_queue->tombstones.p_slots[i].count && p_priority_queue->tombstones.p_slots[i].p_key != p_key ) i = ( i + 1 ) & mask;
+
+    // Success
+    return i;
+}
+
+/** !
+ * Mark one copy of a key as dead. The table doubles when it is half full
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * 
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_tombstone_add ( priority_queue *const p_priority_queue, void *p_key )
+{
+
+    // Initialized data
+    size_t i = 0;
+
+    // Grow the table
+    if ( 2 * ( p_priority_queue->tombstones.used + 1 ) > p_priority_queue->tombstones.capacity )
+    {
+
+        // Initialized data
+        struct priority_queue_tombstone_s *p_old    = p_priority_queue->tombstones.p_slots;
+        size_t                             capacity = p_priority_queue->tombstones.capacity,
+                                           larger   = capacity ? 2 * capacity : 16;
+        struct priority_queue_tombstone_s *p_new    = PRIORITY_QUEUE_REALLOC(0, larger * sizeof(struct priority_queue_tombstone_s));
+
+        // Error checking
+        if ( p_new == (void *) 0 ) return 0;
+
+        // Move the tombstones to the new table
+        memset(p_new, 0, larger * sizeof(struct priority_queue_tombstone_s));
+        p_priority_queue->tombstones.p_slots  = p_new;
+        p_priority_queue->tombstones.capacity = larger;
+        for (size_t j = 0; j < capacity; j++)
+            if ( p_old[j].count ) p_new[priority_queue_tombstone_slot(p_priority_queue, p_old[j].p_key)] = p_old[j];
+
+        // Free the old table
+        if ( p_old ) PRIORITY_QUEUE_REALLOC(p_old, 0);
+    }
+
+    // Find the slot of the key
+    i = priority_queue_tombstone_slot(p_priority_queue, p_key);
+
+    // Count a new key
+    if ( p_priority_queue->tombstones.p_slots[i].count == 0 ) p_priority_queue->tombstones.used++;
+
+    // Mark the copy as dead
+    p_priority_queue->tombstones.p_slots[i].p_key = p_key;
+    p_priority_queue->tombstones.p_slots[i].count++;
+    p_priority_queue->tombstones.count++;
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Consume the tombstone of a key, if it has one
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_key            the key
+ * 
+ * @return true if the key was dead, else false
+ */
+static bool priority_queue_tombstone_take ( priority_queue *const p_priority_queue, const void *const p_key )
+{
+
+    // Initialized data
+    struct priority_queue_tombstone_s *p_slots = p_priority_queue->tombstones.p_slots;
+    size_t                             mask    = p_priority_queue->tombstones.capacity - 1,
+                                       i       = 0,
+                                       j       = 0;
+
+    // Fast exit
+    if ( p_priority_queue->tombstones.count == 0 ) return false;
+
+    // Find the key
+    i = priority_queue_tombstone_slot(p_priority_queue, p_key);
+
+    // The key is alive
+    if ( p_slots[i].count == 0 ) return false;
+
+    // Consume one tombstone
+    p_priority_queue->tombstones.count--;
+    if ( --p_slots[i].count ) return true;
+    p_priority_queue->tombstones.used--;
+
+    // Shift later keys of the probe sequence back into the hole
+    for (j = ( i + 1 ) & mask; p_slots[j].count; j = ( j + 1 ) & mask)
+    {
+
+        // Initialized data
+        size_t home = PRIORITY_QUEUE_TOMBSTONE_HASH(p_slots[j].p_key) & mask;
+
+        // Move the key, unless its home is between the hole and the key
+        if ( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) ) p_slots[i] = p_slots[j], p_slots[j].count = 0, i = j;
+    }
+
+    // Success
+    return true;
+}
+
+/** !
+ * Stop sharing the entries of a priority queue with its snapshot, and drop the 
+ * reference of the priority queue. The snapshot is never touched through the 
+ * priority queue after, so releasing the last reference is safe on any thread. The 
+ * caller holds the lock
+ * 
+ * @param p_priority_queue the priority queue
+ * @param p_allocation     the entries left to the snapshot, or 0 if the priority queue keeps them
+ * 
+ * @return void
+ */
+static void priority_queue_snapshot_detach ( priority_queue *const p_priority_queue, void *p_allocation )
+{
+
+    // Initialized data
+    struct priority_queue_snapshot_s *p_snapshot = p_priority_queue->p_snapshot;
+
+    // Leave the entries to the snapshot, before dropping the reference that publishes them
+    p_snapshot->p_allocation     = p_allocation;
+    p_priority_queue->p_snapshot = (void *) 0;
+
+    // The last reference frees the snapshot, and any entries left to it
+    if ( atomic_fetch_sub_explicit(&p_snapshot->references, 1, memory_order_acq_rel) == 1 )
+    {
+        if ( p_snapshot->p_allocation ) PRIORITY_QUEUE_REALLOC(p_snapshot->p_allocation, 0);
+        PRIORITY_QUEUE_REALLOC(p_snapshot, 0);
+    }
+
+    // Done
+    return;
+}
+
+/** !
+ * Give the entries of a priority queue to the snapshot sharing them, and copy them
+ * into new entries for the priority queue. Call before modifying the entries of a 
+ * shared priority queue. The caller holds the lock
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_unshare ( priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    size_t    slots        = p_priority_queue->entries.max;
+    void     *p_allocation = (void *) 0;
+    void    **data         = (void *) 0;
+
+    // No caller holds the snapshot, so the priority queue keeps its entries. Only a
+    // caller holding the lock adds a reference, so none can be added meanwhile
+    if ( atomic_load_explicit(&p_priority_queue->p_snapshot->references, memory_order_acquire) == 1 )
+    {
+        priority_queue_snapshot_detach(p_priority_queue, (void *) 0);
+
+        // Success
+        return 1;
+    }
+
+    // Allocate the entries of a blocked heap, and an extra page for alignment ...
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED )
+    {
+        slots        = priority_queue_physical(p_priority_queue, slots - 1) + 1;
+        p_allocation = PRIORITY_QUEUE_REALLOC(0, slots * sizeof(void *) + PRIORITY_QUEUE_PAGE_SIZE);
+        data         = (void **) ( ( (uintptr_t) p_allocation + PRIORITY_QUEUE_PAGE_SIZE - 1 ) & ~(uintptr_t) ( PRIORITY_QUEUE_PAGE_SIZE - 1 ) );
+    }
+
+    // ... or of a binary heap
+    else
+        data = p_allocation = PRIORITY_QUEUE_REALLOC(0, slots * sizeof(void *));
+
+    // Error checking
+    if ( p_allocation == (void *) 0 ) return 0;
+
+    // Copy the entries
+    memcpy(data, p_priority_queue->entries.data, slots * sizeof(void *));
+
+    // Leave the shared entries to the snapshot
+    priority_queue_snapshot_detach(p_priority_queue, p_priority_queue->entries.p_allocation ? p_priority_queue->entries.p_allocation : (void *) p_priority_queue->entries.data);
+
+    // Keep the copy
+    p_priority_queue->entries.data         = data;
+    p_priority_queue->entries.p_allocation = ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED ) ? p_allocation : (void *) 0;
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Rebuild the heap of a priority queue from the bottom up, after its keys or their 
+ * priorities changed. The caller holds the lock
+ * 
+ * @param p_priority_queue the priority queue, with a binary or blocked heap
+ * @param threads          the quantity of threads for binary heaps of keys, or 0 for one per processor
+ * 
+ * @return void
+ */
+static void priority_queue_rebuild ( priority_queue *const p_priority_queue, size_t threads )
+{
+
+    // Initialized data
+    size_t count = p_priority_queue->entries.count;
+
+    // Typed heaps sift keys with their priorities
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+        for (size_t i = count; i-- > 0; ) priority_queue_typed_sift_down(p_priority_queue, i, count);
+
+    // Binary heaps of keys may be built in parallel ...
+    else if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BINARY )
+        priority_queue_build_max_heap_parallel(p_priority_queue, threads);
+
+    // ... and blocked heaps are sifted in their physical slots
+    else
+        for (size_t i = count; i-- > 0; ) priority_queue_heapify(p_priority_queue, priority_queue_physical(p_priority_queue, i));
+
+    // Done
+    return;
+}
+
+/** !
+ * Apply a reprioritize callback to a range of the keys of a priority queue
+ * 
+ * @param p_parameter pointer to a struct priority_queue_reprioritize_task_s
+ * 
+ * @return 0
+ */
+static void *priority_queue_reprioritize_worker ( void *p_parameter )
+{
+
+    // Initialized data
+    struct priority_queue_reprioritize_task_s *p_task           = p_parameter;
+    priority_queue                            *p_priority_queue = p_task->p_priority_queue;
+    bool                                       typed            = ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR ),
+                                               compact          = ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX );
+    uint64_t                                   bias             = p_priority_queue->aging.bias;
+
+    // Visit each key of the range
+    for (size_t i = p_task->lo; i < p_task->hi; i++)
+    {
+
+        // Initialized data
+        size_t                  slot     = priority_queue_physical(p_priority_queue, i);
+        priority_queue_priority priority = { 0 };
+
+        // Comparator heaps only replace the key
+        if ( typed == false )
+        {
+            p_priority_queue->entries.data[slot] = p_task->pfn_reprioritize(p_priority_queue->entries.data[slot], (void *) 0, p_task->p_context);
+            continue;
+        }
+
+        // Compact heaps unpack the index and its priority, and pack the replacements
+        if ( compact )
+        {
+
+            // Initialized data
+            uint64_t *p_entries = p_priority_queue->typed.p_priorities;
+            void     *p_key     = (void *) (uintptr_t) PRIORITY_QUEUE_COMPACT_INDEX(p_entries[slot]);
+
+            // Replace the index and its priority
+            priority.u32    = (uint32_t) ( p_entries[slot] >> 32 );
+            p_key           = p_task->pfn_reprioritize(p_key, &priority, p_task->p_context);
+            p_entries[slot] = PRIORITY_QUEUE_COMPACT_ENTRY(priority.u32, (uintptr_t) p_key);
+            continue;
+        }
+
+        // Load the priority, without the bias of aging
+        priority = priority_queue_typed_load(p_priority_queue, slot);
+        if ( bias ) priority.u64 = ( priority.u64 > bias ) ? priority.u64 - bias : 0;
+
+        // Replace the key and its priority
+        p_priority_queue->entries.data[slot] = p_task->pfn_reprioritize(p_priority_queue->entries.data[slot], &priority, p_task->p_context);
+
+        // Store the priority, with the bias of aging
+        if ( bias ) priority.u64 = ( priority.u64 > UINT64_MAX - bias ) ? UINT64_MAX : priority.u64 + bias;
+        priority_queue_typed_store(p_priority_queue, slot, priority);
+    }
+
+    // Done
+    return (void *) 0;
+}
+
+/** !
+ * Add a key to the heap of a tenant of a fair queue. The caller holds the lock, and 
+ * checks for overflow
+ * 
+ * @param p_fair   the fair queue
+ * @param p_tenant the tenant
+ * @param p_key    the key
+ * @param cost     the cost of the key over the weight of the tenant
+ * 
+ * @return void
+ */
+static void priority_queue_fair_push ( priority_queue_fair *const p_fair, struct priority_queue_fair_tenant_s *const p_tenant, void *p_key, uint64_t cost )
+{
+
+    // Initialized data
+    struct priority_queue_fair_entry_s *p_entries = p_tenant->p_entries;
+    size_t                              i         = p_tenant->count++;
+
+    // Move the hole up until the key fits
+    while ( i > 0 )
+    {
+
+        // Initialized data
+        size_t parent = ( i - 1 ) / 2;
+
+        // Stop when the heap property holds
+        if ( p_fair->pfn_compare_function(p_entries[parent].p_key, p_key) >= 0 ) break;
+
+        // Move the parent into the hole
+        p_entries[i] = p_entries[parent];
+
+        // Continue from the parent
+        i = parent;
+    }
+
+    // Fill the hole
+    p_entries[i] = (struct priority_queue_fair_entry_s) { .p_key = p_key, .cost = cost };
+
+    // Done
+    return;
+}
+
+/** !
+ * Remove the highest priority key from the heap of a tenant of a fair queue. The 
+ * caller holds the lock, and checks for underflow
+ * 
+ * @param p_fair   the fair queue
+ * @param p_tenant the tenant
+ * @param p_entry  return
+ * 
+ * @return void
+ */
+static void priority_queue_fair_pop ( priority_queue_fair *const p_fair, struct priority_queue_fair_tenant_s *const p_tenant, struct priority_queue_fair_entry_s *p_entry )
+{
+
+    // Initialized data
+    struct priority_queue_fair_entry_s *p_entries = p_tenant->p_entries;
+    struct priority_queue_fair_entry_s  last      = p_entries[--p_tenant->count];
+    size_t                              count     = p_tenant->count,
+                                        i         = 0;
+
+    // Return the root to the caller
+    *p_entry = p_entries[0];
+
+    // Move the hole down until the last key fits
+    while ( 2 * i + 1 < count )
+    {
+
+        // Initialized data
+        size_t child = 2 * i + 1;
+
+        // Choose the higher priority child
+        if ( child + 1 < count && p_fair->pfn_compare_function(p_entries[child + 1].p_key, p_entries[child].p_key) > 0 ) child++;
+
+        // Stop when the heap property holds
+        if ( p_fair->pfn_compare_function(last.p_key, p_entries[child].p_key) >= 0 ) break;
+
+        // Move the child into the hole
+        p_entries[i] = p_entries[child];
+
+        // Continue from the child
+        i = child;
+    }
+
+    // Fill the hole
+    if ( count ) p_entries[i] = last;
+
+    // Done
+    return;
+}
+
+/** !
+ * Add a tenant with keys to the backlog of a fair queue, by the finish time of the 
+ * key at its front. The caller holds the lock
+ * 
+ * @param p_fair the fair queue
+ * @param tenant the tenant
+ * 
+ * @return void
+ */
+static void priority_queue_fair_backlog ( priority_queue_fair *const p_fair, size_t tenant )
+{
+
+    // Initialized data
+    struct priority_queue_fair_tenant_s *p_tenant = &p_fair->p_tenants[tenant];
+
+    // The front key starts at the later of now and the finish of the last key of the tenant
+    p_tenant->start = ( p_tenant->last > p_fair->virtual_time ) ? p_tenant->last : p_fair->virtual_time;
+
+    // Wait for the front key to finish. The backlog holds every tenant, so it can not overflow
+    priority_queue_enqueue_priority(p_fair->p_backlog, (void *) ( tenant + 1 ), (priority_queue_priority) { .u64 = p_tenant->start + p_tenant->p_entries[0].cost });
+
+    // Done
+    return;
+}
+
+#ifndef _WIN64
+/** !
+ * Move every key of a delay queue that is ready into the priority queue of ready 
+ * keys. The caller holds the lock
+ * 
+ * @param p_delay the delay queue
+ * @param now     the time
+ * 
+ * @return void
+ */
+static void priority_queue_delay_promote ( priority_queue_delay *const p_delay, timestamp now )
+{
+
+    // Initialized data
+    priority_queue *p_delayed = p_delay->p_delayed;
+    void           *p_key     = (void *) 0;
+
+    // Move each key with a ready time that passed
+    while ( p_delayed->entries.count && priority_queue_typed_load(p_delayed, 0).u64 <= (uint64_t) now )
+    {
+        priority_queue_dequeue(p_delayed, &p_key);
+        priority_queue_enqueue(p_delay->p_eligible, p_key);
+    }
+
+    // Done
+    return;
+}
+#endif
+
+/** !
+ * Remove every dead key, and rebuild the heap. The caller holds the lock
+ * 
+ * @param p_priority_queue the priority queue
+ * 
+ * @return void
+ */
+static void priority_queue_compact ( priority_queue *const p_priority_queue )
+{
+
+    // Copy the entries shared with a snapshot, or leave the dead keys in place
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) return;
+
+    // Initialized data
+    void   **data  = p_priority_queue->entries.data;
+    size_t   count = 0;
+
+    // Compact heaps keep the entries of live indices ...
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX )
+    {
+
+        // Initialized data
+        uint64_t *p_entries = (uint64_t *) p_priority_queue->typed.p_priorities;
+
+        // Keep the entry
+        for (size_t i = 0; i < p_priority_queue->entries.count; i++)
+            if ( priority_queue_tombstone_take(p_priority_queue, (void *) (uintptr_t) PRIORITY_QUEUE_COMPACT_INDEX(p_entries[i])) == false ) p_entries[count++] = p_entries[i];
+
+        // Pad the emptied slots
+        #ifdef PRIORITY_QUEUE_PADDING
+            for (size_t i = count; i < p_priority_queue->entries.count; i++) p_entries[i] = UINT64_MAX;
+        #endif
+    }
+
+    // ... and other heaps keep the live keys
+    else
+    {
+
+        // Keep the key
+        for (size_t i = 0; i < p_priority_queue->entries.count; i++)
+        {
+
+            // Initialized data
+            void *p_key = data[priority_queue_physical(p_priority_queue, i)];
+
+            // Keep the key
+            if ( priority_queue_tombstone_take(p_priority_queue, p_key) == false ) data[priority_queue_physical(p_priority_queue, count++)] = p_key;
+        }
+
+        // Clear the emptied slots
+        for (size_t i = count; i < p_priority_queue->entries.count; i++) data[priority_queue_physical(p_priority_queue, i)] = (void *) 0;
+    }
+
+    // Store the quantity of live keys
+    p_priority_queue->entries.count = count;
+
+    // Forget tombstones of keys that were not in the priority queue
+    if ( p_priority_queue->tombstones.used ) memset(p_priority_queue->tombstones.p_slots, 0, p_priority_queue->tombstones.capacity * sizeof(struct priority_queue_tombstone_s));
+    p_priority_queue->tombstones.used  = 0;
+    p_priority_queue->tombstones.count = 0;
+
+    // Rebuild the heap
+    priority_queue_rebuild(p_priority_queue, 1);
+
+    // Done
+    return;
+}
+
+int priority_queue_create ( priority_queue **const pp_priority_queue )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Allocate memory for a priority queue
+    priority_queue *p_priority_queue = PRIORITY_QUEUE_REALLOC(0, sizeof(priority_queue));
+
+    // Error checking
+    if ( p_priority_queue == (void *) 0 ) goto no_mem;
+
+    // Zero set
+    memset(p_priority_queue, 0, sizeof(priority_queue));
+
+    // Return the allocated memory
+    *pp_priority_queue = p_priority_queue;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    printf("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_construct ( priority_queue **const pp_priority_queue, size_t size, priority_queue_equal_fn pfn_compare_function )
+{
+
+    // Construct a binary heap
+    return priority_queue_construct_with_layout(pp_priority_queue, size, pfn_compare_function, PRIORITY_QUEUE_LAYOUT_BINARY);
+}
+
+int priority_queue_construct_with_layout ( priority_queue **const pp_priority_queue, size_t size, priority_queue_equal_fn pfn_compare_function, priority_queue_layout layout )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( size              ==          0 ) goto zero_size;
+    if ( layout            >  PRIORITY_QUEUE_LAYOUT_SEQUENCE ) goto invalid_layout;
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    size_t          slots            = size;
+
+    // Allocate a priority queue
+    if ( priority_queue_create(pp_priority_queue) == 0 ) goto failed_to_create_priority_queue;
+
+    // Get a pointer to the allocated priority queue
+    p_priority_queue = *pp_priority_queue;
+
+    // Set the count, iterator max, and layout
+    p_priority_queue->entries.max = size;
+    p_priority_queue->layout      = layout;
+
+    // The entries of a sequence heap are its insertion heap
+    if ( layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE )
+    {
+
+        // Store the capacity of the priority queue
+        p_priority_queue->sequence.max = size;
+
+        // Limit the insertion heap to the cache
+        if ( size > PRIORITY_QUEUE_SEQUENCE_INSERTION ) slots = p_priority_queue->entries.max = PRIORITY_QUEUE_SEQUENCE_INSERTION;
+    }
+
+    // Binary layouts
+    if ( layout != PRIORITY_QUEUE_LAYOUT_BLOCKED )
+    {
+
+        // Allocate "size" number of properties
+        p_priority_queue->entries.data = PRIORITY_QUEUE_REALLOC(0, slots * sizeof(void *));
+
+        // Error checking
+        if ( p_priority_queue->entries.data == (void *) 0 ) goto no_mem;
+    }
+
+    // Blocked layout
+    else
+    {
+
+        // Count the slots, including one unused slot per block
+        slots = priority_queue_physical(p_priority_queue, size - 1) + 1;
+
+        // Allocate the slots, and an extra page for alignment
+        p_priority_queue->entries.p_allocation = PRIORITY_QUEUE_REALLOC(0, slots * sizeof(void *) + PRIORITY_QUEUE_PAGE_SIZE);
+
+        // Error checking
+        if ( p_priority_queue->entries.p_allocation == (void *) 0 ) goto no_mem;
+
+        // Align the blocks to pages
+        p_priority_queue->entries.data = (void **) ( ( (uintptr_t) p_priority_queue->entries.p_allocation + PRIORITY_QUEUE_PAGE_SIZE - 1 ) & ~(uintptr_t) ( PRIORITY_QUEUE_PAGE_SIZE - 1 ) );
+    }
+
+    // Zero set the allocated memory
+    memset(p_priority_queue->entries.data, 0, slots * sizeof(void *));
+
+    // Create a mutex
+    if ( mutex_create(&p_priority_queue->_lock) == 0 ) goto failed_to_create_mutex;
+
+    // Set the comparator function
+    // TODO: Improve documentation
+    if ( pfn_compare_function == (void *) 0 )
+        p_priority_queue->pfn_compare_function = priority_queue_compare_function;
+    else
+        p_priority_queue->pfn_compare_function = pfn_compare_function;
+
+    // Binary heaps may take the inline fast path
+    p_priority_queue->inline_path = ( layout == PRIORITY_QUEUE_LAYOUT_BINARY ) && PRIORITY_QUEUE_INLINE_PATH;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Zero provided for parameter \"size\"", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_layout:
+                #ifndef NDEBUG
+                    priority_queue_error("Invalid value provided for parameter \"layout\"", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+        }
+
+        // Priority queue errors
+        {
+            failed_to_create_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to create priority queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_create_mutex:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to create mutex", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_construct_typed ( priority_queue **const pp_priority_queue, size_t size, priority_queue_priority_type type, size_t arity, priority_queue_priority_fn pfn_priority )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( type              == PRIORITY_QUEUE_PRIORITY_COMPARATOR || type == PRIORITY_QUEUE_PRIORITY_LEVEL || type > PRIORITY_QUEUE_PRIORITY_INDEX ) goto invalid_type;
+    if ( arity != 2 && arity != 4 && arity != 8 ) goto invalid_arity;
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    size_t          width            = ( type == PRIORITY_QUEUE_PRIORITY_U64 || type == PRIORITY_QUEUE_PRIORITY_INDEX ) ? sizeof(uint64_t) : sizeof(uint32_t);
+
+    // Construct a binary heap for the keys
+    if ( priority_queue_construct_with_layout(pp_priority_queue, size, (void *) 0, PRIORITY_QUEUE_LAYOUT_BINARY) == 0 ) goto failed_to_construct_priority_queue;
+
+    // Get a pointer to the allocated priority queue
+    p_priority_queue = *pp_priority_queue;
+
+    // Compact heaps store no keys
+    if ( type == PRIORITY_QUEUE_PRIORITY_INDEX ) p_priority_queue->entries.data = PRIORITY_QUEUE_REALLOC(p_priority_queue->entries.data, 0);
+
+    // Allocate the priorities, the padding, and a cache line for alignment
+    p_priority_queue->typed.p_allocation = PRIORITY_QUEUE_REALLOC(0, ( size + PRIORITY_QUEUE_PADDING_SLOTS(arity) ) * width + 2 * 64);
+
+    // Error checking
+    if ( p_priority_queue->typed.p_allocation == (void *) 0 ) goto no_mem;
+
+    // Align the priorities, so each group of children starts on a cache line
+    p_priority_queue->typed.p_priorities = (void *) ( ( ( (uintptr_t) p_priority_queue->typed.p_allocation + width + 63 ) & ~(uintptr_t) 63 ) - width );
+
+    // Pad every slot
+    #ifdef PRIORITY_QUEUE_PADDING
+        memset(p_priority_queue->typed.p_priorities, 0xFF, ( size + PRIORITY_QUEUE_PADDING_SLOTS(arity) ) * width);
+    #endif
+
+    // Store the type, the arity, and the priority function
+    p_priority_queue->typed.type           = type;
+    p_priority_queue->typed.arity          = arity;
+    p_priority_queue->typed.width          = width;
+    p_priority_queue->typed.pfn_priority   = pfn_priority;
+    p_priority_queue->typed.pfn_best_child = priority_queue_best_child_kernel(width, arity);
+
+    // Typed heaps take the checked path
+    p_priority_queue->inline_path = false;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_type:
+                #ifndef NDEBUG
+                    priority_queue_error("Invalid value provided for parameter \"type\"", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_arity:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"arity\" must be 2, 4, or 8", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_construct_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_construct_with_layout", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Release the priority queue
+                priority_queue_destroy(pp_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_construct_bucket ( priority_queue **const pp_priority_queue, size_t size, size_t levels, priority_queue_priority_fn pfn_priority )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0                                  ) goto no_priority_queue;
+    if ( levels            == 0 || levels > PRIORITY_QUEUE_BUCKET_LEVELS_MAX ) goto invalid_levels;
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    size_t         *p_links          = 0;
+
+    // Construct an array for the keys
+    if ( priority_queue_construct_with_layout(pp_priority_queue, size, (void *) 0, PRIORITY_QUEUE_LAYOUT_BINARY) == 0 ) goto failed_to_construct_priority_queue;
+
+    // Get a pointer to the allocated priority queue
+    p_priority_queue = *pp_priority_queue;
+
+    // Allocate the links of each slot, the front and back of each level, and the occupied bits
+    p_priority_queue->typed.p_allocation = PRIORITY_QUEUE_REALLOC(0, ( size + 2 * levels ) * sizeof(size_t) + PRIORITY_QUEUE_BUCKET_LEVELS_MAX / 8);
+
+    // Error checking
+    if ( p_priority_queue->typed.p_allocation == (void *) 0 ) goto no_mem;
+
+    // Split the allocation
+    p_links                              = p_priority_queue->typed.p_allocation;
+    p_priority_queue->bucket.p_next      = p_links;
+    p_priority_queue->bucket.p_head      = p_links + size;
+    p_priority_queue->bucket.p_tail      = p_links + size + levels;
+    p_priority_queue->bucket.p_occupied  = (uint64_t *) ( p_links + size + 2 * levels );
+    p_priority_queue->bucket.levels      = levels;
+
+    // Every slot is free, and every level is empty
+    for (size_t i = 0; i < size; i++) p_priority_queue->bucket.p_next[i] = i + 1;
+    if ( size ) p_priority_queue->bucket.p_next[size - 1] = SIZE_MAX;
+    p_priority_queue->bucket.free = size ? 0 : SIZE_MAX;
+    for (size_t i = 0; i < levels; i++) p_priority_queue->bucket.p_head[i] = SIZE_MAX;
+    memset(p_priority_queue->bucket.p_occupied, 0, PRIORITY_QUEUE_BUCKET_LEVELS_MAX / 8);
+
+    // Store the type, and the priority function
+    p_priority_queue->typed.type         = PRIORITY_QUEUE_PRIORITY_LEVEL;
+    p_priority_queue->typed.width        = sizeof(uint32_t);
+    p_priority_queue->typed.pfn_priority = pfn_priority;
+
+    // Bucket queues take the checked path
+    p_priority_queue->inline_path = false;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_levels:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"levels\" must be between 1 and PRIORITY_QUEUE_BUCKET_LEVELS_MAX", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_construct_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_construct_with_layout", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Release the priority queue
+                priority_queue_destroy(pp_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_fair_construct ( priority_queue_fair **const pp_fair, size_t tenants, size_t size, priority_queue_equal_fn pfn_compare_function )
+{
+
+    // Argument check
+    if ( pp_fair == (void *) 0 ) goto no_fair;
+    if ( tenants == 0          ) goto zero_tenants;
+    if ( size    == 0          ) goto zero_size;
+
+    // Initialized data
+    priority_queue_fair *p_fair = PRIORITY_QUEUE_REALLOC(0, sizeof(priority_queue_fair));
+
+    // Error checking
+    if ( p_fair == (void *) 0 ) goto no_mem;
+
+    // Zero set
+    memset(p_fair, 0, sizeof(priority_queue_fair));
+
+    // Store the quantity of tenants, and of keys for each tenant
+    p_fair->tenants = tenants;
+    p_fair->size    = size;
+
+    // Store the compare function
+    p_fair->pfn_compare_function = ( pfn_compare_function ) ? pfn_compare_function : priority_queue_compare_function;
+
+    // Allocate the tenants, and their heaps
+    p_fair->p_tenants = PRIORITY_QUEUE_REALLOC(0, tenants * sizeof(struct priority_queue_fair_tenant_s));
+    p_fair->p_entries = PRIORITY_QUEUE_REALLOC(0, tenants * size * sizeof(struct priority_queue_fair_entry_s));
+
+    // Error checking
+    if ( p_fair->p_tenants == (void *) 0 || p_fair->p_entries == (void *) 0 ) goto failed_to_construct;
+
+    // Zero set
+    memset(p_fair->p_tenants, 0, tenants * sizeof(struct priority_queue_fair_tenant_s));
+
+    // Construct the heap of backlogged tenants
+    if ( priority_queue_construct_typed(&p_fair->p_backlog, tenants, PRIORITY_QUEUE_PRIORITY_U64, PRIORITY_QUEUE_FAIR_ARITY, 0) == 0 ) goto failed_to_construct;
+
+    // Store the heap of each tenant, and a weight of 1
+    for (size_t i = 0; i < tenants; i++)
+    {
+        p_fair->p_tenants[i].p_entries = &p_fair->p_entries[i * size];
+        p_fair->p_tenants[i].weight    = 1;
+    }
+
+    // Create a mutex
+    if ( mutex_create(&p_fair->_lock) == 0 ) goto failed_to_construct;
+
+    // Return a pointer to the caller
+    *pp_fair = p_fair;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_fair:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_fair", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_tenants:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"tenants\" must be greater than 0", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"size\" must be greater than 0", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_construct:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to construct a tenant", __FUNCTION__);
+                #endif
+
+                // Release the fair queue
+                if ( p_fair->p_backlog ) priority_queue_destroy(&p_fair->p_backlog);
+                if ( p_fair->p_tenants ) PRIORITY_QUEUE_REALLOC(p_fair->p_tenants, 0);
+                if ( p_fair->p_entries ) PRIORITY_QUEUE_REALLOC(p_fair->p_entries, 0);
+                PRIORITY_QUEUE_REALLOC(p_fair, 0);
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+#ifndef _WIN64
+int priority_queue_delay_construct ( priority_queue_delay **const pp_delay, size_t size, priority_queue_equal_fn pfn_compare_function )
+{
+
+    // Argument check
+    if ( pp_delay == (void *) 0 ) goto no_delay;
+    if ( size     == 0          ) goto zero_size;
+
+    // Initialized data
+    priority_queue_delay *p_delay  = PRIORITY_QUEUE_REALLOC(0, sizeof(priority_queue_delay));
+    pthread_condattr_t    _attr;
+    bool                  has_lock = false;
+
+    // Error checking
+    if ( p_delay == (void *) 0 ) goto no_mem;
+
+    // Zero set
+    memset(p_delay, 0, sizeof(priority_queue_delay));
+
+    // Store the quantity of keys
+    p_delay->size = size;
+
+    // Construct the heap of delayed keys, and the priority queue of ready keys
+    if ( priority_queue_construct_typed(&p_delay->p_delayed, size, PRIORITY_QUEUE_PRIORITY_U64, PRIORITY_QUEUE_DELAY_ARITY, 0) == 0 ) goto failed_to_construct;
+    if ( priority_queue_construct(&p_delay->p_eligible, size, pfn_compare_function) == 0 ) goto failed_to_construct;
+
+    // Create the lock, and a condition variable on the monotonic clock
+    if ( pthread_mutex_init(&p_delay->_lock, (void *) 0) ) goto failed_to_construct;
+    has_lock = true;
+    pthread_condattr_init(&_attr);
+    pthread_condattr_setclock(&_attr, CLOCK_MONOTONIC);
+    if ( pthread_cond_init(&p_delay->changed, &_attr) ) goto failed_to_construct;
+    pthread_condattr_destroy(&_attr);
+
+    // Return a pointer to the caller
+    *pp_delay = p_delay;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_delay:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_delay", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"size\" must be greater than 0", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_construct:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to construct a delay queue", __FUNCTION__);
+                #endif
+
+                // Release the delay queue
+                if ( has_lock ) pthread_condattr_destroy(&_attr), pthread_mutex_destroy(&p_delay->_lock);
+                if ( p_delay->p_delayed  ) priority_queue_destroy(&p_delay->p_delayed);
+                if ( p_delay->p_eligible ) priority_queue_destroy(&p_delay->p_eligible);
+                PRIORITY_QUEUE_REALLOC(p_delay, 0);
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+#endif
+
+int priority_queue_from_keys ( const priority_queue **const pp_priority_queue, const char **const keys, size_t size, priority_queue_equal_fn pfn_compare_function )
+{
+
+    // Build the heap with one thread per processor
+    return priority_queue_from_keys_parallel(pp_priority_queue, keys, size, pfn_compare_function, 0);
+}
+
+int priority_queue_from_keys_parallel ( const priority_queue **const pp_priority_queue, const char **const keys, size_t size, priority_queue_equal_fn pfn_compare_function, size_t threads )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( keys              == (void *) 0 ) goto no_keys;
+    if ( size              ==          0 ) goto zero_size;
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    size_t          count            = 0;
+
+    // Allocate a priority queue
+    if ( priority_queue_construct(&p_priority_queue, size, pfn_compare_function) == 0 ) goto failed_to_construct_priority_queue;
+
+    // Copy each key, stopping early at a null key
+    for (; count < size && keys[count]; count++)
+        p_priority_queue->entries.data[count] = (void *) keys[count];
+
+    // Store the quantity of keys
+    p_priority_queue->entries.count = count;
+
+    // Build the priority queue
+    if ( priority_queue_build_max_heap_parallel(p_priority_queue, threads) == 0 ) goto failed_to_build_max_heap;
+
+    // Return
+    *pp_priority_queue = p_priority_queue;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_keys:
+                #ifndef NDEBUG
+                    priority_queue_error_null("keys", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Zero provided for parameter \"size\"", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // priority queue errors
+        {
+            failed_to_construct_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_construct", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_build_max_heap:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_build_max_heap_parallel", __FUNCTION__);
+                #endif
+
+                // Free the priority queue
+                priority_queue_destroy(&p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+#ifndef _WIN64
+uint64_t priority_queue_mapped_checksum ( const struct priority_queue_mapped_header_s *const p_header )
+{
+
+    // Initialized data
+    const unsigned char *p_bytes = (const unsigned char *) p_header;
+    uint64_t             hash    = 0xcbf29ce484222325ULL;
+
+    // Hash each byte up to the checksum
+    for (size_t i = 0; i < offsetof(struct priority_queue_mapped_header_s, checksum); i++)
+    {
+
+        // Mix in the byte
+        hash ^= p_bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    // Success
+    return hash;
+}
+
+int priority_queue_construct_mapped ( priority_queue **const pp_priority_queue, const char *const path, size_t size, priority_queue_equal_fn pfn_compare_function )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( path              == (void *) 0 ) goto no_path;
+
+    // Initialized data
+    priority_queue                        *p_priority_queue = 0;
+    struct priority_queue_mapped_header_s *p_header         = 0,
+                                          *p_candidate      = 0;
+    struct stat                            _stat            = { 0 };
+    size_t                                 page_size        = (size_t) sysconf(_SC_PAGESIZE),
+                                           region_size      = 0,
+                                           length           = 0;
+    void                                  *p_base           = (void *) 0,
+                                          *p_live           = (void *) 0;
+    int                                    fd               = open(path, O_RDWR | O_CREAT, 0644);
+
+    // Error checking
+    if ( fd                  == -1 ) goto failed_to_open_file;
+    if ( fstat(fd, &_stat)   == -1 ) goto failed_to_stat_file;
+
+    // If the file is empty ...
+    if ( _stat.st_size == 0 )
+    {
+
+        // ... it must be created with a nonzero size
+        if ( size == 0 ) goto zero_size;
+
+        // Compute the size of the file
+        region_size = ( ( size * sizeof(void *) + page_size - 1 ) / page_size ) * page_size;
+        length      = 2 * page_size + 2 * region_size;
+
+        // Grow the file
+        if ( ftruncate(fd, (off_t) length) == -1 ) goto failed_to_resize_file;
+
+        // Map the file
+        p_base = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        // Error checking
+        if ( p_base == MAP_FAILED ) goto failed_to_map_file;
+
+        // Write the first header
+        p_header  = (struct priority_queue_mapped_header_s *) p_base;
+        *p_header = (struct priority_queue_mapped_header_s)
+        {
+            .magic    = PRIORITY_QUEUE_MAPPED_MAGIC,
+            .version  = PRIORITY_QUEUE_MAPPED_VERSION,
+            .key_size = sizeof(void *),
+            .sequence = 1,
+            .max      = size,
+            .count    = 0,
+            .region   = 0
+        };
+        p_header->checksum = priority_queue_mapped_checksum(p_header);
+
+        // Flush the header and the new file size
+        if ( msync(p_base, page_size, MS_SYNC) == -1 ) goto failed_to_flush_file;
+        if ( fsync(fd)                         == -1 ) goto failed_to_flush_file;
+    }
+
+    // Otherwise, the file must hold a priority queue
+    else
+    {
+
+        // Check the file is large enough for both headers
+        if ( (size_t) _stat.st_size < 2 * page_size ) goto invalid_file;
+
+        // Map the file
+        length = (size_t) _stat.st_size;
+        p_base = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        // Error checking
+        if ( p_base == MAP_FAILED ) goto failed_to_map_file;
+
+        // Iterate over each header slot
+        for (size_t i = 0; i < 2; i++)
+        {
+
+            // Get the header in this slot
+            p_candidate = (struct priority_queue_mapped_header_s *) ( (char *) p_base + i * page_size );
+
+            // Skip torn or foreign headers
+            if ( p_candidate->magic    != PRIORITY_QUEUE_MAPPED_MAGIC                 ) continue;
+            if ( p_candidate->version  != PRIORITY_QUEUE_MAPPED_VERSION               ) continue;
+            if ( p_candidate->key_size != sizeof(void *)                              ) continue;
+            if ( p_candidate->checksum != priority_queue_mapped_checksum(p_candidate) ) continue;
+            if ( p_candidate->region    > 1                                           ) continue;
+            if ( p_candidate->count     > p_candidate->max                            ) continue;
+
+            // Keep the most recent commit
+            if ( p_header == (void *) 0 || p_candidate->sequence > p_header->sequence ) p_header = p_candidate;
+        }
+
+        // Error checking
+        if ( p_header == (void *) 0 ) goto invalid_file;
+
+        // Compute the size of each region
+        region_size = ( ( p_header->max * sizeof(void *) + page_size - 1 ) / page_size ) * page_size;
+
+        // Check the file is large enough for both regions
+        if ( length < 2 * page_size + 2 * region_size ) goto invalid_file;
+    }
+
+    // Privately map the committed region. Until the next checkpoint, changes stay in memory
+    p_live = mmap(0, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) ( 2 * page_size + p_header->region * region_size ) );
+
+    // Error checking
+    if ( p_live == MAP_FAILED ) goto failed_to_map_file;
+
+    // Allocate a priority queue
+    if ( priority_queue_create(&p_priority_queue) == 0 ) goto failed_to_create_priority_queue;
+
+    // Populate the priority queue
+    p_priority_queue->entries.data         = (void **) p_live;
+    p_priority_queue->entries.max          = (size_t) p_header->max;
+    p_priority_queue->entries.count        = (size_t) p_header->count;
+    p_priority_queue->mapped.p_base        = p_base;
+    p_priority_queue->mapped.length        = length;
+    p_priority_queue->mapped.page_size     = page_size;
+    p_priority_queue->mapped.region_size   = region_size;
+    p_priority_queue->mapped.sequence      = p_header->sequence;
+    p_priority_queue->mapped.region        = p_header->region;
+    p_priority_queue->mapped.slot          = (uint64_t) ( ( (char *) p_header - (char *) p_base ) / page_size );
+    p_priority_queue->mapped.fd            = fd;
+
+    // Create a mutex
+    if ( mutex_create(&p_priority_queue->_lock) == 0 ) goto failed_to_create_mutex;
+
+    // Set the comparator function
+    if ( pfn_compare_function == (void *) 0 )
+        p_priority_queue->pfn_compare_function = priority_queue_compare_function;
+    else
+        p_priority_queue->pfn_compare_function = pfn_compare_function;
+
+    // Memory mapped heaps are binary heaps, and may take the inline fast path
+    p_priority_queue->inline_path = PRIORITY_QUEUE_INLINE_PATH;
+
+    // Return a pointer to the caller
+    *pp_priority_queue = p_priority_queue;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_path:
+                #ifndef NDEBUG
+                    priority_queue_error_null("path", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Zero provided for parameter \"size\"", __FUNCTION__);
+                #endif
+
+                // Clean up
+                close(fd);
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            invalid_file:
+                #ifndef NDEBUG
+                    priority_queue_error("File does not contain a valid priority queue", __FUNCTION__);
+                #endif
+
+                // Clean up
+                if ( p_base ) munmap(p_base, length);
+                close(fd);
+
+                // Error
+                return 0;
+
+            failed_to_create_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to create priority queue", __FUNCTION__);
+                #endif
+
+                // Clean up
+                munmap(p_live, region_size);
+                munmap(p_base, length);
+                close(fd);
+
+                // Error
+                return 0;
+
+            failed_to_create_mutex:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to create mutex", __FUNCTION__);
+                #endif
+
+                // Clean up
+                munmap(p_live, region_size);
+                munmap(p_base, length);
+                close(fd);
+                PRIORITY_QUEUE_REALLOC(p_priority_queue, 0);
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            failed_to_open_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to open file", path, __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_stat_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to stat file", path, __FUNCTION__);
+                #endif
+
+                // Clean up
+                close(fd);
+
+                // Error
+                return 0;
+
+            failed_to_resize_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to resize file", path, __FUNCTION__);
+                #endif
+
+                // Clean up
+                close(fd);
+
+                // Error
+                return 0;
+
+            failed_to_map_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to map file", path, __FUNCTION__);
+                #endif
+
+                // Clean up
+                if ( p_base != MAP_FAILED && p_base != (void *) 0 ) munmap(p_base, length);
+                close(fd);
+
+                // Error
+                return 0;
+
+            failed_to_flush_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to flush file", path, __FUNCTION__);
+                #endif
+
+                // Clean up
+                munmap(p_base, length);
+                close(fd);
+
+                // Error
+                return 0;
+        }
+    }
+}
+#endif
+
+#ifndef _WIN64
+int priority_queue_stream_flush ( struct priority_queue_stream_s *const p_stream )
+{
+
+    // Initialized data
+    size_t written = 0;
+
+    // Write until the buffer is empty
+    while ( written < p_stream->length )
+    {
+
+        // Write as much as possible
+        ssize_t result = write(p_stream->fd, p_stream->p_buffer + written, p_stream->length - written);
+
+        // Error checking
+        if ( result == -1 ) goto failed_to_write;
+
+        // Advance
+        written += (size_t) result;
+    }
+
+    // Empty the buffer
+    p_stream->length = 0;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Standard library errors
+        {
+            failed_to_write:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to write file descriptor", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stream_write ( struct priority_queue_stream_s *const p_stream, const void *const p_data, size_t size )
+{
+
+    // Initialized data
+    const unsigned char *p_bytes = (const unsigned char *) p_data;
+
+    // Make room in the buffer
+    if ( size > p_stream->capacity - p_stream->length ) 
+        if ( priority_queue_stream_flush(p_stream) == 0 ) goto failed_to_flush;
+
+    // Small writes are buffered
+    if ( size <= p_stream->capacity )
+    {
+
+        // Copy the data into the buffer
+        memcpy(p_stream->p_buffer + p_stream->length, p_bytes, size);
+
+        // Advance
+        p_stream->length += size;
+
+        // Success
+        return 1;
+    }
+
+    // Large writes bypass the buffer
+    while ( size )
+    {
+
+        // Write as much as possible
+        ssize_t result = write(p_stream->fd, p_bytes, size);
+
+        // Error checking
+        if ( result == -1 ) goto failed_to_write;
+
+        // Advance
+        p_bytes += result,
+        size    -= (size_t) result;
+    }
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_flush:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_flush", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            failed_to_write:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to write file descriptor", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stream_fill ( struct priority_queue_stream_s *const p_stream, size_t size )
+{
+
+    // Fast exit
+    if ( p_stream->length - p_stream->offset >= size ) return 1;
+
+    // Move the unread bytes to the front of the buffer
+    memmove(p_stream->p_buffer, p_stream->p_buffer + p_stream->offset, p_stream->length - p_stream->offset);
+    p_stream->length -= p_stream->offset;
+    p_stream->offset  = 0;
+
+    // Read until enough bytes are buffered
+    while ( p_stream->length < size )
+    {
+
+        // Read as much as possible
+        ssize_t result = read(p_stream->fd, p_stream->p_buffer + p_stream->length, p_stream->capacity - p_stream->length);
+
+        // Error checking
+        if ( result == -1 ) goto failed_to_read;
+        if ( result ==  0 ) goto end_of_file;
+
+        // Advance
+        p_stream->length += (size_t) result;
+    }
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Standard library errors
+        {
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to read file descriptor", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            end_of_file:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Unexpected end of file", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stream_read ( struct priority_queue_stream_s *const p_stream, void *const p_data, size_t size )
+{
+
+    // Initialized data
+    unsigned char *p_bytes  = (unsigned char *) p_data;
+    size_t         buffered = p_stream->length - p_stream->offset;
+
+    // Small reads are buffered
+    if ( size <= p_stream->capacity )
+    {
+
+        // Buffer the data
+        if ( priority_queue_stream_fill(p_stream, size) == 0 ) goto failed_to_fill;
+
+        // Copy the data out of the buffer
+        memcpy(p_bytes, p_stream->p_buffer + p_stream->offset, size);
+
+        // Advance
+        p_stream->offset += size;
+
+        // Success
+        return 1;
+    }
+
+    // Drain the buffer
+    memcpy(p_bytes, p_stream->p_buffer + p_stream->offset, buffered);
+    p_stream->offset = p_stream->length = 0;
+    p_bytes         += buffered,
+    size            -= buffered;
+
+    // Large reads bypass the buffer
+    while ( size )
+    {
+
+        // Read as much as possible
+        ssize_t result = read(p_stream->fd, p_bytes, size);
+
+        // Error checking
+        if ( result == -1 ) goto failed_to_read;
+        if ( result ==  0 ) goto end_of_file;
+
+        // Advance
+        p_bytes += result,
+        size    -= (size_t) result;
+    }
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_fill:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_fill", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to read file descriptor", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            end_of_file:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Unexpected end of file", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stream_write_key ( struct priority_queue_stream_s *const p_stream, void *p_key, priority_queue_serialize_fn *pfn_serialize )
+{
+
+    // Initialized data
+    size_t   size   = 0;
+    uint32_t length = 0;
+
+    // Keys without a serializer are written by value
+    if ( pfn_serialize == (void *) 0 )
+    {
+
+        // Write the record
+        length = sizeof(void *);
+        if ( priority_queue_stream_write(p_stream, &length, sizeof(length)) == 0 ) goto failed_to_write;
+        if ( priority_queue_stream_write(p_stream, &p_key , sizeof(p_key))  == 0 ) goto failed_to_write;
+
+        // Success
+        return 1;
+    }
+
+    // Keep room for a length prefix and at least one byte
+    if ( ( p_stream->capacity - p_stream->length ) <= sizeof(length) ) 
+        if ( priority_queue_stream_flush(p_stream) == 0 ) goto failed_to_write;
+
+    // Serialize the key directly into the buffer, after its length prefix
+    size = pfn_serialize(p_stream->p_buffer + p_stream->length + sizeof(length), ( p_stream->capacity - p_stream->length ) - sizeof(length), p_key);
+
+    // If the key did not fit, and the buffer was not empty ...
+    if ( size > ( p_stream->capacity - p_stream->length ) - sizeof(length) && p_stream->length )
+    {
+
+        // ... flush the buffer ...
+        if ( priority_queue_stream_flush(p_stream) == 0 ) goto failed_to_write;
+
+        // ... and try again
+        size = pfn_serialize(p_stream->p_buffer + sizeof(length), p_stream->capacity - sizeof(length), p_key);
+    }
+
+    // Error checking
+    if ( size == 0          ) goto failed_to_serialize;
+    if ( size >  UINT32_MAX ) goto record_too_large;
+
+    // Store the length of the record
+    length = (uint32_t) size;
+
+    // If the key was serialized in place ...
+    if ( size <= ( p_stream->capacity - p_stream->length ) - sizeof(length) )
+    {
+
+        // ... write its length prefix, and commit both
+        memcpy(p_stream->p_buffer + p_stream->length, &length, sizeof(length));
+        p_stream->length += sizeof(length) + size;
+
+        // Success
+        return 1;
+    }
+
+    // Otherwise, the key is larger than the buffer
+    if ( size > p_stream->record_capacity )
+    {
+
+        // Initialized data
+        unsigned char *p_grown = PRIORITY_QUEUE_REALLOC(p_stream->p_record, size);
+
+        // Error checking
+        if ( p_grown == (void *) 0 ) goto no_mem;
+
+        // Update the scratch buffer
+        p_stream->p_record        = p_grown,
+        p_stream->record_capacity = size;
+    }
+
+    // Serialize the key into the scratch buffer
+    if ( pfn_serialize(p_stream->p_record, p_stream->record_capacity, p_key) != size ) goto failed_to_serialize;
+
+    // Write the record
+    if ( priority_queue_stream_write(p_stream, &length           , sizeof(length)) == 0 ) goto failed_to_write;
+    if ( priority_queue_stream_write(p_stream, p_stream->p_record, size)           == 0 ) goto failed_to_write;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_write:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_write", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_serialize:
+                #ifndef NDEBUG
+                    priority_queue_error_call("pfn_serialize", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            record_too_large:
+                #ifndef NDEBUG
+                    priority_queue_error("Serialized key exceeds 4 GB", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stream_read_key ( struct priority_queue_stream_s *const p_stream, void **pp_key, priority_queue_deserialize_fn *pfn_deserialize )
+{
+
+    // Initialized data
+    uint32_t length = 0;
+
+    // Read the length of the record
+    if ( priority_queue_stream_read(p_stream, &length, sizeof(length)) == 0 ) goto failed_to_read;
+
+    // Keys written by value ...
+    if ( pfn_deserialize == (void *) 0 )
+    {
+
+        // ... are exactly one pointer wide
+        if ( length != sizeof(void *) ) goto invalid_record;
+
+        // Read the key
+        if ( priority_queue_stream_read(p_stream, pp_key, sizeof(void *)) == 0 ) goto failed_to_read;
+    }
+
+    // Records that fit in the buffer are deserialized in place ...
+    else if ( length <= p_stream->capacity )
+    {
+
+        // Buffer the record
+        if ( priority_queue_stream_fill(p_stream, length) == 0 ) goto failed_to_read;
+
+        // Deserialize the key
+        if ( pfn_deserialize(pp_key, p_stream->p_buffer + p_stream->offset, length) == 0 ) goto failed_to_deserialize;
+
+        // Advance
+        p_stream->offset += length;
+    }
+
+    // ... and larger records are read into a scratch buffer
+    else
+    {
+
+        // Grow the scratch buffer
+        if ( length > p_stream->record_capacity )
+        {
+
+            // Initialized data
+            unsigned char *p_grown = PRIORITY_QUEUE_REALLOC(p_stream->p_record, length);
+
+            // Error checking
+            if ( p_grown == (void *) 0 ) goto no_mem;
+
+            // Update the scratch buffer
+            p_stream->p_record        = p_grown,
+            p_stream->record_capacity = length;
+        }
+
+        // Read the record
+        if ( priority_queue_stream_read(p_stream, p_stream->p_record, length) == 0 ) goto failed_to_read;
+
+        // Deserialize the key
+        if ( pfn_deserialize(pp_key, p_stream->p_record, length) == 0 ) goto failed_to_deserialize;
+    }
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_read", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_record:
+                #ifndef NDEBUG
+                    priority_queue_error("Record has the wrong length for a key written by value", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_deserialize:
+                #ifndef NDEBUG
+                    priority_queue_error_call("pfn_deserialize", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_load ( priority_queue **const pp_priority_queue, int fd, priority_queue_equal_fn pfn_compare_function, priority_queue_deserialize_fn pfn_deserialize )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( fd                <          0 ) goto no_fd;
+
+    // Initialized data
+    priority_queue                      *p_priority_queue = 0;
+    struct priority_queue_save_header_s  _header          = { 0 };
+    struct priority_queue_stream_s       _stream          = { .capacity = PRIORITY_QUEUE_STREAM_BUFFER_SIZE, .fd = fd };
+    void                                *p_key            = (void *) 0;
+
+    // Allocate a read buffer
+    _stream.p_buffer = PRIORITY_QUEUE_REALLOC(0, _stream.capacity);
+
+    // Error checking
+    if ( _stream.p_buffer == (void *) 0 ) goto no_mem;
+
+    // Read the header
+    if ( priority_queue_stream_read(&_stream, &_header, sizeof(_header)) == 0 ) goto failed_to_read;
+
+    // Validate the header
+    if ( _header.magic   != PRIORITY_QUEUE_SAVE_MAGIC   ) goto invalid_file;
+    if ( _header.version != PRIORITY_QUEUE_SAVE_VERSION ) goto invalid_file;
+    if ( _header.count    > _header.max                 ) goto invalid_file;
+    if ( _header.max     == 0                           ) goto invalid_file;
+    if ( _header.layout   > PRIORITY_QUEUE_LAYOUT_BLOCKED ) goto invalid_file;
+
+    // Construct a priority queue with the same layout
+    if ( priority_queue_construct_with_layout(&p_priority_queue, (size_t) _header.max, pfn_compare_function, (priority_queue_layout) _header.layout) == 0 ) goto failed_to_construct_priority_queue;
+
+    // Iterate over each record
+    for (size_t i = 0; i < _header.count; i++)
+    {
+
+        // Read the key
+        if ( priority_queue_stream_read_key(&_stream, &p_key, pfn_deserialize) == 0 ) goto failed_to_read;
+
+        // Store the key in heap order
+        p_priority_queue->entries.data[priority_queue_physical(p_priority_queue, i)] = p_key;
+    }
+
+    // Set the quantity of keys
+    p_priority_queue->entries.count = (size_t) _header.count;
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(_stream.p_buffer, 0);
+    if ( _stream.p_record ) PRIORITY_QUEUE_REALLOC(_stream.p_record, 0);
+
+    // Return a pointer to the caller
+    *pp_priority_queue = p_priority_queue;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_fd:
+                #ifndef NDEBUG
+                    priority_queue_error("Invalid file descriptor provided for parameter \"fd\"", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            invalid_file:
+                #ifndef NDEBUG
+                    priority_queue_error("File descriptor does not contain a valid priority queue", __FUNCTION__);
+                #endif
+
+                // Clean up
+                goto clean_up;
+
+            failed_to_construct_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_construct", __FUNCTION__);
+                #endif
+
+                // Clean up
+                goto clean_up;
+
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_read", __FUNCTION__);
+                #endif
+
+                // Clean up
+                goto clean_up;
+
+            clean_up:
+
+                // Release everything
+                if ( p_priority_queue ) priority_queue_destroy(&p_priority_queue);
+                PRIORITY_QUEUE_REALLOC(_stream.p_buffer, 0);
+                if ( _stream.p_record ) PRIORITY_QUEUE_REALLOC(_stream.p_record, 0);
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Clean up
+                goto clean_up;
+        }
+    }
+}
+#endif
+
+#ifndef _WIN64
+int priority_queue_construct_external ( priority_queue **const pp_priority_queue, size_t memory_budget, size_t block_size, const char *const directory, priority_queue_equal_fn pfn_compare_function, priority_queue_serialize_fn pfn_serialize, priority_queue_deserialize_fn pfn_deserialize )
+{
+
+    // Argument check
+    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( block_size        <          64 ) goto invalid_block_size;
+    if ( memory_budget / 4 <  block_size ) goto invalid_memory_budget;
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    const char     *p_directory      = directory;
+    size_t          fan_in           = ( memory_budget / 2 ) / block_size,
+                    len              = 0;
+
+    // Default to the temporary directory of the environment
+    if ( p_directory == (void *) 0 ) p_directory = getenv("TMPDIR");
+    if ( p_directory == (void *) 0 ) p_directory = "/tmp";
+
+    // Construct a heap with half of the budget
+    if ( priority_queue_construct(pp_priority_queue, ( memory_budget / 2 ) / sizeof(void *), pfn_compare_function) == 0 ) goto failed_to_construct_priority_queue;
+
+    // Get a pointer to the allocated priority queue
+    p_priority_queue = *pp_priority_queue;
+
+    // Allocate the runs, the loser tree, and the directory
+    len                                             = strlen(p_directory);
+    p_priority_queue->external.merger.p_runs        = PRIORITY_QUEUE_REALLOC(0, fan_in * sizeof(struct priority_queue_run_s));
+    p_priority_queue->external.merger.p_tree        = PRIORITY_QUEUE_REALLOC(0, fan_in * sizeof(size_t));
+    p_priority_queue->external.merger.p_winners     = PRIORITY_QUEUE_REALLOC(0, 2 * fan_in * sizeof(size_t));
+    p_priority_queue->external.p_directory          = PRIORITY_QUEUE_REALLOC(0, len + 1);
+
+    // Error checking
+    if ( p_priority_queue->external.merger.p_runs    == (void *) 0 ) goto no_mem;
+    if ( p_priority_queue->external.merger.p_tree    == (void *) 0 ) goto no_mem;
+    if ( p_priority_queue->external.merger.p_winners == (void *) 0 ) goto no_mem;
+    if ( p_priority_queue->external.p_directory      == (void *) 0 ) goto no_mem;
+
+    // Copy the directory
+    memcpy(p_priority_queue->external.p_directory, p_directory, len + 1);
+
+    // Store the limits, and the serializers
+    p_priority_queue->external.fan_in          = fan_in;
+    p_priority_queue->external.block_size      = block_size;
+    p_priority_queue->external.pfn_serialize   = pfn_serialize;
+    p_priority_queue->external.pfn_deserialize = pfn_deserialize;
+
+    // External priority queues take the checked path
+    p_priority_queue->inline_path = false;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_block_size:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"block_size\" must be at least 64", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_memory_budget:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"memory_budget\" must be at least 4 blocks", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_construct_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_construct", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Release the priority queue
+                priority_queue_destroy(pp_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_external_open ( priority_queue *const p_priority_queue, struct priority_queue_run_s *const p_run )
+{
+
+    // Initialized data
+    size_t  len        = strlen(p_priority_queue->external.p_directory) + sizeof("/priority_queue.XXXXXX");
+    char   *p_template = PRIORITY_QUEUE_REALLOC(0, len);
+    int     fd         = -1;
+
+    // Error checking
+    if ( p_template == (void *) 0 ) goto no_mem;
+
+    // Make a unique file name
+    snprintf(p_template, len, "%s/priority_queue.XXXXXX", p_priority_queue->external.p_directory);
+
+    // Create the file
+    fd = mkstemp(p_template);
+
+    // Error checking
+    if ( fd == -1 ) goto failed_to_create_file;
+
+    // Unlink the file, so it is removed when it is closed, even after a crash
+    unlink(p_template);
+
+    // Release the name
+    PRIORITY_QUEUE_REALLOC(p_template, 0);
+
+    // Initialize the run
+    *p_run = (struct priority_queue_run_s)
+    {
+        .stream = 
+        {
+            .p_buffer = PRIORITY_QUEUE_REALLOC(0, p_priority_queue->external.block_size),
+            .capacity = p_priority_queue->external.block_size,
+            .fd       = fd
+        }
+    };
+
+    // Error checking
+    if ( p_run->stream.p_buffer == (void *) 0 ) goto no_buffer;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_create_file:
+                #ifndef NDEBUG
+                    priority_queue_error_file("Failed to create temporary file", p_template, __FUNCTION__);
+                #endif
+
+                // Release the name
+                PRIORITY_QUEUE_REALLOC(p_template, 0);
+
+                // Error
+                return 0;
+
+            no_buffer:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Close the file
+                close(fd);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+void priority_queue_external_close ( struct priority_queue_run_s *const p_run )
+{
+
+    // Close the file
+    close(p_run->stream.fd);
+
+    // Release the buffers
+    PRIORITY_QUEUE_REALLOC(p_run->stream.p_buffer, 0);
+    if ( p_run->stream.p_record ) PRIORITY_QUEUE_REALLOC(p_run->stream.p_record, 0);
+
+    // Clear the run
+    memset(p_run, 0, sizeof(struct priority_queue_run_s));
+
+    // Done
+    return;
+}
+
+int priority_queue_external_rewind ( priority_queue *const p_priority_queue, struct priority_queue_run_s *const p_run, size_t count )
+{
+
+    // Seek to the start of the run
+    if ( lseek(p_run->stream.fd, 0, SEEK_SET) == -1 ) goto failed_to_seek;
+
+    // Empty the buffer
+    p_run->stream.offset = 0;
+    p_run->stream.length = 0;
+
+    // Store the quantity of keys
+    p_run->remaining = count;
+
+    // Read the first key
+    if ( count )
+        if ( priority_queue_stream_read_key(&p_run->stream, &p_run->p_head, p_priority_queue->external.pfn_deserialize) == 0 ) goto failed_to_read;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_read_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            failed_to_seek:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to seek file descriptor", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_external_pop ( priority_queue *const p_priority_queue, void **pp_key )
+{
+
+    // Initialized data
+    struct priority_queue_merger_s *p_merger = &p_priority_queue->external.merger;
+    struct priority_queue_run_s    *p_run    = &p_merger->p_runs[p_merger->p_tree[0]];
+
+    // Return the head of the winning run
+    *pp_key = p_run->p_head;
+
+    // Remove the key
+    p_run->remaining--,
+    p_merger->count--;
+
+    // Refill the head of the run
+    if ( p_run->remaining )
+        if ( priority_queue_stream_read_key(&p_run->stream, &p_run->p_head, p_priority_queue->external.pfn_deserialize) == 0 ) goto failed_to_read;
+
+    // Find the next winner
+    priority_queue_loser_tree_replay(p_priority_queue, p_merger);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_read_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_external_merge ( priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    struct priority_queue_merger_s *p_merger = &p_priority_queue->external.merger;
+    struct priority_queue_run_s    *p_runs   = p_merger->p_runs,
+                                    _run     = { 0 },
+                                    _tmp     = { 0 };
+    size_t                          total    = p_merger->count,
+                                    count    = 0,
+                                    merged   = 0,
+                                    level    = 0,
+                                    live     = 0;
+    void                           *p_key    = (void *) 0;
+
+    // Close each run that dequeues exhausted
+    for (size_t i = 0; i < p_merger->run_count; i++)
+        if ( p_runs[i].remaining ) p_runs[live++] = p_runs[i];
+        else                       priority_queue_external_close(&p_runs[i]);
+
+    // Fast exit. Closing the exhausted runs made room
+    if ( live < p_merger->run_count )
+    {
+
+        // Store the runs
+        p_merger->run_count = live;
+
+        // Play the matches
+        priority_queue_loser_tree_build(p_priority_queue, p_merger);
+
+        // Success
+        return 1;
+    }
+
+    // Create the merged run
+    if ( priority_queue_external_open(p_priority_queue, &_run) == 0 ) goto failed_to_open;
+
+    // Find the lowest level with at least two runs at or below it
+    for (level = SIZE_MAX; merged < 2;)
+    {
+
+        // Initialized data
+        size_t next = SIZE_MAX;
+
+        // Find the next level
+        for (size_t i = 0; i < live; i++)
+            if ( ( level == SIZE_MAX || p_runs[i].level > level ) && p_runs[i].level < next ) next = p_runs[i].level;
+        level = next;
+
+        // Count the runs at or below it
+        merged = 0;
+        for (size_t i = 0; i < live; i++) merged += ( p_runs[i].level <= level );
+    }
+
+    // Move those runs to the front, keeping each group in order
+    for (size_t i = 0, j = 0; i < live; i++)
+    {
+
+        // Skip a higher level
+        if ( p_runs[i].level > level ) continue;
+
+        // Rotate the run into place
+        _tmp = p_runs[i];
+        memmove(&p_runs[j + 1], &p_runs[j], ( i - j ) * sizeof(struct priority_queue_run_s));
+        p_runs[j++] = _tmp;
+        count      += _tmp.remaining;
+    }
+
+    // Merge only the front runs
+    p_merger->run_count = merged;
+    p_merger->count     = count;
+    priority_queue_loser_tree_build(p_priority_queue, p_merger);
+
+    // The merged run is one level higher
+    _run.level = level + 1;
+
+    // Write every key, in order
+    while ( p_merger->count )
+    {
+
+        // Remove the front key
+        if ( priority_queue_external_pop(p_priority_queue, &p_key) == 0 ) goto failed_to_merge;
+
+        // Write the key
+        if ( priority_queue_stream_write_key(&_run.stream, p_key, p_priority_queue->external.pfn_serialize) == 0 ) goto failed_to_merge;
+    }
+
+    // Flush the merged run
+    if ( priority_queue_stream_flush(&_run.stream) == 0 ) goto failed_to_merge;
+
+    // Close the merged runs
+    for (size_t i = 0; i < merged; i++)
+        priority_queue_external_close(&p_runs[i]);
+
+    // Replace them with the merged run, followed by the runs of higher levels
+    p_runs[0] = _run;
+    memmove(&p_runs[1], &p_runs[merged], ( live - merged ) * sizeof(struct priority_queue_run_s));
+    p_merger->run_count = live - merged + 1;
+    p_merger->count     = total;
+
+    // Read the first key
+    if ( priority_queue_external_rewind(p_priority_queue, &p_runs[0], count) == 0 ) goto failed_to_rewind;
+
+    // Play the matches
+    priority_queue_loser_tree_build(p_priority_queue, p_merger);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_open:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_external_open", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_merge:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to merge runs", __FUNCTION__);
+                #endif
+
+                // Release the merged run
+                priority_queue_external_close(&_run);
+
+                // Keep the unmerged keys of every run
+                p_merger->run_count = live;
+                p_merger->count     = 0;
+                for (size_t i = 0; i < live; i++) p_merger->count += p_runs[i].remaining;
+                priority_queue_loser_tree_build(p_priority_queue, p_merger);
+
+                // Error
+                return 0;
+
+            failed_to_rewind:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_external_rewind", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_external_spill ( priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    struct priority_queue_merger_s *p_merger = &p_priority_queue->external.merger;
+    struct priority_queue_run_s    *p_run    = (void *) 0;
+    size_t                          count    = p_priority_queue->entries.count;
+
+    // Make room for another run
+    if ( p_merger->run_count == p_priority_queue->external.fan_in )
+        if ( priority_queue_external_merge(p_priority_queue) == 0 ) goto failed_to_merge;
+
+    // Create the run
+    p_run = &p_merger->p_runs[p_merger->run_count];
+    if ( priority_queue_external_open(p_priority_queue, p_run) == 0 ) goto failed_to_open;
+
+    // Sort the heap, in ascending order of priority
+    priority_queue_build_heap_sort(p_priority_queue);
+
+    // Write the keys, in descending order of priority
+    for (size_t i = count; i-- > 0;)
+        if ( priority_queue_stream_write_key(&p_run->stream, p_priority_queue->entries.data[i], p_priority_queue->external.pfn_serialize) == 0 ) goto failed_to_write;
+
+    // Flush the run
+    if ( priority_queue_stream_flush(&p_run->stream) == 0 ) goto failed_to_write;
+
+    // Read the first key
+    if ( priority_queue_external_rewind(p_priority_queue, p_run, count) == 0 ) goto failed_to_write;
+
+    // Empty the heap
+    p_priority_queue->entries.count = 0;
+
+    // Add the run
+    p_merger->run_count++,
+    p_merger->count += count;
+
+    // Play the matches
+    priority_queue_loser_tree_build(p_priority_queue, p_merger);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_merge:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_external_merge", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_open:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_external_open", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_write:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to write run", __FUNCTION__);
+                #endif
+
+                // Release the run, and keep the keys in the heap
+                priority_queue_external_close(p_run);
+                priority_queue_build_max_heap(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+#endif
+
+int priority_queue_sequence_push ( priority_queue *const p_priority_queue, size_t g, void **p_keys, size_t count )
+{
+
+    // Initialized data
+    struct priority_queue_merger_s *p_group = (void *) 0;
+    size_t                          live    = 0;
+
+    // Add a group
+    if ( g == p_priority_queue->sequence.group_count )
+    {
+
+        // Initialized data
+        struct priority_queue_merger_s *p_groups = PRIORITY_QUEUE_REALLOC(p_priority_queue->sequence.p_groups, ( g + 1 ) * sizeof(struct priority_queue_merger_s));
+
+        // Error checking
+        if ( p_groups == (void *) 0 ) goto no_mem;
+
+        // Update the groups
+        p_priority_queue->sequence.p_groups = p_groups;
+
+        // Allocate the sequences and the loser tree of the group
+        p_groups[g] = (struct priority_queue_merger_s)
+        {
+            .p_runs    = PRIORITY_QUEUE_REALLOC(0, PRIORITY_QUEUE_SEQUENCE_ARITY * sizeof(struct priority_queue_run_s)),
+            .p_tree    = PRIORITY_QUEUE_REALLOC(0, PRIORITY_QUEUE_SEQUENCE_ARITY * sizeof(size_t)),
+            .p_winners = PRIORITY_QUEUE_REALLOC(0, 2 * PRIORITY_QUEUE_SEQUENCE_ARITY * sizeof(size_t))
+        };
+
+        // Count the group, so it is released with the priority queue
+        p_priority_queue->sequence.group_count++;
+
+        // Error checking
+        if ( p_groups[g].p_runs    == (void *) 0 ) goto no_mem;
+        if ( p_groups[g].p_tree    == (void *) 0 ) goto no_mem;
+        if ( p_groups[g].p_winners == (void *) 0 ) goto no_mem;
+    }
+
+    // Get a pointer to the group
+    p_group = &p_priority_queue->sequence.p_groups[g];
+
+    // Release exhausted sequences
+    for (size_t i = 0; i < p_group->run_count; i++)
+    {
+
+        // Keep sequences with keys
+        if ( p_group->p_runs[i].remaining ) { p_group->p_runs[live++] = p_group->p_runs[i]; continue; }
+
+        // Release the keys
+        PRIORITY_QUEUE_REALLOC(p_group->p_runs[i].p_keys, 0);
+    }
+
+    // Update the quantity of sequences
+    p_group->run_count = live;
+
+    // If the group is still full ...
+    if ( p_group->run_count == PRIORITY_QUEUE_SEQUENCE_ARITY )
+    {
+
+        // Initialized data
+        size_t   merged_count = p_group->count;
+        void   **p_merged     = PRIORITY_QUEUE_REALLOC(0, merged_count * sizeof(void *));
+
+        // Error checking
+        if ( p_merged == (void *) 0 ) goto no_mem;
+
+        // ... merge its sequences, in order ...
+        for (size_t i = 0; i < merged_count; i++)
+            p_merged[i] = priority_queue_sequence_pop(p_priority_queue, p_group);
+
+        // ... release them ...
+        for (size_t i = 0; i < p_group->run_count; i++)
+            PRIORITY_QUEUE_REALLOC(p_group->p_runs[i].p_keys, 0);
+
+        // ... empty the group ...
+        p_group->run_count = 0;
+
+        // ... and add the merged sequence to the next group
+        if ( priority_queue_sequence_push(p_priority_queue, g + 1, p_merged, merged_count) == 0 )
+        {
+
+            // If that fails, the merged sequence stays in this group
+            p_group = &p_priority_queue->sequence.p_groups[g];
+            p_group->p_runs[p_group->run_count++] = (struct priority_queue_run_s) { .p_keys = p_merged, .p_head = p_merged[0], .remaining = merged_count };
+            p_group->count = merged_count;
+        }
+
+        // The groups may have moved
+        p_group = &p_priority_queue->sequence.p_groups[g];
+    }
+
+    // Add the sequence
+    p_group->p_runs[p_group->run_count++] = (struct priority_queue_run_s)
+    {
+        .p_keys    = p_keys,
+        .p_head    = p_keys[0],
+        .remaining = count
+    };
+    p_group->count += count;
+
+    // Play the matches
+    priority_queue_loser_tree_build(p_priority_queue, p_group);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_sequence_spill ( priority_queue *const p_priority_queue )
+{
+
+    // Initialized data
+    size_t   count  = p_priority_queue->entries.count;
+    void   **p_keys = PRIORITY_QUEUE_REALLOC(0, count * sizeof(void *));
+
+    // Error checking
+    if ( p_keys == (void *) 0 ) goto no_mem;
+
+    // Sort the insertion heap, in ascending order of priority
+    priority_queue_build_heap_sort(p_priority_queue);
+
+    // Copy the keys, in descending order of priority
+    for (size_t i = 0; i < count; i++)
+        p_keys[i] = p_priority_queue->entries.data[count - 1 - i];
+
+    // Add the sequence to the first group
+    if ( priority_queue_sequence_push(p_priority_queue, 0, p_keys, count) == 0 ) goto failed_to_push;
+
+    // Move the keys from the insertion heap to the groups
+    p_priority_queue->entries.count   = 0;
+    p_priority_queue->sequence.count += count;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Priority queue errors
+        {
+            failed_to_push:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_sequence_push", __FUNCTION__);
+                #endif
+
+                // Keep the keys in the insertion heap
+                PRIORITY_QUEUE_REALLOC(p_keys, 0);
+                priority_queue_build_max_heap(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    // TODO: Bounds check parameter i
+    // TODO: Lock
+
+    // Initialized data
+    void   **data   = p_priority_queue->entries.data;
+    size_t   levels = 0;
+
+    // Sift the key down
+    for (;;)
+    {
+
+        // Initialized data
+        size_t l       = priority_queue_left(p_priority_queue, i);
+        size_t r       = priority_queue_right(p_priority_queue, i);
+        size_t largest = i;
+
+        // Stop at a leaf
+        if ( priority_queue_in_heap(p_priority_queue, l) == false ) break;
+
+        // Prefetch the children of both children, while comparing this level
+        size_t ll = priority_queue_left(p_priority_queue, l),
+               rl = priority_queue_left(p_priority_queue, r);
+        if ( priority_queue_in_heap(p_priority_queue, ll) ) PRIORITY_QUEUE_PREFETCH(&data[ll]);
+        if ( priority_queue_in_heap(p_priority_queue, rl) ) PRIORITY_QUEUE_PREFETCH(&data[rl]);
+
+        // If the lefthand value is greater than the root ...
+        if ( priority_queue_compare(p_priority_queue, data[l], data[largest]) > 0 )
+
+            // ... update the index of the largest value
+            largest = l;
+        
+        // If the righthand value is greater than the root ...
+        if ( priority_queue_in_heap(p_priority_queue, r) && ( priority_queue_compare(p_priority_queue, data[r], data[largest]) > 0 ) )
+
+            // ... update the index of the largest value
+            largest = r;
+        
+        // Stop when the heap property holds
+        if ( largest == i ) break;
+
+        // Swap the keys
+        void *tmp     = data[i];
+        data[i]       = data[largest];
+        data[largest] = tmp;
+
+        // Continue from the child
+        i = largest;
+        levels++;
+    }
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Trace the sift
+    PRIORITY_QUEUE_TRACE_HEAPIFY(p_priority_queue, i, levels);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+/** !
+ * Build the subtree of a binary heap under a key, bottom up
+ * 
+ * @param p_priority_queue the priority queue
+ * @param root             the index of the root of the subtree
+ * 
+ * @return void
+ */
+static void priority_queue_build_subtree ( priority_queue *const p_priority_queue, size_t root )
+{
+
+    // Initialized data
+    size_t internal = p_priority_queue->entries.count / 2,
+           depth    = 0;
+
+    // Find the deepest level of the subtree with an internal key
+    if ( root >= internal ) return;
+    while ( ( ( root + 1 ) << ( depth + 1 ) ) - 1 < internal ) depth++;
+
+    // Heapify each level, from the deepest to the root
+    for (size_t k = depth + 1; k-- > 0; )
+    {
+
+        // Initialized data
+        size_t first = ( ( root + 1 ) << k ) - 1,
+               last  = first + ( (size_t) 1 << k );
+
+        // Skip the leaves
+        if ( last > internal ) last = internal;
+
+        // Heapify each key on the level
+        for (size_t i = last; i-- > first; )
+            priority_queue_heapify(p_priority_queue, i);
+    }
+}
+
+/** !
+ * Build every subtree assigned to a worker
+ * 
+ * @param p_parameter pointer to a struct priority_queue_build_task_s
+ * 
+ * @return 0
+ */
+static void *priority_queue_build_worker ( void *p_parameter )
+{
+
+    // Initialized data
+    struct priority_queue_build_task_s *p_task = p_parameter;
+    size_t                              first  = ( (size_t) 1 << p_task->depth ) - 1,
+                                        last   = ( (size_t) 1 << ( p_task->depth + 1 ) ) - 1;
+
+    // Build each subtree of the split level, taking every workers'th one
+    for (size_t root = first + p_task->worker; root < last; root += p_task->workers)
+        priority_queue_build_subtree(p_task->p_priority_queue, root);
+
+    // Done
+    return (void *) 0;
+}
+
+/** !
+ * Sort keys with a bottom up merge sort, highest priority first. Keys of equal 
+ * priority keep their order
+ * 
+ * @param p_priority_queue the priority queue, for its compare function
+ * @param p_keys           the keys
+ * @param p_scratch        scratch space for as many keys
+ * @param count            the quantity of keys
+ * 
+ * @return void
+ */
+static void priority_queue_merge_sort ( const priority_queue *const p_priority_queue, void **p_keys, void **p_scratch, size_t count )
+{
+
+    // Initialized data
+    void **p_from = p_keys,
+         **p_to   = p_scratch;
+
+    // Sort short runs with an insertion sort
+    for (size_t lo = 0; lo < count; lo += PRIORITY_QUEUE_SORT_RUN)
+    {
+
+        // Initialized data
+        size_t hi = ( lo + PRIORITY_QUEUE_SORT_RUN < count ) ? lo + PRIORITY_QUEUE_SORT_RUN : count;
+
+        // Insert each key into the sorted keys before it
+        for (size_t i = lo + 1; i < hi; i++)
+        {
+
+            // Initialized data
+            void   *p_key = p_from[i];
+            size_t  j     = i;
+
+            // Move the lower priority keys up
+            for (; j > lo && priority_queue_compare(p_priority_queue, p_key, p_from[j - 1]) > 0; j--)
+                p_from[j] = p_from[j - 1];
+
+            // Store the key
+            p_from[j] = p_key;
+        }
+    }
+
+    // Merge pairs of runs, doubling their width each pass
+    for (size_t width = PRIORITY_QUEUE_SORT_RUN; width < count; width *= 2)
+    {
+
+        // Merge each pair of runs
+        for (size_t lo = 0; lo < count; lo += 2 * width)
+        {
+
+            // Initialized data
+            size_t mid = ( lo +     width < count ) ? lo +     width : count,
+                   hi  = ( lo + 2 * width < count ) ? lo + 2 * width : count,
+                   l   = lo,
+                   r   = mid,
+                   o   = lo;
+
+            // Take the right key only when it has a higher priority, so ties keep their order
+            while ( l < mid && r < hi )
+                p_to[o++] = ( priority_queue_compare(p_priority_queue, p_from[r], p_from[l]) > 0 ) ? p_from[r++] : p_from[l++];
+
+            // Copy the rest of either run
+            while ( l < mid ) p_to[o++] = p_from[l++];
+            while ( r < hi  ) p_to[o++] = p_from[r++];
+        }
+
+        // The merged runs are the input of the next pass
+        void **tmp = p_from;
+        p_from     = p_to;
+        p_to       = tmp;
+    }
+
+    // Move the keys back, if the last pass ended in the scratch space
+    if ( p_from != p_keys ) memcpy(p_keys, p_from, count * sizeof(void *));
+
+    // Done
+    return;
+}
+
+/** !
+ * Sort the partition assigned to a worker
+ * 
+ * @param p_parameter pointer to a struct priority_queue_sort_task_s
+ * 
+ * @return 0
+ */
+static void *priority_queue_sort_worker ( void *p_parameter )
+{
+
+    // Initialized data
+    struct priority_queue_sort_task_s *p_task = p_parameter;
+
+    // Sort the partition
+    priority_queue_merge_sort(p_task->p_priority_queue, p_task->p_keys, p_task->p_scratch, p_task->count);
+
+    // Done
+    return (void *) 0;
+}
+
+int priority_queue_build_max_heap ( priority_queue *const p_priority_queue )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Build the heap, from the last internal node to the root
+    for (size_t i = p_priority_queue->entries.count / 2; i-- > 0; )
+    
+        // Sort the heap
+        priority_queue_heapify(p_priority_queue, i);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_build_max_heap_parallel ( priority_queue *const p_priority_queue, size_t threads )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // State check
+    if ( p_priority_queue->layout != PRIORITY_QUEUE_LAYOUT_BINARY ) goto not_binary;
+
+    // Initialized data
+    size_t count = p_priority_queue->entries.count,
+           depth = 0;
+
+    // Use one thread per processor
+    #ifndef _WIN64
+        if ( threads == 0 ) threads = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+        threads = 1;
+    #endif
+
+    // Small heaps are built on this thread
+    if ( threads < 2 || count < PRIORITY_QUEUE_PARALLEL_BUILD_MIN ) return priority_queue_build_max_heap(p_priority_queue);
+
+    // Split the heap at the first level with enough subtrees for every thread
+    while ( ( (size_t) 1 << depth ) < threads * PRIORITY_QUEUE_PARALLEL_BUILD_SPLIT ) depth++;
+
+    #ifndef _WIN64
+    {
+
+        // Initialized data
+        struct priority_queue_build_task_s *p_tasks   = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(struct priority_queue_build_task_s));
+        pthread_t                          *p_threads = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(pthread_t));
+        bool                               *p_started = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(bool));
+
+        // Error checking
+        if ( p_tasks == (void *) 0 || p_threads == (void *) 0 || p_started == (void *) 0 )
+        {
+
+            // Release whatever was allocated
+            if ( p_tasks   ) p_tasks   = PRIORITY_QUEUE_REALLOC(p_tasks  , 0);
+            if ( p_threads ) p_threads = PRIORITY_QUEUE_REALLOC(p_threads, 0);
+            if ( p_started ) p_started = PRIORITY_QUEUE_REALLOC(p_started, 0);
+
+            // Error
+            goto no_mem;
+        }
+
+        // Start a worker for each thread but this one
+        for (size_t i = 0; i < threads; i++)
+        {
+
+            // Describe the work
+            p_tasks[i]   = (struct priority_queue_build_task_s) { .p_priority_queue = p_priority_queue, .depth = depth, .worker = i, .workers = threads };
+            p_started[i] = ( i > 0 ) && ( pthread_create(&p_threads[i], (void *) 0, priority_queue_build_worker, &p_tasks[i]) == 0 );
+        }
+
+        // Do the first share here, and any share whose thread could not start
+        for (size_t i = 0; i < threads; i++)
+            if ( p_started[i] == false ) priority_queue_build_worker(&p_tasks[i]);
+
+        // Wait for the workers
+        for (size_t i = 1; i < threads; i++)
+            if ( p_started[i] ) pthread_join(p_threads[i], (void *) 0);
+
+        // Release the tasks
+        p_tasks   = PRIORITY_QUEUE_REALLOC(p_tasks  , 0);
+        p_threads = PRIORITY_QUEUE_REALLOC(p_threads, 0);
+        p_started = PRIORITY_QUEUE_REALLOC(p_started, 0);
+    }
+    #endif
+
+    // Finish the levels above the split
+    for (size_t i = ( (size_t) 1 << depth ) - 1; i-- > 0; )
+        priority_queue_heapify(p_priority_queue, i);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            not_binary:
+                #ifndef NDEBUG
+                    priority_queue_error("Only binary heaps are built in parallel", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        #ifndef _WIN64
+
+            // Standard library errors
+            {
+                no_mem:
+                    #ifndef NDEBUG
+                        priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                    #endif
+
+                    // Error
+                    return 0;
+            }
+        #endif
+    }
+}
+
+int priority_queue_build_heap_sort ( priority_queue *const p_priority_queue )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Initialized data
+    size_t count = p_priority_queue->entries.count;
+
+    // Build the max heap
+    priority_queue_build_max_heap(p_priority_queue);
+
+    // Iterate through the max heap, from the last key to the second key
+    for ( size_t i = count; i-- > 1; )
+    {
+        
+        // Initialized data
+        size_t last = priority_queue_physical(p_priority_queue, i);
+
+        // Swap the node at the iterator with the largest
+        void *tmp = p_priority_queue->entries.data[0];
+        p_priority_queue->entries.data[0] = p_priority_queue->entries.data[last];
+        p_priority_queue->entries.data[last] = tmp;
+
+        // Decrement the heap size
+        p_priority_queue->entries.count--;
+
+        // Sort the heap
+        priority_queue_heapify(p_priority_queue, 0);
+    }
+
+    // Restore the heap size
+    p_priority_queue->entries.count = count;
+     
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Error check
+    if ( p_priority_queue->entries.count + p_priority_queue->external.merger.count + p_priority_queue->sequence.count < 1 ) goto underflow;
+
+    // Initialized data
+    size_t front = ( p_priority_queue->sequence.count ) ? priority_queue_sequence_front(p_priority_queue) : SIZE_MAX;
+
+    // Return the maximum value to the caller
+    if ( front != SIZE_MAX )
+        *pp_value = p_priority_queue->sequence.p_groups[front].p_runs[p_priority_queue->sequence.p_groups[front].p_tree[0]].p_head;
+    else if ( priority_queue_external_first(p_priority_queue) )
+        *pp_value = p_priority_queue->external.merger.p_runs[p_priority_queue->external.merger.p_tree[0]].p_head;
+    else if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL )
+        *pp_value = p_priority_queue->entries.data[p_priority_queue->bucket.p_head[priority_queue_bucket_first(p_priority_queue)]];
+    else if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX )
+        *pp_value = (void *) (uintptr_t) PRIORITY_QUEUE_COMPACT_INDEX(( (uint64_t *) p_priority_queue->typed.p_priorities )[0]);
+    else
+        *pp_value = p_priority_queue->entries.data[0];
+     
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            underflow:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue underflow", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **pp_value )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Initialized data
+    void *ret = (void *) 0;
+
+    // Get the maximum element
+    if ( priority_queue_max(p_priority_queue, &ret) == 0 ) goto underflow;
+
+    // Sequence heaps remove keys in their groups from the winning sequence
+    if ( p_priority_queue->sequence.count )
+    {
+
+        // Initialized data
+        size_t front = priority_queue_sequence_front(p_priority_queue);
+
+        // If the front is in a group ...
+        if ( front != SIZE_MAX )
+        {
+
+            // ... remove it
+            priority_queue_sequence_pop(p_priority_queue, &p_priority_queue->sequence.p_groups[front]);
+            p_priority_queue->sequence.count--;
+
+            // Return the maximum value to the caller
+            if ( pp_value ) *pp_value = ret;
+
+            // Success
+            return 1;
+        }
+    }
+
+    // External priority queues remove keys on disk from their runs
+    #ifndef _WIN64
+        if ( priority_queue_external_first(p_priority_queue) )
+        {
+
+            // Remove the key
+            if ( priority_queue_external_pop(p_priority_queue, &ret) == 0 ) goto failed_to_read;
+
+            // Return the maximum value to the caller
+            if ( pp_value ) *pp_value = ret;
+
+            // Success
+            return 1;
+        }
+    #endif
+
+    // Typed heaps order keys by their inline priorities
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+    {
+
+        // Remove the key
+        priority_queue_typed_extract(p_priority_queue, pp_value, (void *) 0);
+
+        // Success
+        return 1;
+    }
+
+    // Initialized data
+    size_t last = priority_queue_physical(p_priority_queue, p_priority_queue->entries.count - 1);
+
+    // Move the last element in the heap to the first element of the heap
+    p_priority_queue->entries.data[0] = p_priority_queue->entries.data[last];
+
+    // Eliminate the duplicated element
+    p_priority_queue->entries.data[last] = (void *) 0;
+
+    // Decrement the quantity of elements in the priority queue
+    p_priority_queue->entries.count--;
+
+    // Fix the heap
+    priority_queue_heapify(p_priority_queue, 0);
+
+    // Return the maximum value to the caller
+    if ( pp_value ) *pp_value = ret;
+     
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            underflow:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue underflow", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            #ifndef _WIN64
+            failed_to_read:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_external_pop", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+            #endif
+        }
+    } 
+}
+
+int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t index, void *p_key )
+{
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Ensure the key is increasing priority 
+    if ( priority_queue_compare(p_priority_queue, p_key, p_priority_queue->entries.data[index]) < 0 ) goto decrease_key;
+
+    // Initialized data
+    size_t levels = 0;
+
+    // Store the key in the heap
+    p_priority_queue->entries.data[index] = p_key;
+
+    // Increase the key in the heap to its maximum priority
+    while ( index > 0 && priority_queue_compare(p_priority_queue, p_priority_queue->entries.data[priority_queue_parent(p_priority_queue, index)], p_priority_queue->entries.data[index]) < 0 )
+    {
+
+        // Swap the key at index with key at parent index in the heap
+        size_t tmp_idx = priority_queue_parent(p_priority_queue, index);
+        void *tmp = p_priority_queue->entries.data[index];
+        p_priority_queue->entries.data[index] = p_priority_queue->entries.data[tmp_idx];
+        p_priority_queue->entries.data[tmp_idx] = tmp;
+
+        // Update index to the parent index;
+        index = tmp_idx;
+        levels++;
+    }
+
+    // Count the sift
+    PRIORITY_QUEUE_STAT_SIFT(p_priority_queue, levels);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            decrease_key:
+                #ifndef NDEBUG
+                    priority_queue_error("Key has a lower priority than the key it replaces", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_insert ( priority_queue *const p_priority_queue, void *p_key )
+{
+    
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_key            == (void *) 0 ) goto no_key;
+
+    // An external priority queue spills a full heap to disk
+    #ifndef _WIN64
+        if ( p_priority_queue->entries.count >= p_priority_queue->entries.max && p_priority_queue->external.block_size )
+            if ( priority_queue_external_spill(p_priority_queue) == 0 ) goto failed_to_spill;
+    #endif
+
+    // A sequence heap moves a full insertion heap into its groups
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE )
+    {
+
+        // State check
+        if ( p_priority_queue->entries.count + p_priority_queue->sequence.count >= p_priority_queue->sequence.max ) goto heap_overflow;
+
+        // Sort the insertion heap into a sequence
+        if ( p_priority_queue->entries.count >= p_priority_queue->entries.max )
+            if ( priority_queue_sequence_spill(p_priority_queue) == 0 ) goto failed_to_spill;
+    }
+
+    // State check
+    if ( p_priority_queue->entries.count >= p_priority_queue->entries.max ) goto heap_overflow;
+
+    // Typed heaps order keys by their inline priorities
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+    {
+
+        // Insert the key with its priority
+        priority_queue_typed_insert(p_priority_queue, p_key, priority_queue_typed_priority(p_priority_queue, p_key));
+
+        // Success
+        return 1;
+    }
+
+    // Initialized data
+    size_t index = priority_queue_physical(p_priority_queue, p_priority_queue->entries.count);
+
+    // Increment the size of the heap
+    p_priority_queue->entries.count++;
+
+    // Insert the key into the heap
+    p_priority_queue->entries.data[index] = p_key;
+
+    // Position the key correctly
+    if ( priority_queue_increase_key(p_priority_queue, index, p_key) == 0 ) goto failed_to_increase_key;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+            
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            heap_overflow:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue overflow", __FUNCTION__);
+                #endif
+
+                // Count the overflow
+                PRIORITY_QUEUE_STAT_ADD(p_priority_queue, overflows, 1);
+
+                // Error
+                return 0;
+
+            failed_to_spill:
+                #ifndef NDEBUG
+                    priority_queue_error("Failed to move the keys of a full heap", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_increase_key:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_increase_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_enqueue ( priority_queue *const p_priority_queue, void *p_key )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_key            == (void *) 0 ) goto no_key;
+
+    // Start timing
+    PRIORITY_QUEUE_HISTOGRAM_START(t0);
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Insert the key
+    if ( priority_queue_insert(p_priority_queue, p_key) == 0 ) goto failed_to_insert_key;
+
+    // Count and trace the enqueue
+    PRIORITY_QUEUE_STAT_ADD(p_priority_queue, enqueues, 1);
+    PRIORITY_QUEUE_TRACE_ENQUEUE(p_priority_queue, p_key);
+    PRIORITY_QUEUE_STAT_MAX(p_priority_queue, high_water, p_priority_queue->entries.count + p_priority_queue->external.merger.count + p_priority_queue->sequence.count);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Time the enqueue
+    PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_ENQUEUE, t0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+            
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            failed_to_insert_key:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_insert", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_dequeue ( priority_queue *const p_priority_queue, void **pp_key )
+{
+    
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( pp_key           == (void *) 0 ) goto no_key;
+
+    // Start timing
+    PRIORITY_QUEUE_HISTOGRAM_START(t0);
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Remove the front key, skipping dead keys
+    do if ( priority_queue_extract_max(p_priority_queue, pp_key) == 0 ) goto failed_to_extract_max_key;
+    while ( priority_queue_tombstone_take(p_priority_queue, *pp_key) );
+
+    // Count and trace the dequeue
+    PRIORITY_QUEUE_STAT_ADD(p_priority_queue, dequeues, 1);
+    PRIORITY_QUEUE_TRACE_DEQUEUE(p_priority_queue, *pp_key);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Time the dequeue
+    PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_DEQUEUE, t0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+            
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            failed_to_extract_max_key:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_extract_max", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_enqueue_priority ( priority_queue *const p_priority_queue, void *p_key, priority_queue_priority priority )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // State check
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_COMPARATOR ) goto not_typed;
+
+    // Start timing
+    PRIORITY_QUEUE_HISTOGRAM_START(t0);
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Error check
+    if ( p_priority_queue->entries.count >= p_priority_queue->entries.max ) goto heap_overflow;
+
+    // Insert the key with its priority
+    priority_queue_typed_insert(p_priority_queue, p_key, priority);
+
+    // Count and trace the enqueue
+    PRIORITY_QUEUE_STAT_ADD(p_priority_queue, enqueues, 1);
+    PRIORITY_QUEUE_TRACE_ENQUEUE(p_priority_queue, p_key);
+    PRIORITY_QUEUE_STAT_MAX(p_priority_queue, high_water, p_priority_queue->entries.count);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Time the enqueue
+    PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_ENQUEUE, t0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            not_typed:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue does not store inline priorities", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            heap_overflow:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue overflow", __FUNCTION__);
+                #endif
+
+                // Count the overflow
+                PRIORITY_QUEUE_STAT_ADD(p_priority_queue, overflows, 1);
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_dequeue_priority ( priority_queue *const p_priority_queue, void **pp_key, priority_queue_priority *p_priority )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( pp_key           == (void *) 0 ) goto no_key;
+
+    // State check
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_COMPARATOR ) goto not_typed;
+
+    // Start timing
+    PRIORITY_QUEUE_HISTOGRAM_START(t0);
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Remove the key and its priority, skipping dead indices
+    do
+    {
+
+        // Error check
+        if ( p_priority_queue->entries.count == 0 ) goto underflow;
+
+        // Remove the key and its priority
+        priority_queue_typed_extract(p_priority_queue, pp_key, p_priority);
+
+    } while ( priority_queue_tombstone_take(p_priority_queue, *pp_key) );
+
+    // Count and trace the dequeue
+    PRIORITY_QUEUE_STAT_ADD(p_priority_queue, dequeues, 1);
+    PRIORITY_QUEUE_TRACE_DEQUEUE(p_priority_queue, *pp_key);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Time the dequeue
+    PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_DEQUEUE, t0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            not_typed:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue does not store inline priorities", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            underflow:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue underflow", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_enqueue_index ( priority_queue *const p_priority_queue, uint32_t index, uint32_t priority )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_INDEX ) goto not_compact;
+
+    // Add the index with its priority
+    return priority_queue_enqueue_priority(p_priority_queue, (void *) (uintptr_t) index, (priority_queue_priority) { .u32 = priority });
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            not_compact:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue does not store indices", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_dequeue_index ( priority_queue *const p_priority_queue, uint32_t *p_index, uint32_t *p_priority )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_index          == (void *) 0 ) goto no_index;
+
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_INDEX ) goto not_compact;
+
+    // Initialized data
+    void                    *p_key    = (void *) 0;
+    priority_queue_priority  priority = { 0 };
+
+    // Remove the index with its priority
+    if ( priority_queue_dequeue_priority(p_priority_queue, &p_key, &priority) == 0 ) return 0;
+
+    // Return the index and its priority to the caller
+    *p_index = (uint32_t) (uintptr_t) p_key;
+    if ( p_priority ) *p_priority = priority.u32;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_index:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_index", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            not_compact:
+                #ifndef NDEBUG
+                    priority_queue_error("Priority queue does not store indices", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_fair_weight_set ( priority_queue_fair *const p_fair, size_t tenant, uint32_t weight )
+{
+
+    // Argument check
+    if ( p_fair == (void *) 0     ) goto no_fair;
+    if ( tenant >= p_fair->tenants ) goto invalid_tenant;
+    if ( weight == 0               ) goto zero_weight;
+
+    // Lock
+    mutex_lock(p_fair->_lock);
+
+    // Store the weight. Keys that already arrived keep their finish times
+    p_fair->p_tenants[tenant].weight = weight;
+
+    // Unlock
+    mutex_unlock(p_fair->_lock);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_fair:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_fair", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_tenant:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"tenant\" is out of range", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            zero_weight:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"weight\" must be greater than 0", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_fair_enqueue ( priority_queue_fair *const p_fair, size_t tenant, void *p_key, uint32_t cost )
+{
+
+    // Argument check
+    if ( p_fair == (void *) 0     ) goto no_fair;
+    if ( tenant >= p_fair->tenants ) goto invalid_tenant;
+    if ( p_key  == (void *) 0     ) goto no_key;
+
+    // Initialized data
+    struct priority_queue_fair_tenant_s *p_tenant = &p_fair->p_tenants[tenant];
+
+    // Lock
+    mutex_lock(p_fair->_lock);
+
+    // State check
+    if ( p_tenant->count == p_fair->size ) goto tenant_full;
+
+    // Add the key to the tenant, with its cost over the weight of the tenant
+    priority_queue_fair_push(p_fair, p_tenant, p_key, (uint64_t) cost * PRIORITY_QUEUE_FAIR_SCALE / p_tenant->weight);
+
+    // An idle tenant joins the backlog
+    if ( p_tenant->count == 1 ) priority_queue_fair_backlog(p_fair, tenant);
+
+    // Count the key
+    p_fair->count++;
+
+    // Unlock
+    mutex_unlock(p_fair->_lock);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_fair:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_fair", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            invalid_tenant:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"tenant\" is out of range", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            tenant_full:
+
+                // Unlock
+                mutex_unlock(p_fair->_lock);
+
+                #ifndef NDEBUG
+                    priority_queue_error("Tenant is full", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_fair_dequeue ( priority_queue_fair *const p_fair, void **pp_key, size_t *p_tenant )
+{
+
+    // Argument check
+    if ( p_fair == (void *) 0 ) goto no_fair;
+    if ( pp_key == (void *) 0 ) goto no_key;
+
+    // Initialized data
+    struct priority_queue_fair_tenant_s *p_owner  = (void *) 0;
+    struct priority_queue_fair_entry_s   _entry   = { 0 };
+    void                                *p_next   = (void *) 0;
+    size_t                               tenant   = 0;
+
+    // Lock
+    mutex_lock(p_fair->_lock);
+
+    // State check
+    if ( p_fair->count == 0 ) goto underflow;
+
+    // Take the tenant with the earliest finish time
+    priority_queue_dequeue_priority(p_fair->p_backlog, &p_next, (void *) 0);
+    tenant   = (size_t) (uintptr_t) p_next - 1;
+    p_owner  = &p_fair->p_tenants[tenant];
+
+    // Take the highest priority key of the tenant
+    priority_queue_fair_pop(p_fair, p_owner, &_entry);
+    *pp_key = _entry.p_key;
+
+    // Charge the tenant the cost of the key it took, which may have passed the key 
+    // that was at its front when it joined the backlog
+    p_owner->last = p_owner->start + _entry.cost;
+
+    // Advance the virtual time to the finish of the key
+    if ( p_owner->last > p_fair->virtual_time ) p_fair->virtual_time = p_owner->last;
+    p_fair->count--;
+
+    // A tenant with more keys waits for the finish of its next key
+    if ( p_owner->count ) priority_queue_fair_backlog(p_fair, tenant);
+
+    // Unlock
+    mutex_unlock(p_fair->_lock);
+
+    // Return the tenant to the caller
+    if ( p_tenant ) *p_tenant = tenant;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_fair:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_fair", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            underflow:
+
+                // Unlock
+                mutex_unlock(p_fair->_lock);
+
+                #ifndef NDEBUG
+                    priority_queue_error("Fair queue is empty", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+#ifndef _WIN64
+int priority_queue_delay_enqueue ( priority_queue_delay *const p_delay, void *p_key, timestamp ready )
+{
+
+    // Argument check
+    if ( p_delay == (void *) 0 ) goto no_delay;
+    if ( p_key   == (void *) 0 ) goto no_key;
+
+    // Initialized data
+    int ret = 0;
+
+    // Lock
+    pthread_mutex_lock(&p_delay->_lock);
+
+    // State check
+    if ( p_delay->count == p_delay->size ) goto delay_full;
+
+    // A key that is ready skips the heap of delayed keys
+    if ( ready <= timer_high_precision() ) ret = priority_queue_enqueue(p_delay->p_eligible, p_key);
+    else                                   ret = priority_queue_enqueue_priority(p_delay->p_delayed, p_key, (priority_queue_priority) { .u64 = (uint64_t) ready });
+
+    // Error check
+    if ( ret == 0 ) goto failed_to_enqueue;
+
+    // Count the key
+    p_delay->count++;
+
+    // Wake a waiting thread, which takes the key, or sleeps until it is ready
+    if ( p_delay->waiters ) pthread_cond_signal(&p_delay->changed);
+
+    // Unlock
+    pthread_mutex_unlock(&p_delay->_lock);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_delay:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_delay", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            delay_full:
+
+                // Unlock
+                pthread_mutex_unlock(&p_delay->_lock);
+
+                #ifndef NDEBUG
+                    priority_queue_error("Delay queue is full", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_enqueue:
+
+                // Unlock
+                pthread_mutex_unlock(&p_delay->_lock);
+
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_enqueue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_delay_dequeue ( priority_queue_delay *const p_delay, void **pp_key )
+{
+
+    // Argument check
+    if ( p_delay == (void *) 0 ) goto no_delay;
+    if ( pp_key  == (void *) 0 ) goto no_key;
+
+    // Initialized data
+    int ret = 0;
+
+    // Lock
+    pthread_mutex_lock(&p_delay->_lock);
+
+    // Move every key that is ready, reading the timer once
+    if ( p_delay->p_delayed->entries.count ) priority_queue_delay_promote(p_delay, timer_high_precision());
+
+    // Take the highest priority key that is ready
+    if ( p_delay->p_eligible->entries.count ) ret = priority_queue_dequeue(p_delay->p_eligible, pp_key);
+
+    // Count the key
+    p_delay->count -= (size_t) ret;
+
+    // Unlock
+    pthread_mutex_unlock(&p_delay->_lock);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_delay:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_delay", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_delay_dequeue_wait ( priority_queue_delay *const p_delay, void **pp_key, timestamp deadline )
+{
+
+    // Argument check
+    if ( p_delay == (void *) 0 ) goto no_delay;
+    if ( pp_key  == (void *) 0 ) goto no_key;
+
+    // Initialized data
+    priority_queue  *p_delayed = p_delay->p_delayed;
+    int              ret       = 0;
+    timestamp        now       = 0,
+                     wake      = 0,
+                     divisor   = timer_seconds_divisor();
+    struct timespec  _until    = { 0 };
+
+    // Lock
+    pthread_mutex_lock(&p_delay->_lock);
+
+    // Wait for a key
+    for (;;)
+    {
+
+        // Move every key that is ready
+        now = timer_high_precision();
+        if ( p_delayed->entries.count ) priority_queue_delay_promote(p_delay, now);
+
+        // Take the highest priority key that is ready
+        if ( p_delay->p_eligible->entries.count ) { ret = priority_queue_dequeue(p_delay->p_eligible, pp_key); break; }
+
+        // Give up at the deadline
+        if ( deadline && now >= deadline ) break;
+
+        // Wake when the next key is ready, or at the deadline, whichever is first
+        wake = ( p_delayed->entries.count ) ? (timestamp) priority_queue_typed_load(p_delayed, 0).u64 : 0;
+        if ( deadline && ( wake == 0 || deadline < wake ) ) wake = deadline;
+
+        // Sleep until then, or until an enqueue
+        p_delay->waiters++;
+        if ( wake == 0 ) pthread_cond_wait(&p_delay->changed, &p_delay->_lock);
+        else
+        {
+
+            // Convert timer ticks to an absolute time on the monotonic clock
+            clock_gettime(CLOCK_MONOTONIC, &_until);
+            wake           -= now;
+            _until.tv_sec  += (time_t) ( wake / divisor );
+            _until.tv_nsec += (long) ( ( wake % divisor ) * 1000000000LL / divisor );
+            if ( _until.tv_nsec >= 1000000000L ) _until.tv_sec++, _until.tv_nsec -= 1000000000L;
+
+            // Sleep
+            pthread_cond_timedwait(&p_delay->changed, &p_delay->_lock, &_until);
+        }
+        p_delay->waiters--;
+    }
+
+    // Count the key
+    p_delay->count -= (size_t) ret;
+
+    // Unlock
+    pthread_mutex_unlock(&p_delay->_lock);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_delay:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_delay", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+#endif
+
+int priority_queue_drain_sorted ( priority_queue *const p_priority_queue, void ***ppp_keys, size_t *p_count )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( ppp_keys         == (void *) 0 ) goto no_keys;
+    if ( p_count          == (void *) 0 ) goto no_count;
+
+    // State check
+    if ( p_priority_queue->external.block_size                      ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE ) goto unsupported;
+
+    // Initialized data
+    void   **p_replacement = PRIORITY_QUEUE_REALLOC(0, p_priority_queue->entries.max * sizeof(void *)),
+           **p_sorted      = (void *) 0;
+    size_t   count         = 0;
+
+    // Error checking
+    if ( p_replacement == (void *) 0 ) goto no_mem;
+
+    // Start timing
+    PRIORITY_QUEUE_HISTOGRAM_START(t0);
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Remove dead keys
+    if ( p_priority_queue->tombstones.count ) priority_queue_compact(p_priority_queue);
+
+    // Initialized data
+    count    = p_priority_queue->entries.count;
+    p_sorted = p_priority_queue->entries.data;
+
+    // Empty the levels of a bucket queue into the replacement, in ascending order of priority ...
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL )
+    {
+
+        // Remove each key
+        for (size_t i = count; i-- > 0;)
+            priority_queue_bucket_pop(p_priority_queue, &p_replacement[i], (void *) 0);
+
+        // Hand the replacement to the caller
+        p_sorted = p_replacement;
+    }
+
+    // ... or remove the keys of a typed heap into the replacement. Compact heaps unpack their indices ...
+    else if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+    {
+
+        // Remove each key
+        priority_queue_typed_sort(p_priority_queue, p_replacement);
+
+        // Hand the replacement to the caller
+        p_sorted = p_replacement;
+    }
+
+    // ... or sort the keys in place, in ascending order of priority
+    else
+        priority_queue_build_heap_sort(p_priority_queue);
+
+    // Gather the keys of a blocked heap into the replacement, in logical order ...
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED )
+    {
+
+        // Copy each key
+        for (size_t i = 0; i < count; i++)
+            p_replacement[i] = p_sorted[priority_queue_physical(p_priority_queue, i)];
+
+        // Hand the replacement to the caller
+        p_sorted = p_replacement;
+    }
+
+    // Reverse the keys, so the highest priority comes first
+    for (size_t i = 0, j = count; i + 1 < j; i++, j--)
+    {
+
+        // Swap the keys
+        void *tmp       = p_sorted[i];
+        p_sorted[i]     = p_sorted[j - 1];
+        p_sorted[j - 1] = tmp;
+    }
+
+    // Blocked heaps, bucket queues, and typed heaps keep their own entries
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED || p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+        ;
+
+    // A memory mapped heap can not be handed to the caller ...
+    else if ( p_priority_queue->mapped.p_base )
+    {
+
+        // ... so the sorted keys are copied out
+        memcpy(p_replacement, p_sorted, count * sizeof(void *));
+        p_sorted = p_replacement;
+    }
+
+    // Otherwise, hand the entries to the caller, and keep the replacement
+    else
+        p_priority_queue->entries.data = p_replacement;
+
+    // Empty the priority queue
+    p_priority_queue->entries.count = 0;
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Time the drain
+    PRIORITY_QUEUE_HISTOGRAM_RECORD(p_priority_queue, PRIORITY_QUEUE_OPERATION_DRAIN, t0);
+
+    // Return the sorted keys to the caller
+    *ppp_keys = p_sorted;
+    *p_count  = count;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_keys:
+                #ifndef NDEBUG
+                    priority_queue_error_null("ppp_keys", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_count:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_count", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Free the replacement
+                PRIORITY_QUEUE_REALLOC(p_replacement, 0);
+
+                // Error
+                return 0;
+
+            unsupported:
+                #ifndef NDEBUG
+                    priority_queue_error("External and sequence priority queues can not be drained in place", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_sorted_copy_parallel ( priority_queue *const p_priority_queue, void ***ppp_keys, size_t *p_count, size_t threads )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( ppp_keys         == (void *) 0 ) goto no_keys;
+    if ( p_count          == (void *) 0 ) goto no_count;
+
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR ) goto unsupported;
+    if ( p_priority_queue->external.block_size                              ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE         ) goto unsupported;
+
+    // Initialized data
+    void                           **p_snapshot = PRIORITY_QUEUE_REALLOC(0, ( p_priority_queue->entries.max + 1 ) * sizeof(void *)),
+                                   **p_scratch  = (void *) 0;
+    struct priority_queue_merger_s   _merger    = { 0 };
+    size_t                           count      = 0;
+
+    // Error checking
+    if ( p_snapshot == (void *) 0 ) goto no_mem;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Remove dead keys
+    if ( p_priority_queue->tombstones.count ) priority_queue_compact(p_priority_queue);
+
+    // Copy the keys, in logical order
+    count = p_priority_queue->entries.count;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED )
+        for (size_t i = 0; i < count; i++) p_snapshot[i] = p_priority_queue->entries.data[priority_queue_physical(p_priority_queue, i)];
+    else
+        memcpy(p_snapshot, p_priority_queue->entries.data, count * sizeof(void *));
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Use one thread per processor
+    #ifndef _WIN64
+        if ( threads == 0 ) threads = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+        threads = 1;
+    #endif
+
+    // Give each thread enough keys to be worth starting
+    if ( threads > count / PRIORITY_QUEUE_PARALLEL_SORT_MIN ) threads = count / PRIORITY_QUEUE_PARALLEL_SORT_MIN;
+    if ( threads < 1                                        ) threads = 1;
+
+    // Allocate scratch space
+    p_scratch = PRIORITY_QUEUE_REALLOC(0, ( count + 1 ) * sizeof(void *));
+
+    // Error checking
+    if ( p_scratch == (void *) 0 ) goto no_scratch;
+
+    // Sort small snapshots on this thread
+    if ( threads == 1 )
+    {
+
+        // Sort the snapshot
+        priority_queue_merge_sort(p_priority_queue, p_snapshot, p_scratch, count);
+
+        // Release the scratch space
+        p_scratch = PRIORITY_QUEUE_REALLOC(p_scratch, 0);
+
+        // Return the sorted keys to the caller
+        *ppp_keys = p_snapshot;
+        *p_count  = count;
+
+        // Success
+        return 1;
+    }
+
+    #ifndef _WIN64
+    {
+
+        // Initialized data
+        struct priority_queue_sort_task_s *p_tasks   = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(struct priority_queue_sort_task_s));
+        pthread_t                         *p_threads = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(pthread_t));
+        bool                              *p_started = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(bool));
+
+        // Allocate a merger with a run for each partition
+        _merger.p_runs    = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(struct priority_queue_run_s));
+        _merger.p_tree    = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(size_t));
+        _merger.p_winners = PRIORITY_QUEUE_REALLOC(0, 2 * threads * sizeof(size_t));
+
+        // Error checking
+        if ( p_tasks == (void *) 0 || p_threads == (void *) 0 || p_started == (void *) 0 || _merger.p_runs == (void *) 0 || _merger.p_tree == (void *) 0 || _merger.p_winners == (void *) 0 )
+        {
+
+            // Release whatever was allocated
+            if ( p_tasks           ) p_tasks           = PRIORITY_QUEUE_REALLOC(p_tasks          , 0);
+            if ( p_threads         ) p_threads         = PRIORITY_QUEUE_REALLOC(p_threads        , 0);
+            if ( p_started         ) p_started         = PRIORITY_QUEUE_REALLOC(p_started        , 0);
+            if ( _merger.p_runs    ) _merger.p_runs    = PRIORITY_QUEUE_REALLOC(_merger.p_runs   , 0);
+            if ( _merger.p_tree    ) _merger.p_tree    = PRIORITY_QUEUE_REALLOC(_merger.p_tree   , 0);
+            if ( _merger.p_winners ) _merger.p_winners = PRIORITY_QUEUE_REALLOC(_merger.p_winners, 0);
+
+            // Error
+            goto no_merger;
+        }
+
+        // Start a worker for each partition but the first
+        for (size_t i = 0; i < threads; i++)
+        {
+
+            // Initialized data
+            size_t lo = count *   i       / threads,
+                   hi = count * ( i + 1 ) / threads;
+
+            // Describe the work
+            p_tasks[i]   = (struct priority_queue_sort_task_s) { .p_priority_queue = p_priority_queue, .p_keys = &p_snapshot[lo], .p_scratch = &p_scratch[lo], .count = hi - lo };
+            p_started[i] = ( i > 0 ) && ( pthread_create(&p_threads[i], (void *) 0, priority_queue_sort_worker, &p_tasks[i]) == 0 );
+        }
+
+        // Sort the first partition here, and any partition whose thread could not start
+        for (size_t i = 0; i < threads; i++)
+            if ( p_started[i] == false ) priority_queue_sort_worker(&p_tasks[i]);
+
+        // Wait for the workers
+        for (size_t i = 1; i < threads; i++)
+            if ( p_started[i] ) pthread_join(p_threads[i], (void *) 0);
+
+        // Each sorted partition is a run of the merger
+        for (size_t i = 0; i < threads; i++)
+            _merger.p_runs[i] = (struct priority_queue_run_s) { .p_keys = p_tasks[i].p_keys, .p_head = p_tasks[i].p_keys[0], .remaining = p_tasks[i].count };
+        _merger.run_count = threads;
+        _merger.count     = count;
+
+        // Merge the runs into the scratch space
+        priority_queue_loser_tree_build(p_priority_queue, &_merger);
+        for (size_t i = 0; i < count; i++)
+            p_scratch[i] = priority_queue_sequence_pop(p_priority_queue, &_merger);
+
+        // Release the workers, and the merger
+        p_tasks           = PRIORITY_QUEUE_REALLOC(p_tasks          , 0);
+        p_threads         = PRIORITY_QUEUE_REALLOC(p_threads        , 0);
+        p_started         = PRIORITY_QUEUE_REALLOC(p_started        , 0);
+        _merger.p_runs    = PRIORITY_QUEUE_REALLOC(_merger.p_runs   , 0);
+        _merger.p_tree    = PRIORITY_QUEUE_REALLOC(_merger.p_tree   , 0);
+        _merger.p_winners = PRIORITY_QUEUE_REALLOC(_merger.p_winners, 0);
+    }
+    #endif
+
+    // Release the snapshot
+    p_snapshot = PRIORITY_QUEUE_REALLOC(p_snapshot, 0);
+
+    // Return the sorted keys to the caller
+    *ppp_keys = p_scratch;
+    *p_count  = count;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_keys:
+                #ifndef NDEBUG
+                    priority_queue_error_null("ppp_keys", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_count:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_count", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            unsupported:
+                #ifndef NDEBUG
+                    priority_queue_error("Typed, external, and sequence priority queues can not be copied", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            #ifndef _WIN64
+            no_merger:
+
+                // Release the scratch space
+                p_scratch = PRIORITY_QUEUE_REALLOC(p_scratch, 0);
+            #endif
+
+            no_scratch:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Release the snapshot
+                p_snapshot = PRIORITY_QUEUE_REALLOC(p_snapshot, 0);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+bool priority_queue_empty ( priority_queue *const p_priority_queue )
+{
+    
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Initialized data
+    bool ret = ( priority_queue_live(p_priority_queue) == 0 );
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Success
+    return ret;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Error
+                return true;
+        }
+    }
+}
+
+bool priority_queue_fair_empty ( priority_queue_fair *const p_fair )
+{
+
+    // Argument check
+    if ( p_fair == (void *) 0 ) goto no_fair;
+
+    // Lock
+    mutex_lock(p_fair->_lock);
+
+    // Initialized data
+    bool ret = ( p_fair->count == 0 );
+
+    // Unlock
+    mutex_unlock(p_fair->_lock);
+
+    // Success
+    return ret;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_fair:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_fair", __FUNCTION__);
+                #endif
+
+                // Error
+                return true;
+        }
+    }
+}
+
+#ifndef _WIN64
+int priority_queue_delay_next ( priority_queue_delay *const p_delay, timestamp *p_ready )
+{
+
+    // Argument check
+    if ( p_delay == (void *) 0 ) goto no_delay;
+    if ( p_ready == (void *) 0 ) goto no_ready;
+
+    // Initialized data
+    int ret = 1;
+
+    // Lock
+    pthread_mutex_lock(&p_delay->_lock);
+
+    // A ready key is ready now. Else, the earliest delayed key is next
+    if      ( p_delay->p_eligible->entries.count ) *p_ready = timer_high_precision();
+    else if ( p_delay->p_delayed->entries.count  ) *p_ready = (timestamp) priority_queue_typed_load(p_delay->p_delayed, 0).u64;
+    else                                           ret      = 0;
+
+    // Unlock
+    pthread_mutex_unlock(&p_delay->_lock);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_delay:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_delay", __FUNCTION__);
+                #endif
+                return 0;
+
+            no_ready:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_ready", __FUNCTION__);
+                #endif
+                return 0;
+        }
+    }
+}
+#endif
+
+int priority_queue_peek ( priority_queue *const p_priority_queue, void **pp_key )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( pp_key           == (void *) 0 ) goto no_key;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Get the front of the priority queue
+    if ( priority_queue_max(p_priority_queue, pp_key) == 0 ) goto failed_to_get_max_key;
+
+    // Remove dead keys from the front
+    while ( p_priority_queue->tombstones.count && priority_queue_tombstone_take(p_priority_queue, *pp_key) )
+    {
+
+        // Copy the entries shared with a snapshot
+        if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+        // Remove the dead key
+        priority_queue_extract_max(p_priority_queue, (void *) 0);
+
+        // Get the new front
+        if ( priority_queue_max(p_priority_queue, pp_key) == 0 ) goto failed_to_get_max_key;
+    }
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_key:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_key", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_get_max_key:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_max", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_get_fd ( priority_queue *const p_priority_queue )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    #ifdef PRIORITY_QUEUE_EVENTFD
+
+        // Lock
+        priority_queue_lock(p_priority_queue);
+
+        // Make the eventfd once
+        if ( p_priority_queue->notify.open == false )
+        {
+
+            // Make a non blocking eventfd
+            p_priority_queue->notify.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            // Error checking
+            if ( p_priority_queue->notify.fd == -1 ) goto failed_to_make_eventfd;
+
+            // The unchecked functions do not update the eventfd
+            p_priority_queue->notify.open = true,
+            p_priority_queue->inline_path = false;
+        }
+
+        // Unlock, which makes the eventfd readable if the priority queue holds keys
+        priority_queue_unlock(p_priority_queue);
+
+        // Success
+        return p_priority_queue->notify.fd;
+    #else
+
+        // Unsupported
+        goto no_eventfd;
+    #endif
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return -1;
+        }
+
+        // Standard library errors
+        {
+            #ifdef PRIORITY_QUEUE_EVENTFD
+            failed_to_make_eventfd:
+                #ifndef NDEBUG
+                    priority_queue_error_call("eventfd", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return -1;
+            #else
+            no_eventfd:
+                #ifndef NDEBUG
+                    priority_queue_error("eventfd is not available on this platform", __FUNCTION__);
+                #endif
+
+                // Error
+                return -1;
+            #endif
+        }
+    }
+}
+
+int priority_queue_for_each ( priority_queue *const p_priority_queue, priority_queue_for_each_fn *pfn_for_each, void *p_context )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( pfn_for_each     == (void *) 0 ) goto no_for_each;
+
+    // State check
+    if ( p_priority_queue->external.block_size                      ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE ) goto unsupported;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Visit the levels of a bucket queue ...
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL )
+    {
+        for (size_t level = 0; level < p_priority_queue->bucket.levels; level++)
+            for (size_t slot = p_priority_queue->bucket.p_head[level]; slot != SIZE_MAX; slot = p_priority_queue->bucket.p_next[slot])
+                if ( pfn_for_each(p_priority_queue->entries.data[slot], p_context) == 0 ) goto done;
+    }
+
+    // ... or the indices of a compact heap ...
+    else if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX )
+    {
+        for (size_t i = 0; i < p_priority_queue->entries.count; i++)
+            if ( pfn_for_each((void *) (uintptr_t) PRIORITY_QUEUE_COMPACT_INDEX(( (uint64_t *) p_priority_queue->typed.p_priorities )[i]), p_context) == 0 ) goto done;
+    }
+
+    // ... or the heap, in the order of its slots
+    else
+        for (size_t i = 0; i < p_priority_queue->entries.count; i++)
+            if ( pfn_for_each(p_priority_queue->entries.data[priority_queue_physical(p_priority_queue, i)], p_context) == 0 ) goto done;
+
+    done:
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_for_each:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pfn_for_each", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            unsupported:
+                #ifndef NDEBUG
+                    priority_queue_error("External and sequence priority queues can not be iterated", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_snapshot_acquire ( priority_queue *const p_priority_queue, priority_queue_snapshot **const pp_snapshot )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( pp_snapshot      == (void *) 0 ) goto no_snapshot;
+
+    // State check
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL ) goto unsupported;
+    if ( p_priority_queue->external.block_size                         ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE    ) goto unsupported;
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_INDEX ) goto unsupported;
+    if ( p_priority_queue->mapped.p_base                               ) goto unsupported;
+
+    // Initialized data
+    struct priority_queue_snapshot_s *p_snapshot = (void *) 0;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Share the snapshot of the entries, if they have not changed since it was made ...
+    if ( p_priority_queue->p_snapshot )
+    {
+        p_snapshot = p_priority_queue->p_snapshot;
+        atomic_fetch_add_explicit(&p_snapshot->references, 1, memory_order_relaxed);
+    }
+
+    // ... or make a snapshot, which shares the entries until the next modification
+    else
+    {
+
+        // Allocate a snapshot
+        p_snapshot = PRIORITY_QUEUE_REALLOC(0, sizeof(struct priority_queue_snapshot_s));
+
+        // Error checking
+        if ( p_snapshot == (void *) 0 ) goto no_mem;
+
+        // Populate the snapshot
+        *p_snapshot = (struct priority_queue_snapshot_s)
+        {
+            .p_keys       = p_priority_queue->entries.data,
+            .p_allocation = (void *) 0,
+            .count        = p_priority_queue->entries.count,
+            .layout       = p_priority_queue->layout
+        };
+
+        // One reference for the caller, and one for the priority queue
+        atomic_init(&p_snapshot->references, 2);
+
+        // Share the entries
+        p_priority_queue->p_snapshot = p_snapshot;
+    }
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Return a pointer to the caller
+    *pp_snapshot = p_snapshot;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_snapshot:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pp_snapshot", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            unsupported:
+                #ifndef NDEBUG
+                    priority_queue_error("Bucket, compact, external, sequence, and memory mapped priority queues can not be snapshot", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+size_t priority_queue_snapshot_count ( const priority_queue_snapshot *const p_snapshot )
+{
+
+    // Argument check
+    if ( p_snapshot == (void *) 0 ) goto no_snapshot;
+
+    // Success
+    return p_snapshot->count;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_snapshot:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_snapshot", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_snapshot_for_each ( const priority_queue_snapshot *const p_snapshot, priority_queue_for_each_fn *pfn_for_each, void *p_context )
+{
+
+    // Argument check
+    if ( p_snapshot   == (void *) 0 ) goto no_snapshot;
+    if ( pfn_for_each == (void *) 0 ) goto no_for_each;
+
+    // Visit the keys, without the lock. The priority queue copies its entries before 
+    // modifying them, so these keys do not change
+    for (size_t i = 0; i < p_snapshot->count; i++)
+    {
+
+        // Initialized data
+        size_t slot = ( p_snapshot->layout == PRIORITY_QUEUE_LAYOUT_BLOCKED ) ? ( i / PRIORITY_QUEUE_BLOCK_KEYS ) * PRIORITY_QUEUE_BLOCK_SLOTS + i % PRIORITY_QUEUE_BLOCK_KEYS : i;
+
+        // Visit the key
+        if ( pfn_for_each(p_snapshot->p_keys[slot], p_context) == 0 ) break;
+    }
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_snapshot:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_snapshot", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_for_each:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pfn_for_each", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+int priority_queue_stats ( priority_queue *const p_priority_queue, priority_queue_statistics *const p_statistics )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_statistics     == (void *) 0 ) goto no_statistics;
+
+    #ifdef PRIORITY_QUEUE_STATS
+
+        // Initialized data
+        priority_queue_statistics _statistics = { 0 };
+
+        // Merge the stripes
+        for (size_t i = 0; i < PRIORITY_QUEUE_STATS_STRIPES; i++)
+        {
+
+            // Initialized data
+            struct priority_queue_stats_stripe_s *p_stripe  = &p_priority_queue->stats.stripes[i];
+            uint64_t                              depth     = atomic_load_explicit(&p_stripe->max_sift_depth, memory_order_relaxed),
+                                                  watermark = atomic_load_explicit(&p_stripe->high_water    , memory_order_relaxed);
+
+            // Sum the counters
+            _statistics.enqueues               += atomic_load_explicit(&p_stripe->enqueues              , memory_order_relaxed);
+            _statistics.dequeues               += atomic_load_explicit(&p_stripe->dequeues              , memory_order_relaxed);
+            _statistics.comparisons            += atomic_load_explicit(&p_stripe->comparisons           , memory_order_relaxed);
+            _statistics.swaps                  += atomic_load_explicit(&p_stripe->swaps                 , memory_order_relaxed);
+            _statistics.sifts                  += atomic_load_explicit(&p_stripe->sifts                 , memory_order_relaxed);
+            _statistics.sift_levels            += atomic_load_explicit(&p_stripe->sift_levels           , memory_order_relaxed);
+            _statistics.overflows              += atomic_load_explicit(&p_stripe->overflows             , memory_order_relaxed);
+            _statistics.lock_acquisitions      += atomic_load_explicit(&p_stripe->lock_acquisitions     , memory_order_relaxed);
+            _statistics.contended_acquisitions += atomic_load_explicit(&p_stripe->contended_acquisitions, memory_order_relaxed);
+            _statistics.lock_wait_ns           += atomic_load_explicit(&p_stripe->lock_wait_ns          , memory_order_relaxed);
+
+            // Take the largest maxima
+            if ( depth     > _statistics.max_sift_depth ) _statistics.max_sift_depth = depth;
+            if ( watermark > _statistics.high_water     ) _statistics.high_water     = watermark;
+        }
+
+        // Return a pointer to the caller
+        *p_statistics = _statistics;
+
+        // Success
+        return 1;
+    #else
+
+        // Not compiled in
+        goto no_statistics_support;
+    #endif
+
+    // Error handling
+    {
+
+        // Argument errors
+        {
+            no_priority_queue:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_statistics:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_statistics", __FUNCTION__);
+                #endif
 
-int priority_queue_create ( priority_queue **const pp_priority_queue )
+                // Error
+                return 0;
+        }
+
+        #ifndef PRIORITY_QUEUE_STATS
+
+            // Priority queue errors
+            {
+                no_statistics_support:
+                    #ifndef NDEBUG
+                        priority_queue_error("Statistics are not compiled in. Build with PRIORITY_QUEUE_STATS", __FUNCTION__);
+                    #endif
+
+                    // Error
+                    return 0;
+            }
+        #endif
+    }
+}
+
+int priority_queue_stats_reset ( priority_queue *const p_priority_queue )
 {
 
     // Argument check
-    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
 
-    // Allocate memory for a priority queue
-    priority_queue *p_priority_queue = PRIORITY_QUEUE_REALLOC(0, sizeof(priority_queue));
+    #ifdef PRIORITY_QUEUE_STATS
 
-    // Error checking
-    if ( p_priority_queue == (void *) 0 ) goto no_mem;
+        // Zero each stripe
+        for (size_t i = 0; i < PRIORITY_QUEUE_STATS_STRIPES; i++)
+        {
 
-    // Zero set
-    memset(p_priority_queue, 0, sizeof(priority_queue));
+            // Initialized data
+            struct priority_queue_stats_stripe_s *p_stripe = &p_priority_queue->stats.stripes[i];
+
+            // Zero the counters
+            atomic_store_explicit(&p_stripe->enqueues              , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->dequeues              , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->comparisons           , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->swaps                 , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->sifts                 , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->sift_levels           , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->max_sift_depth        , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->high_water            , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->overflows             , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->lock_acquisitions     , 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->contended_acquisitions, 0, memory_order_relaxed);
+            atomic_store_explicit(&p_stripe->lock_wait_ns          , 0, memory_order_relaxed);
+        }
 
-    // Return the allocated memory
-    *pp_priority_queue = p_priority_queue;
+        // Success
+        return 1;
+    #else
 
-    // Success
-    return 1;
+        // Not compiled in
+        goto no_statistics_support;
+    #endif
 
     // Error handling
     {
@@ -140,18 +8291,65 @@ int priority_queue_create ( priority_queue **const pp_priority_queue )
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
         }
 
-        // Standard library errors
+        #ifndef PRIORITY_QUEUE_STATS
+
+            // Priority queue errors
+            {
+                no_statistics_support:
+                    #ifndef NDEBUG
+                        priority_queue_error("Statistics are not compiled in. Build with PRIORITY_QUEUE_STATS", __FUNCTION__);
+                    #endif
+
+                    // Error
+                    return 0;
+            }
+        #endif
+    }
+}
+
+int priority_queue_histogram_merge ( priority_queue_histogram *const p_histogram, const priority_queue_histogram *const p_other )
+{
+
+    // Argument check
+    if ( p_histogram == (void *) 0 ) goto no_histogram;
+    if ( p_other     == (void *) 0 ) goto no_other;
+
+    // Take the extremes
+    if ( p_other->count && ( p_histogram->count == 0 || p_other->min < p_histogram->min ) ) p_histogram->min = p_other->min;
+    if ( p_other->max > p_histogram->max ) p_histogram->max = p_other->max;
+
+    // Add the buckets, the count, and the sum
+    for (size_t i = 0; i < PRIORITY_QUEUE_HISTOGRAM_BUCKETS; i++)
+        p_histogram->counts[i] += p_other->counts[i];
+    p_histogram->count += p_other->count;
+    p_histogram->sum   += p_other->sum;
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
         {
-            no_mem:
+            no_histogram:
                 #ifndef NDEBUG
-                    printf("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_histogram", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_other:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_other", __FUNCTION__);
                 #endif
 
                 // Error
@@ -160,43 +8358,59 @@ int priority_queue_create ( priority_queue **const pp_priority_queue )
     }
 }
 
-int priority_queue_construct ( priority_queue **const pp_priority_queue, size_t size, priority_queue_equal_fn pfn_compare_function )
+int priority_queue_trace_set ( const priority_queue_trace *const p_trace )
 {
 
-    // Argument check
-    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
-    if ( size              ==          0 ) goto zero_size;
+    #ifdef PRIORITY_QUEUE_TRACE
 
-    // Initialized data
-    priority_queue *p_priority_queue = 0;
+        // Publish the callback table
+        atomic_store_explicit(&priority_queue_trace_callbacks, p_trace, memory_order_release);
 
-    // Allocate a priority queue
-    if ( priority_queue_create(pp_priority_queue) == 0 ) goto failed_to_create_priority_queue;
+        // Success
+        return 1;
+    #else
 
-    // Get a pointer to the allocated priority queue
-    p_priority_queue = *pp_priority_queue;
+        // Not compiled in
+        (void) p_trace;
+        goto no_trace_support;
+    #endif
+
+    // Error handling
+    {
 
-    // Set the count and iterator max
-    p_priority_queue->entries.max  = size;
+        #ifndef PRIORITY_QUEUE_TRACE
 
-    // Allocate "size" number of properties
-    p_priority_queue->entries.data = PRIORITY_QUEUE_REALLOC(0, size * sizeof(void *));
+            // Priority queue errors
+            {
+                no_trace_support:
+                    #ifndef NDEBUG
+                        priority_queue_error("Tracepoints are not compiled in. Build with PRIORITY_QUEUE_TRACE", __FUNCTION__);
+                    #endif
 
-    // Zero set the allocated memory
-    memset(p_priority_queue->entries.data, 0, size * sizeof(void *));
+                    // Error
+                    return 0;
+            }
+        #endif
+    }
+}
 
-    // Create a mutex
-    if ( mutex_create(&p_priority_queue->_lock) == 0 ) goto failed_to_create_mutex;
+int priority_queue_aging_set ( priority_queue *const p_priority_queue, uint64_t rate )
+{
 
-    // Set the comparator function
-    // TODO: Improve documentation
-    if ( pfn_compare_function == (void *) 0 )
-        p_priority_queue->pfn_compare_function = priority_queue_compare_function;
-    else
-        p_priority_queue->pfn_compare_function = pfn_compare_function;
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
 
-    // Error checking
-    if ( p_priority_queue->entries.data == (void *) 0 ) goto no_mem;
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_U64 ) goto unsupported;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Store the rate
+    p_priority_queue->aging.rate = rate;
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
 
     // Success
     return 1;
@@ -208,35 +8422,81 @@ int priority_queue_construct ( priority_queue **const pp_priority_queue, size_t
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
+        }
 
-            zero_size:
+        // Priority queue errors
+        {
+            unsupported:
                 #ifndef NDEBUG
-                    printf("[priority queue] Zero provided for parameter \"size\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Only priority queues of 64 bit unsigned integer priorities can age", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
-
         }
+    }
+}
 
-        // Priority queue errors
+int priority_queue_invalidate ( priority_queue *const p_priority_queue, void *p_key )
+{
+
+    // Argument check
+    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR &&
+         p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_INDEX      ) goto unsupported;
+    if ( p_priority_queue->external.block_size                              ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE         ) goto unsupported;
+
+    // Initialized data
+    double threshold = 0;
+
+    // Lock
+    priority_queue_lock(p_priority_queue);
+
+    // Get the threshold, which priority_queue_compact_threshold_set writes under the lock
+    threshold = ( p_priority_queue->tombstones.threshold > 0 ) ? p_priority_queue->tombstones.threshold : PRIORITY_QUEUE_TOMBSTONE_THRESHOLD;
+
+    // Mark the key as dead
+    if ( priority_queue_tombstone_add(p_priority_queue, p_key) == 0 ) goto no_mem;
+
+    // The unchecked functions do not skip dead keys
+    p_priority_queue->inline_path = false;
+
+    // Compact the heap, when too many keys are dead
+    if ( (double) p_priority_queue->tombstones.count > threshold * (double) p_priority_queue->entries.count ) priority_queue_compact(p_priority_queue);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Argument errors
         {
-            failed_to_create_priority_queue:
+            no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Failed to create priority queue in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
+        }
 
-            failed_to_create_mutex:
+        // Priority queue errors
+        {
+            unsupported:
                 #ifndef NDEBUG
-                    printf("[priority queue] Failed to create mutex in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Typed priority queues other than compact heaps, external, and sequence priority queues can not invalidate keys", __FUNCTION__);
                 #endif
 
                 // Error
@@ -247,42 +8507,33 @@ int priority_queue_construct ( priority_queue **const pp_priority_queue, size_t
         {
             no_mem:
                 #ifndef NDEBUG
-                    printf("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
                 #endif
 
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
                 // Error
                 return 0;
         }
     }
 }
 
-int priority_queue_from_keys ( const priority_queue **const pp_priority_queue, const char **const keys, size_t size, priority_queue_equal_fn pfn_compare_function )
+int priority_queue_compact_threshold_set ( priority_queue *const p_priority_queue, double threshold )
 {
 
     // Argument check
-    if ( pp_priority_queue == (void *) 0 ) goto no_priority_queue;
-    if ( keys              == (void *) 0 ) goto no_keys;
-
-    // TODO: replace with a goto
-    if ( size == 0 ) return 0;
-
-    // Initialized data
-    priority_queue *p_priority_queue = 0;
-
-    // Allocate a priority queue
-    if ( priority_queue_construct(&p_priority_queue, size, pfn_compare_function) == 0 ) goto failed_to_construct_priority_queue;
+    if ( p_priority_queue == (void *) 0     ) goto no_priority_queue;
+    if ( threshold < 0   || threshold > 1   ) goto invalid_threshold;
 
-    // Iterate over each key
-    for (size_t i = 0; keys[i]; i++)
-
-        // Add the key to the priority queue
-        p_priority_queue->entries.data[i] = keys[i];
+    // Lock
+    priority_queue_lock(p_priority_queue);
 
-    // Build the priority queue
-    priority_queue_build_max_heap(p_priority_queue);
+    // Store the threshold
+    p_priority_queue->tombstones.threshold = threshold;
 
-    // Return
-    *pp_priority_queue = p_priority_queue;
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
 
     // Success
     return 1;
@@ -294,73 +8545,116 @@ int priority_queue_from_keys ( const priority_queue **const pp_priority_queue, c
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
 
-            no_keys:
+            invalid_threshold:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"keys\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Parameter \"threshold\" must be between 0 and 1", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
-
         }
+    }
+}
 
-        // priority queue errors
-        {
-            failed_to_construct_priority_queue:
-                #ifndef NDEBUG
-                    printf("[priority queue] Call to \"priority_queue_construct\" returned an erroneous value in call to function \"%s\"\n", __FUNCTION__);
-                #endif
+int priority_queue_reprioritize ( priority_queue *const p_priority_queue, priority_queue_reprioritize_fn *pfn_reprioritize, void *p_context )
+{
 
-                // Error
-                return 0;
-        }
-    }
+    // Sweep on this thread
+    return priority_queue_reprioritize_parallel(p_priority_queue, pfn_reprioritize, p_context, 1);
 }
 
-int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i )
+int priority_queue_reprioritize_parallel ( priority_queue *const p_priority_queue, priority_queue_reprioritize_fn *pfn_reprioritize, void *p_context, size_t threads )
 {
 
     // Argument check
     if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
-    // TODO: Bounds check parameter i
-    // TODO: Lock
+    if ( pfn_reprioritize == (void *) 0 ) goto no_reprioritize;
+
+    // State check
+    if ( p_priority_queue->typed.type == PRIORITY_QUEUE_PRIORITY_LEVEL ) goto unsupported;
+    if ( p_priority_queue->external.block_size                         ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE    ) goto unsupported;
 
     // Initialized data
-    size_t l = PRIORITY_QUEUE_LEFT(i);
-    size_t r = PRIORITY_QUEUE_RIGHT(i);
-    size_t largest = i;
+    struct priority_queue_reprioritize_task_s _task = { .p_priority_queue = p_priority_queue, .pfn_reprioritize = pfn_reprioritize, .p_context = p_context };
+    size_t                                    count = 0;
 
-    // If the lefthand value is greater than the root ...
-    if ( ( l < p_priority_queue->entries.count ) && ( p_priority_queue->pfn_compare_function(p_priority_queue->entries.data[l], p_priority_queue->entries.data[largest]) > 0 ) )
+    // Use one thread per processor
+    #ifndef _WIN64
+        if ( threads == 0 ) threads = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+        threads = 1;
+    #endif
 
-        // ... update the index of the largest value
-        largest = l;
-    
-    // If the righthand value is greater than the root ...
-    if ( ( r < p_priority_queue->entries.count ) && ( p_priority_queue->pfn_compare_function(p_priority_queue->entries.data[r], p_priority_queue->entries.data[largest]) > 0 ) )
+    // Lock
+    priority_queue_lock(p_priority_queue);
 
-        // ... update the index of the largest value
-        largest = r;
-    
-    // If the index of the largest value must be updated ...
-    if ( largest != i )
+    // Copy the entries shared with a snapshot
+    if ( p_priority_queue->p_snapshot && priority_queue_unshare(p_priority_queue) == 0 ) goto failed_to_unshare;
+
+    // Remove dead keys, so the callback only sees live keys
+    if ( p_priority_queue->tombstones.count ) priority_queue_compact(p_priority_queue);
+
+    // Initialized data
+    count    = p_priority_queue->entries.count;
+    _task.hi = count;
+
+    // Small heaps are swept on this thread
+    if ( threads < 2 || count < PRIORITY_QUEUE_PARALLEL_BUILD_MIN ) priority_queue_reprioritize_worker(&_task);
+
+    #ifndef _WIN64
+    else
     {
 
-        // Swap the keys
-        void *tmp = p_priority_queue->entries.data[i];
-        p_priority_queue->entries.data[i] = p_priority_queue->entries.data[largest];
-        p_priority_queue->entries.data[largest] = tmp;
+        // Initialized data
+        struct priority_queue_reprioritize_task_s *p_tasks   = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(struct priority_queue_reprioritize_task_s));
+        pthread_t                                 *p_threads = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(pthread_t));
+        bool                                      *p_started = PRIORITY_QUEUE_REALLOC(0, threads * sizeof(bool));
+
+        // Sweep on this thread, if the workers can not be described
+        if ( p_tasks == (void *) 0 || p_threads == (void *) 0 || p_started == (void *) 0 )
+            priority_queue_reprioritize_worker(&_task);
 
-        // Recursively build the heap
-        // TODO: Check return code
-        priority_queue_heapify(p_priority_queue, largest);
+        // Otherwise, start a worker for each range but the first
+        else
+        {
+            for (size_t i = 0; i < threads; i++)
+            {
+
+                // Describe the work
+                p_tasks[i]    = _task;
+                p_tasks[i].lo = count *   i       / threads;
+                p_tasks[i].hi = count * ( i + 1 ) / threads;
+                p_started[i]  = ( i > 0 ) && ( pthread_create(&p_threads[i], (void *) 0, priority_queue_reprioritize_worker, &p_tasks[i]) == 0 );
+            }
+
+            // Sweep the first range here, and any range whose thread could not start
+            for (size_t i = 0; i < threads; i++)
+                if ( p_started[i] == false ) priority_queue_reprioritize_worker(&p_tasks[i]);
+
+            // Wait for the workers
+            for (size_t i = 1; i < threads; i++)
+                if ( p_started[i] ) pthread_join(p_threads[i], (void *) 0);
+        }
+
+        // Release the tasks
+        if ( p_tasks   ) p_tasks   = PRIORITY_QUEUE_REALLOC(p_tasks  , 0);
+        if ( p_threads ) p_threads = PRIORITY_QUEUE_REALLOC(p_threads, 0);
+        if ( p_started ) p_started = PRIORITY_QUEUE_REALLOC(p_started, 0);
     }
+    #endif
+
+    // Rebuild the heap
+    priority_queue_rebuild(p_priority_queue, threads);
+
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
 
     // Success
     return 1;
@@ -372,7 +8666,37 @@ int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i )
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_reprioritize:
+                #ifndef NDEBUG
+                    priority_queue_error_null("pfn_reprioritize", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+        }
+
+        // Priority queue errors
+        {
+            failed_to_unshare:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_unshare", __FUNCTION__);
+                #endif
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Error
+                return 0;
+
+            unsupported:
+                #ifndef NDEBUG
+                    priority_queue_error("Bucket, external, and sequence priority queues can not be reprioritized", __FUNCTION__);
                 #endif
 
                 // Error
@@ -381,20 +8705,39 @@ int priority_queue_heapify ( priority_queue *const p_priority_queue, size_t i )
     }
 }
 
-int priority_queue_build_max_heap ( priority_queue *const p_priority_queue )
+int priority_queue_histogram_snapshot ( priority_queue *const p_priority_queue, priority_queue_operation operation, priority_queue_histogram *const p_histogram )
 {
 
     // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_priority_queue == (void *) 0                 ) goto no_priority_queue;
+    if ( operation >= PRIORITY_QUEUE_OPERATION_QUANTITY ) goto no_operation;
+    if ( p_histogram      == (void *) 0                 ) goto no_histogram;
 
-    // Build the heap
-    for (size_t i = (p_priority_queue->entries.max / 2) - 1; i >= 0; i--)
-    
-        // Sort the heap
-        priority_queue_heapify(p_priority_queue, i);
+    #ifdef PRIORITY_QUEUE_HISTOGRAMS
 
-    // Success
-    return 1;
+        // Initialized data
+        struct priority_queue_histogram_atomic_s *p_atomic = &p_priority_queue->histograms.operations[operation];
+
+        // Copy the buckets, and count the latencies
+        p_histogram->count = 0;
+        for (size_t i = 0; i < PRIORITY_QUEUE_HISTOGRAM_BUCKETS; i++)
+        {
+            p_histogram->counts[i]  = atomic_load_explicit(&p_atomic->counts[i], memory_order_relaxed);
+            p_histogram->count     += p_histogram->counts[i];
+        }
+
+        // Copy the sum and the extremes
+        p_histogram->sum = atomic_load_explicit(&p_atomic->sum, memory_order_relaxed);
+        p_histogram->min = ( p_histogram->count ) ? ~atomic_load_explicit(&p_atomic->lowest, memory_order_relaxed) : 0;
+        p_histogram->max = atomic_load_explicit(&p_atomic->highest, memory_order_relaxed);
+
+        // Success
+        return 1;
+    #else
+
+        // Not compiled in
+        goto no_histogram_support;
+    #endif
 
     // Error handling
     {
@@ -403,51 +8746,97 @@ int priority_queue_build_max_heap ( priority_queue *const p_priority_queue )
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_operation:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"operation\" must be less than PRIORITY_QUEUE_OPERATION_QUANTITY", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_histogram:
+                #ifndef NDEBUG
+                    priority_queue_error_null("p_histogram", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
         }
+
+        #ifndef PRIORITY_QUEUE_HISTOGRAMS
+
+            // Priority queue errors
+            {
+                no_histogram_support:
+                    #ifndef NDEBUG
+                        priority_queue_error("Histograms are not compiled in. Build with PRIORITY_QUEUE_HISTOGRAMS", __FUNCTION__);
+                    #endif
+
+                    // Error
+                    return 0;
+            }
+        #endif
     }
 }
 
-int priority_queue_build_heap_sort ( priority_queue *const p_priority_queue )
+uint64_t priority_queue_histogram_percentile ( const priority_queue_histogram *const p_histogram, double percentile )
 {
 
     // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_histogram == (void *) 0 ) goto no_histogram;
 
-    // Build the max heap
-    priority_queue_build_max_heap(p_priority_queue);
+    // Initialized data
+    uint64_t target = 0,
+             seen   = 0;
+
+    // Empty histograms have no percentiles
+    if ( p_histogram->count == 0 ) return 0;
 
-    // Iterate through the max heap
-    for ( size_t i = p_priority_queue->entries.max - 1; i >= 1; i-- )
+    // Clamp the percentile
+    if ( percentile <   0.0 ) percentile =   0.0;
+    if ( percentile > 100.0 ) percentile = 100.0;
+
+    // Find the rank of the percentile
+    target = (uint64_t) ( percentile / 100.0 * (double) p_histogram->count + 0.5 );
+    if ( target < 1                  ) target = 1;
+    if ( target > p_histogram->count ) target = p_histogram->count;
+
+    // Find the bucket holding the rank
+    for (size_t i = 0; i < PRIORITY_QUEUE_HISTOGRAM_BUCKETS; i++)
     {
-        
-        // Swap the node at the iterator with the largest
-        void *tmp = p_priority_queue->entries.data[0];
-        p_priority_queue->entries.data[0] = p_priority_queue->entries.data[i];
-        p_priority_queue->entries.data[i] = tmp;
 
-        // Decrement the heap size
-        p_priority_queue->entries.count--;
+        // Count the bucket
+        seen += p_histogram->counts[i];
 
-        // Sort the heap
-        priority_queue_heapify(p_priority_queue, 0);
+        // Stop at the bucket holding the rank
+        if ( seen >= target )
+        {
+
+            // Initialized data
+            uint64_t highest = priority_queue_histogram_bucket_highest(i);
+
+            // Success
+            return ( highest < p_histogram->max ) ? highest : p_histogram->max;
+        }
     }
-     
+
     // Success
-    return 1;
+    return p_histogram->max;
 
     // Error handling
     {
 
         // Argument errors
         {
-            no_priority_queue:
+            no_histogram:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_histogram", __FUNCTION__);
                 #endif
 
                 // Error
@@ -456,18 +8845,28 @@ int priority_queue_build_heap_sort ( priority_queue *const p_priority_queue )
     }
 }
 
-int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value )
+int priority_queue_histogram_print ( FILE *p_file, const char *const name, const priority_queue_histogram *const p_histogram )
 {
 
     // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( p_file      == (void *) 0 ) goto no_file;
+    if ( name        == (void *) 0 ) goto no_name;
+    if ( p_histogram == (void *) 0 ) goto no_histogram;
+
+    // Print the count, the mean, and the percentiles
+    fprintf(p_file,
+        "%s: count %llu, mean %llu ns, min %llu ns, p50 %llu ns, p90 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+        name,
+        (unsigned long long) p_histogram->count,
+        (unsigned long long) ( ( p_histogram->count ) ? p_histogram->sum / p_histogram->count : 0 ),
+        (unsigned long long) p_histogram->min,
+        (unsigned long long) priority_queue_histogram_percentile(p_histogram, 50.0),
+        (unsigned long long) priority_queue_histogram_percentile(p_histogram, 90.0),
+        (unsigned long long) priority_queue_histogram_percentile(p_histogram, 99.0),
+        (unsigned long long) priority_queue_histogram_percentile(p_histogram, 99.9),
+        (unsigned long long) p_histogram->max
+    );
 
-    // Error check
-    if ( p_priority_queue->entries.count < 1 ) goto underflow;
-
-    // Return the maximum value to the caller
-    *pp_value = p_priority_queue->entries.data[0];
-     
     // Success
     return 1;
 
@@ -476,20 +8875,25 @@ int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value
 
         // Argument errors
         {
-            no_priority_queue:
+            no_file:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_file", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
-        }
 
-        // Priority queue errors
-        {
-            underflow:
+            no_name:
+                #ifndef NDEBUG
+                    priority_queue_error_null("name", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_histogram:
                 #ifndef NDEBUG
-                    printf("[priority queue] Priority queue underflow in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_histogram", __FUNCTION__);
                 #endif
 
                 // Error
@@ -498,33 +8902,58 @@ int priority_queue_max ( priority_queue *const p_priority_queue, void **pp_value
     }
 }
 
-int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **pp_value )
+#ifndef _WIN64
+int priority_queue_save ( priority_queue *const p_priority_queue, int fd, priority_queue_serialize_fn pfn_serialize )
 {
 
     // Argument check
     if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
+    if ( fd               <          0 ) goto no_fd;
+
+    // State check
+    if ( p_priority_queue->typed.type != PRIORITY_QUEUE_PRIORITY_COMPARATOR ) goto unsupported;
+    if ( p_priority_queue->external.block_size                              ) goto unsupported;
+    if ( p_priority_queue->layout == PRIORITY_QUEUE_LAYOUT_SEQUENCE         ) goto unsupported;
 
     // Initialized data
-    void *ret = (void *) 0;
+    struct priority_queue_save_header_s _header = { 0 };
+    struct priority_queue_stream_s      _stream = { .capacity = PRIORITY_QUEUE_STREAM_BUFFER_SIZE, .fd = fd };
 
-    // Get the maximum element
-    if ( priority_queue_max(p_priority_queue, &ret) == 0 ) goto underflow;
+    // Allocate a write buffer
+    _stream.p_buffer = PRIORITY_QUEUE_REALLOC(0, _stream.capacity);
 
-    // Move the last element in the heap to the first element of the heap
-    p_priority_queue->entries.data[0] = p_priority_queue->entries.data[p_priority_queue->entries.count - 1];
+    // Error checking
+    if ( _stream.p_buffer == (void *) 0 ) goto no_mem;
 
-    // Eliminate the duplicated element
-    p_priority_queue->entries.data[p_priority_queue->entries.count - 1] = (void *) 0;
+    // Lock
+    priority_queue_lock(p_priority_queue);
 
-    // Decrement the quantity of elements in the priority queue
-    p_priority_queue->entries.count--;
+    // Write the header
+    _header = (struct priority_queue_save_header_s)
+    {
+        .magic    = PRIORITY_QUEUE_SAVE_MAGIC,
+        .version  = PRIORITY_QUEUE_SAVE_VERSION,
+        .key_size = sizeof(void *),
+        .count    = p_priority_queue->entries.count,
+        .max      = p_priority_queue->entries.max,
+        .layout   = p_priority_queue->layout
+    };
+    if ( priority_queue_stream_write(&_stream, &_header, sizeof(_header)) == 0 ) goto failed_to_write;
+
+    // Iterate over each key in heap order
+    for (size_t i = 0; i < p_priority_queue->entries.count; i++)
+        if ( priority_queue_stream_write_key(&_stream, p_priority_queue->entries.data[priority_queue_physical(p_priority_queue, i)], pfn_serialize) == 0 ) goto failed_to_write;
+
+    // Flush the remaining records
+    if ( priority_queue_stream_flush(&_stream) == 0 ) goto failed_to_write;
 
-    // Fix the heap
-    priority_queue_heapify(p_priority_queue, 0);
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(_stream.p_buffer, 0);
+    if ( _stream.p_record ) PRIORITY_QUEUE_REALLOC(_stream.p_record, 0);
 
-    // Return the maximum value to the caller
-    if ( pp_value ) *pp_value = ret;
-     
     // Success
     return 1;
 
@@ -535,7 +8964,15 @@ int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            no_fd:
+                #ifndef NDEBUG
+                    priority_queue_error("Invalid file descriptor provided for parameter \"fd\"", __FUNCTION__);
                 #endif
 
                 // Error
@@ -544,41 +8981,101 @@ int priority_queue_extract_max ( priority_queue *const p_priority_queue, void **
 
         // Priority queue errors
         {
-            underflow:
+            unsupported:
                 #ifndef NDEBUG
-                    printf("[priority queue] Priority queue underflow in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Typed, external, and sequence priority queues can not be saved", __FUNCTION__);
                 #endif
 
+                // Error
+                return 0;
+
+            failed_to_write:
+                #ifndef NDEBUG
+                    priority_queue_error_call("priority_queue_stream_write", __FUNCTION__);
+                #endif
+
+                // Clean up
+                goto clean_up;
+
+            clean_up:
+
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
+                // Release the buffers
+                PRIORITY_QUEUE_REALLOC(_stream.p_buffer, 0);
+                if ( _stream.p_record ) PRIORITY_QUEUE_REALLOC(_stream.p_record, 0);
+
                 // Error
                 return 0;
         }
-    } 
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to allocate memory", __FUNCTION__);
+                #endif
+
+                // The lock is only held once the write buffer exists
+                if ( _stream.p_buffer == (void *) 0 ) return 0;
+
+                // Clean up
+                goto clean_up;
+        }
+    }
 }
+#endif
 
-int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t index, void *p_key )
+#ifndef _WIN64
+int priority_queue_mapped_commit ( priority_queue *const p_priority_queue )
 {
+
     // Argument check
     if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
 
-    // Ensure the key is increasing priority 
-    if ( p_priority_queue->pfn_compare_function(p_key, p_priority_queue->entries.data[index]) < 0 ) goto decrease_key;
-
-    // Store the key in the heap
-    p_priority_queue->entries.data[index] = p_key;
-
-    // Increase the key in the heap to its maximum priority
-    while ( index > 0 && p_priority_queue->pfn_compare_function(p_priority_queue->entries.data[PRIORITY_QUEUE_PARENT(index)], p_priority_queue->entries.data[index]) )
+    // Initialized data
+    size_t                                 page_size   = p_priority_queue->mapped.page_size,
+                                           region_size = p_priority_queue->mapped.region_size,
+                                           used        = p_priority_queue->entries.count * sizeof(void *);
+    uint64_t                               region      = 1 - p_priority_queue->mapped.region,
+                                           slot        = 1 - p_priority_queue->mapped.slot;
+    char                                  *p_region    = (char *) p_priority_queue->mapped.p_base + 2 * page_size + region * region_size;
+    struct priority_queue_mapped_header_s *p_header    = (struct priority_queue_mapped_header_s *) ( (char *) p_priority_queue->mapped.p_base + slot * page_size );
+    void                                  *p_live      = (void *) 0;
+
+    // Copy the heap into the uncommitted region
+    memcpy(p_region, p_priority_queue->entries.data, used);
+
+    // Flush the region before it is referenced by a header
+    if ( used ) if ( msync(p_region, ( ( used + page_size - 1 ) / page_size ) * page_size, MS_SYNC) == -1 ) goto failed_to_flush_file;
+
+    // Write the header
+    *p_header = (struct priority_queue_mapped_header_s)
     {
+        .magic    = PRIORITY_QUEUE_MAPPED_MAGIC,
+        .version  = PRIORITY_QUEUE_MAPPED_VERSION,
+        .key_size = sizeof(void *),
+        .sequence = p_priority_queue->mapped.sequence + 1,
+        .max      = p_priority_queue->entries.max,
+        .count    = p_priority_queue->entries.count,
+        .region   = region
+    };
+    p_header->checksum = priority_queue_mapped_checksum(p_header);
+
+    // Flush the header. This is the commit point
+    if ( msync(p_header, page_size, MS_SYNC) == -1 ) goto failed_to_flush_file;
+
+    // Update the priority queue
+    p_priority_queue->mapped.sequence++;
+    p_priority_queue->mapped.region = region;
+    p_priority_queue->mapped.slot   = slot;
+
+    // Remap the live heap onto the committed region, releasing the private copies
+    p_live = mmap(p_priority_queue->entries.data, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, p_priority_queue->mapped.fd, (off_t) ( 2 * page_size + region * region_size ) );
 
-        // Swap the key at index with key at parent index in the heap
-        size_t tmp_idx = PRIORITY_QUEUE_PARENT(index);
-        void *tmp = p_priority_queue->entries.data[index];
-        p_priority_queue->entries.data[index] = p_priority_queue->entries.data[tmp_idx];
-        p_priority_queue->entries.data[tmp_idx] = tmp;
-
-        // Update index to the parent index;
-        index = tmp_idx;
-    }
+    // Error checking
+    if ( p_live == MAP_FAILED ) goto failed_to_map_file;
 
     // Success
     return 1;
@@ -590,18 +9087,26 @@ int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
         }
 
-        // Priority queue errors
+        // Standard library errors
         {
-            decrease_key:
+            failed_to_flush_file:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_standard("Failed to flush memory mapped file", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
+
+            failed_to_map_file:
+                #ifndef NDEBUG
+                    priority_queue_error_standard("Failed to map memory mapped file", __FUNCTION__);
                 #endif
 
                 // Error
@@ -610,24 +9115,23 @@ int priority_queue_increase_key ( priority_queue *const p_priority_queue, size_t
     }
 }
 
-int priority_queue_insert ( priority_queue *const p_priority_queue, void *p_key )
+int priority_queue_checkpoint ( priority_queue *const p_priority_queue )
 {
-    
+
     // Argument check
     if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
-    if ( p_key            == (void *) 0 ) goto no_key;
 
     // State check
-    if ( p_priority_queue->entries.count >= p_priority_queue->entries.max ) goto heap_overflow;
+    if ( p_priority_queue->mapped.p_base == (void *) 0 ) goto not_mapped;
 
-    // Increment the size of the heap
-    p_priority_queue->entries.count++;
+    // Lock
+    priority_queue_lock(p_priority_queue);
 
-    // Insert the key into the heap
-    p_priority_queue->entries.data[p_priority_queue->entries.count - 1] = p_key;
+    // Commit the heap
+    if ( priority_queue_mapped_commit(p_priority_queue) == 0 ) goto failed_to_commit;
 
-    // Position the key correctly
-    if ( priority_queue_increase_key(p_priority_queue, p_priority_queue->entries.count-1, p_key) == 0 ) goto failed_to_increase_key;
+    // Unlock
+    priority_queue_unlock(p_priority_queue);
 
     // Success
     return 1;
@@ -639,15 +9143,7 @@ int priority_queue_insert ( priority_queue *const p_priority_queue, void *p_key
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
-                #endif
-
-                // Error
-                return 0;
-            
-            no_key:
-                #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_key\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("p_priority_queue", __FUNCTION__);
                 #endif
 
                 // Error
@@ -656,40 +9152,129 @@ int priority_queue_insert ( priority_queue *const p_priority_queue, void *p_key
 
         // Priority queue errors
         {
-            heap_overflow:
+            not_mapped:
                 #ifndef NDEBUG
-                    printf("[priority queue] Priority queue overflow in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Priority queue is not memory mapped", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
 
-            failed_to_increase_key:
+            failed_to_commit:
                 #ifndef NDEBUG
-                    printf("[priority queue] Call to function \"priority_queue_increase_key\" returned an erroneous value in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_call("priority_queue_mapped_commit", __FUNCTION__);
                 #endif
 
+                // Unlock
+                priority_queue_unlock(p_priority_queue);
+
                 // Error
                 return 0;
         }
     }
 }
+#endif
 
-int priority_queue_enqueue ( priority_queue *const p_priority_queue, void *p_key )
+int priority_queue_destroy ( priority_queue **const pp_priority_queue )
 {
 
     // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
-    if ( p_key            == (void *) 0 ) goto no_key;
+    if ( pp_priority_queue  == (void *) 0 ) goto no_priority_queue;
+    if ( *pp_priority_queue == (void *) 0 ) goto pp_priority_queue_null;
+
+    // Initialized data
+    priority_queue *p_priority_queue = *pp_priority_queue;
 
     // Lock
-    mutex_lock(p_priority_queue->_lock);
+    priority_queue_lock(p_priority_queue);
 
-    // Insert the key
-    if ( priority_queue_insert(p_priority_queue, p_key) == 0 ) goto failed_to_insert_key;
+    // No more pointer for end user
+    *pp_priority_queue = (priority_queue *) 0;
+
+    // Leave shared entries to a snapshot that a caller still holds ...
+    if ( p_priority_queue->p_snapshot && atomic_load_explicit(&p_priority_queue->p_snapshot->references, memory_order_acquire) > 1 )
+    {
+        priority_queue_snapshot_detach(p_priority_queue, p_priority_queue->entries.p_allocation ? p_priority_queue->entries.p_allocation : (void *) p_priority_queue->entries.data);
+        p_priority_queue->entries.data         = (void *) 0,
+        p_priority_queue->entries.p_allocation = (void *) 0;
+    }
+
+    // ... or free a snapshot no caller holds, and keep the entries
+    else if ( p_priority_queue->p_snapshot )
+        priority_queue_snapshot_detach(p_priority_queue, (void *) 0);
 
     // Unlock
-    mutex_unlock(p_priority_queue->_lock);
+    priority_queue_unlock(p_priority_queue);
+
+    // TODO: Remove all the priority queue properties
+    // 
+
+    // If the priority queue is memory mapped ...
+    if ( p_priority_queue->mapped.p_base )
+    {
+        #ifndef _WIN64
+
+            // ... commit the heap ...
+            priority_queue_mapped_commit(p_priority_queue);
+
+            // ... and release the file
+            munmap(p_priority_queue->entries.data, p_priority_queue->mapped.region_size);
+            munmap(p_priority_queue->mapped.p_base, p_priority_queue->mapped.length);
+            close(p_priority_queue->mapped.fd);
+        #endif
+    }
+
+    // Otherwise, free the entries
+    else if ( p_priority_queue->entries.data )
+        PRIORITY_QUEUE_REALLOC(p_priority_queue->entries.p_allocation ? p_priority_queue->entries.p_allocation : (void *) p_priority_queue->entries.data, 0);
+
+    // Free the inline priorities
+    if ( p_priority_queue->typed.p_allocation ) PRIORITY_QUEUE_REALLOC(p_priority_queue->typed.p_allocation, 0);
+
+    // Close the runs of an external priority queue
+    #ifndef _WIN64
+        for (size_t i = 0; i < p_priority_queue->external.merger.run_count; i++)
+            priority_queue_external_close(&p_priority_queue->external.merger.p_runs[i]);
+    #endif
+
+    // Free the runs, the loser tree, and the directory
+    if ( p_priority_queue->external.merger.p_runs    ) PRIORITY_QUEUE_REALLOC(p_priority_queue->external.merger.p_runs, 0);
+    if ( p_priority_queue->external.merger.p_tree    ) PRIORITY_QUEUE_REALLOC(p_priority_queue->external.merger.p_tree, 0);
+    if ( p_priority_queue->external.merger.p_winners ) PRIORITY_QUEUE_REALLOC(p_priority_queue->external.merger.p_winners, 0);
+    if ( p_priority_queue->external.p_directory      ) PRIORITY_QUEUE_REALLOC(p_priority_queue->external.p_directory, 0);
+
+    // Free the groups of a sequence heap
+    for (size_t g = 0; g < p_priority_queue->sequence.group_count; g++)
+    {
+
+        // Initialized data
+        struct priority_queue_merger_s *p_group = &p_priority_queue->sequence.p_groups[g];
+
+        // Free the sequences
+        for (size_t i = 0; i < p_group->run_count; i++)
+            PRIORITY_QUEUE_REALLOC(p_group->p_runs[i].p_keys, 0);
+
+        // Free the group
+        if ( p_group->p_runs    ) PRIORITY_QUEUE_REALLOC(p_group->p_runs, 0);
+        if ( p_group->p_tree    ) PRIORITY_QUEUE_REALLOC(p_group->p_tree, 0);
+        if ( p_group->p_winners ) PRIORITY_QUEUE_REALLOC(p_group->p_winners, 0);
+    }
+    if ( p_priority_queue->sequence.p_groups ) PRIORITY_QUEUE_REALLOC(p_priority_queue->sequence.p_groups, 0);
+
+    // Free the tombstones
+    if ( p_priority_queue->tombstones.p_slots ) PRIORITY_QUEUE_REALLOC(p_priority_queue->tombstones.p_slots, 0);
+
+    #ifdef PRIORITY_QUEUE_EVENTFD
+
+        // Close the eventfd
+        if ( p_priority_queue->notify.open ) close(p_priority_queue->notify.fd);
+    #endif
+
+    // Destroy the mutex
+    mutex_destroy(&p_priority_queue->_lock);
+
+    // Free the priority queue
+    PRIORITY_QUEUE_REALLOC(p_priority_queue, 0);
 
     // Success
     return 1;
@@ -701,26 +9286,15 @@ int priority_queue_enqueue ( priority_queue *const p_priority_queue, void *p_key
         {
             no_priority_queue:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
-                #endif
-
-                // Error
-                return 0;
-            
-            no_key:
-                #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_key\" in call to function \"%s\"\n", __FUNCTION__);
+                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
-        }
 
-        // Priority queue errors
-        {
-            failed_to_insert_key:
+            pp_priority_queue_null:
                 #ifndef NDEBUG
-                    printf("[priority queue] Call to function \"priority_queue_insert\" returned an erroneous value in call to function \"%s\"\n", __FUNCTION__);
+                    printf("[priority queue] Parameter \"pp_priority_queue\" points to null pointer in call to function \"%s\"\n", __FUNCTION__);
                 #endif
 
                 // Error
@@ -729,21 +9303,27 @@ int priority_queue_enqueue ( priority_queue *const p_priority_queue, void *p_key
     }
 }
 
-int priority_queue_dequeue ( priority_queue *const p_priority_queue, void **pp_key )
+int priority_queue_snapshot_release ( priority_queue_snapshot **const pp_snapshot )
 {
-    
+
     // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
-    if ( pp_key           == (void *) 0 ) goto no_key;
+    if ( pp_snapshot  == (void *) 0 ) goto no_snapshot;
+    if ( *pp_snapshot == (void *) 0 ) goto pp_snapshot_null;
 
-    // Lock
-    mutex_lock(p_priority_queue->_lock);
+    // Initialized data
+    priority_queue_snapshot *p_snapshot = *pp_snapshot;
 
-    // Insert the key
-    if ( priority_queue_extract_max(p_priority_queue, pp_key) == 0 ) goto failed_to_extract_max_key;
+    // No more pointer for end user
+    *pp_snapshot = (priority_queue_snapshot *) 0;
 
-    // Unlock
-    mutex_unlock(p_priority_queue->_lock);
+    // The last reference frees the snapshot, and any entries left to it. While the 
+    // priority queue shares the entries, it holds a reference, so this is never the 
+    // last one, and the priority queue is never touched here
+    if ( atomic_fetch_sub_explicit(&p_snapshot->references, 1, memory_order_acq_rel) == 1 )
+    {
+        if ( p_snapshot->p_allocation ) PRIORITY_QUEUE_REALLOC(p_snapshot->p_allocation, 0);
+        PRIORITY_QUEUE_REALLOC(p_snapshot, 0);
+    }
 
     // Success
     return 1;
@@ -753,28 +9333,17 @@ int priority_queue_dequeue ( priority_queue *const p_priority_queue, void **pp_k
 
         // Argument errors
         {
-            no_priority_queue:
-                #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
-                #endif
-
-                // Error
-                return 0;
-            
-            no_key:
+            no_snapshot:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_key\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("pp_snapshot", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
-        }
 
-        // Priority queue errors
-        {
-            failed_to_extract_max_key:
+            pp_snapshot_null:
                 #ifndef NDEBUG
-                    printf("[priority queue] Call to function \"priority_queue_extract_max\" returned an erroneous value in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Parameter \"pp_snapshot\" points to null pointer", __FUNCTION__);
                 #endif
 
                 // Error
@@ -783,70 +9352,81 @@ int priority_queue_dequeue ( priority_queue *const p_priority_queue, void **pp_k
     }
 }
 
-bool priority_queue_empty ( priority_queue *const p_priority_queue )
+int priority_queue_fair_destroy ( priority_queue_fair **const pp_fair )
 {
-    
-    // Argument check
-    if ( p_priority_queue == (void *) 0 ) goto no_priority_queue;
 
-    // Lock
-    mutex_lock(p_priority_queue->_lock);
+    // Argument check
+    if ( pp_fair  == (void *) 0 ) goto no_fair;
+    if ( *pp_fair == (void *) 0 ) goto pp_fair_null;
 
     // Initialized data
-    bool ret = ( p_priority_queue->entries.count == 0 );
+    priority_queue_fair *p_fair = *pp_fair;
 
-    // Unlock
-    mutex_unlock(p_priority_queue->_lock);
+    // No more pointer for end user
+    *pp_fair = (priority_queue_fair *) 0;
+
+    // Destroy the backlog
+    priority_queue_destroy(&p_fair->p_backlog);
+
+    // Destroy the mutex
+    mutex_destroy(&p_fair->_lock);
+
+    // Free the memory
+    PRIORITY_QUEUE_REALLOC(p_fair->p_tenants, 0);
+    PRIORITY_QUEUE_REALLOC(p_fair->p_entries, 0);
+    PRIORITY_QUEUE_REALLOC(p_fair, 0);
 
     // Success
-    return ret;
+    return 1;
 
     // Error handling
     {
 
         // Argument errors
         {
-            no_priority_queue:
+            no_fair:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"p_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("pp_fair", __FUNCTION__);
                 #endif
 
                 // Error
-                return true;
+                return 0;
+
+            pp_fair_null:
+                #ifndef NDEBUG
+                    priority_queue_error("Parameter \"pp_fair\" points to null pointer", __FUNCTION__);
+                #endif
+
+                // Error
+                return 0;
         }
     }
 }
 
-int priority_queue_destroy ( priority_queue **const pp_priority_queue )
+#ifndef _WIN64
+int priority_queue_delay_destroy ( priority_queue_delay **const pp_delay )
 {
 
     // Argument check
-    if ( pp_priority_queue  == (void *) 0 ) goto no_priority_queue;
-    if ( *pp_priority_queue == (void *) 0 ) goto pp_priority_queue_null;
+    if ( pp_delay  == (void *) 0 ) goto no_delay;
+    if ( *pp_delay == (void *) 0 ) goto pp_delay_null;
 
     // Initialized data
-    priority_queue *p_priority_queue = *pp_priority_queue;
-
-    // Lock
-    mutex_lock(p_priority_queue->_lock);
+    priority_queue_delay *p_delay = *pp_delay;
 
     // No more pointer for end user
-    *pp_priority_queue = (priority_queue *) 0;
-
-    // Unlock
-    mutex_unlock(p_priority_queue->_lock);
-
-    // TODO: Remove all the priority queue properties
-    // 
+    *pp_delay = (priority_queue_delay *) 0;
 
-    // Free the hash table
-    PRIORITY_QUEUE_REALLOC(p_priority_queue->entries.data, 0);
+    // Destroy both heaps
+    priority_queue_destroy(&p_delay->p_delayed);
+    priority_queue_destroy(&p_delay->p_eligible);
 
-    // Destroy the mutex
-    mutex_destroy(&p_priority_queue->_lock);
+    // Destroy the condition variable, and the mutex
+    pthread_cond_destroy(&p_delay->changed);
+    pthread_mutex_destroy(&p_delay->_lock);
 
-    // Free the priority queue
-    PRIORITY_QUEUE_REALLOC(p_priority_queue, 0);
+    // Free the memory
+    PRIORITY_QUEUE_REALLOC(p_delay, 0);
 
     // Success
     return 1;
@@ -856,17 +9436,17 @@ int priority_queue_destroy ( priority_queue **const pp_priority_queue )
 
         // Argument errors
         {
-            no_priority_queue:
+            no_delay:
                 #ifndef NDEBUG
-                    printf("[priority queue] Null pointer provided for parameter \"pp_priority_queue\" in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error_null("pp_delay", __FUNCTION__);
                 #endif
 
                 // Error
                 return 0;
 
-            pp_priority_queue_null:
+            pp_delay_null:
                 #ifndef NDEBUG
-                    printf("[priority queue] Parameter \"pp_priority_queue\" points to null pointer in call to function \"%s\"\n", __FUNCTION__);
+                    priority_queue_error("Parameter \"pp_delay\" points to null pointer", __FUNCTION__);
                 #endif
 
                 // Error
@@ -874,3 +9454,4 @@ int priority_queue_destroy ( priority_queue **const pp_priority_queue )
         }
     }
 }
+#endif
@@ -0,0 +1,302 @@
+/** !
+ * priority queue coroutine tester
+ *
+ * @file priority_queue_async_test.cpp
+ * @author Jacob Smith
+ * @date Feb 14, 2024
+ */
+
+// Headers
+#include <cstdio>
+#include <cstdlib>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+// priority queue module
+#include <priority_queue/priority_queue.hpp>
+
+// log module
+extern "C"
+{
+    #include <log/log.h>
+}
+
+// Structure definitions
+/** !
+ *  @brief A coroutine that starts at once, and frees itself when it finishes
+ */
+struct test_task
+{
+    struct promise_type
+    {
+        test_task           get_return_object   ( void )          { return { }; }
+        std::suspend_never  initial_suspend     ( void )          { return { }; }
+        std::suspend_never  final_suspend       ( void ) noexcept { return { }; }
+        void                return_void         ( void )          { }
+        void                unhandled_exception ( void )          { std::terminate(); }
+    };
+};
+
+/** !
+ *  @brief The result of one waiting coroutine
+ */
+struct test_waiter
+{
+    std::optional<void *> key;
+    bool                  done = false;
+};
+
+// Data
+static int ephemeral_tests  = 0,
+           ephemeral_passes = 0,
+           total_tests      = 0,
+           total_passes     = 0;
+
+/** !
+ * Pop a key, and store it
+ *
+ * @param queue    the async priority queue
+ * @param p_waiter return
+ *
+ * @return a coroutine
+ */
+test_task test_pop ( pq::async_queue &queue, test_waiter *p_waiter )
+{
+
+    // Wait for a key
+    p_waiter->key  = co_await queue.pop();
+    p_waiter->done = true;
+}
+
+/** !
+ * Pop a key until a stop is requested, and store it
+ *
+ * @param queue    the async priority queue
+ * @param token    the stop token
+ * @param p_waiter return
+ *
+ * @return a coroutine
+ */
+test_task test_pop_until ( pq::async_queue &queue, std::stop_token token, test_waiter *p_waiter )
+{
+
+    // Wait for a key, or a stop
+    p_waiter->key  = co_await queue.pop(std::move(token));
+    p_waiter->done = true;
+}
+
+/** !
+ * Print the result of a test
+ *
+ * @param scenario_name the scenario
+ * @param test_name     the test
+ * @param passed        true if the test passed
+ *
+ * @return 1
+ */
+int print_test ( const char *scenario_name, const char *test_name, bool passed )
+{
+
+    // Print the result
+    if ( passed ) log_pass("%s %s\n", scenario_name, test_name);
+    else          log_fail("%s %s\n", scenario_name, test_name);
+
+    // Count the test
+    ephemeral_passes += passed,
+    ephemeral_tests++;
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Print the results of a scenario
+ *
+ * @return 1
+ */
+int print_final_summary ( void )
+{
+
+    // Accumulate
+    total_tests  += ephemeral_tests,
+    total_passes += ephemeral_passes;
+
+    // Log statistics
+    log_info("\nTests: %d, Passed: %d, Failed: %d\n", ephemeral_tests, ephemeral_passes, ephemeral_tests - ephemeral_passes);
+    log_info("Total: %d, Passed: %d, Failed: %d\n\n", total_tests, total_passes, total_tests - total_passes);
+
+    // Reset
+    ephemeral_tests  = 0,
+    ephemeral_passes = 0;
+
+    // Success
+    return 1;
+}
+
+bool test_async_immediate ( void )
+{
+
+    // Initialized data
+    pq::async_queue queue(4);
+    test_waiter     _waiter;
+
+    // A key is already queued
+    queue.push((void *) 1);
+
+    // The pop does not suspend
+    test_pop(queue, &_waiter);
+
+    // Return result
+    return _waiter.done && _waiter.key == (void *) 1 && queue.empty();
+}
+
+bool test_async_resume ( void )
+{
+
+    // Initialized data
+    pq::async_queue queue(4);
+    test_waiter     _waiter;
+    bool            result = true;
+
+    // The pop suspends on an empty priority queue
+    test_pop(queue, &_waiter);
+    result = ( _waiter.done == false );
+
+    // The push resumes it with the key
+    result = result && queue.push((void *) 5) && _waiter.done && _waiter.key == (void *) 5 && queue.empty();
+
+    // Return result
+    return result;
+}
+
+bool test_async_executor ( void )
+{
+
+    // Initialized data
+    std::vector<std::coroutine_handle<>> handles;
+    pq::async_queue                      queue(4, nullptr, [&handles] ( std::coroutine_handle<> handle ) { handles.push_back(handle); });
+    test_waiter                          _waiter;
+    bool                                 result = true;
+
+    // The pop suspends
+    test_pop(queue, &_waiter);
+
+    // The push hands the coroutine to the executor, instead of resuming it
+    result = queue.push((void *) 7) && ( _waiter.done == false ) && ( handles.size() == 1 );
+
+    // The executor resumes it with the key
+    if ( result ) handles[0].resume();
+    result = result && _waiter.done && _waiter.key == (void *) 7;
+
+    // Return result
+    return result;
+}
+
+bool test_async_cancel_before ( void )
+{
+
+    // Initialized data
+    pq::async_queue   queue(4);
+    std::stop_source  source;
+    test_waiter       _waiter;
+
+    // A stop is requested before the pop
+    source.request_stop();
+
+    // The pop does not suspend, and has no key
+    test_pop_until(queue, source.get_token(), &_waiter);
+
+    // Return result
+    return _waiter.done && _waiter.key.has_value() == false;
+}
+
+bool test_async_cancel_suspended ( void )
+{
+
+    // Initialized data
+    pq::async_queue   queue(4);
+    std::stop_source  source;
+    test_waiter       _waiter;
+    bool              result = true;
+
+    // The pop suspends
+    test_pop_until(queue, source.get_token(), &_waiter);
+    result = ( _waiter.done == false );
+
+    // A stop resumes it with no key
+    source.request_stop();
+    result = result && _waiter.done && _waiter.key.has_value() == false;
+
+    // A later key is not handed to the cancelled waiter
+    result = result && queue.push((void *) 3) && queue.try_pop() == (void *) 3;
+
+    // Return result
+    return result;
+}
+
+bool test_async_fifo ( void )
+{
+
+    // Initialized data
+    pq::async_queue queue(4);
+    test_waiter     _waiters[3];
+    bool            result = true;
+
+    // Three pops suspend, in order
+    for (test_waiter &_waiter : _waiters) test_pop(queue, &_waiter);
+
+    // Each push resumes the longest waiting coroutine
+    result = queue.push((void *) 30) && _waiters[0].done && _waiters[0].key == (void *) 30 && ( _waiters[1].done == false );
+    result = result && queue.push((void *) 10) && _waiters[1].done && _waiters[1].key == (void *) 10 && ( _waiters[2].done == false );
+    result = result && queue.push((void *) 20) && _waiters[2].done && _waiters[2].key == (void *) 20;
+
+    // Return result
+    return result;
+}
+
+int test_async_priority_queue ( const char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // a key is already queued
+    print_test(name, "async_queue_pop_immediate", test_async_immediate());
+
+    // a push resumes a suspended pop
+    print_test(name, "async_queue_pop_resume", test_async_resume());
+
+    // a push resumes a suspended pop on the executor
+    print_test(name, "async_queue_pop_executor", test_async_executor());
+
+    // a stop requested before the pop
+    print_test(name, "async_queue_pop_cancel_before", test_async_cancel_before());
+
+    // a stop requested while the pop is suspended
+    print_test(name, "async_queue_pop_cancel_suspended", test_async_cancel_suspended());
+
+    // waiters are resumed in the order they suspended
+    print_test(name, "async_queue_pop_fifo", test_async_fifo());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int main ( void )
+{
+
+    // Initialize the log library
+    log_init(0, true);
+
+    // Run tests
+    test_async_priority_queue("async");
+
+    // Exit
+    return ( total_passes == total_tests ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
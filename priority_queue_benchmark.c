@@ -0,0 +1,1105 @@
+/** !
+ * priority queue benchmark
+ *
+ * Times enqueue and dequeue of pseudo random priorities on each kind of heap. Run
+ * with the quantity of keys, or with no arguments for 1000000
+ *
+ * Run with "workload" to time the algorithms the priority queue is used for. Each
+ * of Dijkstra's shortest paths, Prim's minimum spanning tree, A* on a grid, and a
+ * hold model event simulation runs on each kind of heap, and reports the wall time,
+ * the operations, and the peak memory. Keys are never updated in place; a decrease
+ * key enqueues the key again, and the stale copy is skipped when it is dequeued. 
+ * The graph is generated, or read from a DIMACS shortest path file, such as a road
+ * network from the 9th DIMACS implementation challenge
+ *
+ *     priority_queue_benchmark workload [quantity of vertices] [graph.gr]
+ *
+ * @file priority_queue_benchmark.c
+ * @author Jacob Smith
+ * @date Feb 14, 2024
+ */
+
+// Headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _WIN64
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// sync module
+#include <sync/sync.h>
+
+// priority queue module
+#include <priority_queue/priority_queue.h>
+
+// Structure definitions
+/** !
+ *  @brief One heap to time
+ */
+struct priority_queue_benchmark_s
+{
+    const char                  *name;
+    priority_queue_priority_type type;
+    size_t                       arity;
+};
+
+/** !
+ *  @brief A directed graph, in compressed sparse rows
+ */
+struct priority_queue_graph_s
+{
+    size_t    vertices,
+              arcs;
+    size_t   *p_first;  // The arcs of vertex v are p_first[v] ... p_first[v + 1] - 1
+    uint32_t *p_target,
+             *p_weight;
+};
+
+/** !
+ *  @brief The inputs of the workloads
+ */
+struct priority_queue_workload_input_s
+{
+    struct priority_queue_graph_s  graph;    // For Dijkstra and Prim
+    size_t                         side;     // For A*, a square grid ...
+    unsigned char                 *p_weight; // ... with the cost to enter each cell, or 0 for a wall
+    size_t                         events;   // For the hold model
+};
+
+/** !
+ *  @brief One kind of heap for the workloads
+ */
+struct priority_queue_workload_queue_s
+{
+    const char                  *name;
+    priority_queue_priority_type type;
+    size_t                       arity;
+    priority_queue_layout        layout;
+};
+
+/** !
+ *  @brief The operations of one workload
+ */
+struct priority_queue_workload_count_s
+{
+    size_t   enqueues,
+             dequeues,
+             decreases, // Enqueues of a key that was already enqueued, with a higher priority
+             stale;     // Dequeues of a key that was enqueued again
+    uint64_t checksum;  // The same for every kind of heap
+};
+
+/** !
+ *  @brief A workload, and the quantity of keys its priority queue may hold
+ */
+struct priority_queue_workload_s
+{
+    const char *name;
+    size_t    (*pfn_size) ( const struct priority_queue_workload_input_s *const p_input );
+    int       (*pfn_run)  ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, const struct priority_queue_workload_input_s *const p_input, struct priority_queue_workload_count_s *const p_count );
+};
+
+// Data
+static const struct priority_queue_benchmark_s benchmarks[] =
+{
+    { "comparator",  PRIORITY_QUEUE_PRIORITY_COMPARATOR, 2 },
+    { "u32 2-ary",   PRIORITY_QUEUE_PRIORITY_U32,        2 },
+    { "u32 4-ary",   PRIORITY_QUEUE_PRIORITY_U32,        4 },
+    { "u32 8-ary",   PRIORITY_QUEUE_PRIORITY_U32,        8 },
+    { "u64 2-ary",   PRIORITY_QUEUE_PRIORITY_U64,        2 },
+    { "u64 4-ary",   PRIORITY_QUEUE_PRIORITY_U64,        4 },
+    { "u64 8-ary",   PRIORITY_QUEUE_PRIORITY_U64,        8 },
+    { "index 2-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      2 },
+    { "index 4-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      4 },
+    { "index 8-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      8 }
+};
+
+static const struct priority_queue_workload_queue_s workload_queues[] =
+{
+    { "binary",      PRIORITY_QUEUE_PRIORITY_COMPARATOR, 2, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "blocked",     PRIORITY_QUEUE_PRIORITY_COMPARATOR, 2, PRIORITY_QUEUE_LAYOUT_BLOCKED  },
+    { "sequence",    PRIORITY_QUEUE_PRIORITY_COMPARATOR, 2, PRIORITY_QUEUE_LAYOUT_SEQUENCE },
+    { "u32 2-ary",   PRIORITY_QUEUE_PRIORITY_U32,        2, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "u32 4-ary",   PRIORITY_QUEUE_PRIORITY_U32,        4, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "u32 8-ary",   PRIORITY_QUEUE_PRIORITY_U32,        8, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "u64 4-ary",   PRIORITY_QUEUE_PRIORITY_U64,        4, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "index 2-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      2, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "index 4-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      4, PRIORITY_QUEUE_LAYOUT_BINARY   },
+    { "index 8-ary", PRIORITY_QUEUE_PRIORITY_INDEX,      8, PRIORITY_QUEUE_LAYOUT_BINARY   }
+};
+
+/** !
+ * Step a xorshift generator
+ *
+ * @param p_state the state of the generator
+ *
+ * @return the next pseudo random number
+ */
+static uint64_t priority_queue_benchmark_random ( uint64_t *p_state )
+{
+
+    // Step the generator
+    *p_state ^= *p_state << 13, *p_state ^= *p_state >> 7, *p_state ^= *p_state << 17;
+
+    // Success
+    return *p_state;
+}
+
+/** !
+ * Order keys by their value, so lower values come first like in a typed heap
+ *
+ * @param a the first key
+ * @param b the second key
+ *
+ * @return 1 if a has the higher priority, -1 if b does, else 0
+ */
+static int priority_queue_benchmark_compare ( const void *const a, const void *const b )
+{
+
+    // Compare the values
+    return ( (uintptr_t) a < (uintptr_t) b ) - ( (uintptr_t) a > (uintptr_t) b );
+}
+
+/** !
+ * Enqueue, then dequeue, pseudo random priorities, and print the time of each phase
+ *
+ * @param p_benchmark the heap to time
+ * @param how_many    the quantity of keys
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_benchmark_run ( const struct priority_queue_benchmark_s *const p_benchmark, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = (void *) 0;
+    priority_queue_priority  priority         = { 0 };
+    void                    *p_key            = (void *) 0;
+    uint64_t                 state            = 0x9e3779b97f4a7c15ULL;
+    timestamp                t0               = 0,
+                             t1               = 0,
+                             t2               = 0;
+    double                   divisor          = (double) timer_seconds_divisor();
+
+    // Construct the priority queue
+    if ( p_benchmark->type == PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+    {
+        if ( priority_queue_construct(&p_priority_queue, how_many, priority_queue_benchmark_compare) == 0 ) goto failed_to_construct;
+    }
+    else if ( priority_queue_construct_typed(&p_priority_queue, how_many, p_benchmark->type, p_benchmark->arity, 0) == 0 ) goto failed_to_construct;
+
+    // Time the enqueues
+    t0 = timer_high_precision();
+    for (size_t i = 0; i < how_many; i++)
+    {
+
+        // Initialized data
+        uint64_t value = priority_queue_benchmark_random(&state);
+
+        // Enqueue a key
+        if      ( p_benchmark->type == PRIORITY_QUEUE_PRIORITY_COMPARATOR ) priority_queue_enqueue(p_priority_queue, (void *) (uintptr_t) ( value | 1 ));
+        else if ( p_benchmark->type == PRIORITY_QUEUE_PRIORITY_INDEX      ) priority_queue_enqueue_index(p_priority_queue, (uint32_t) i, (uint32_t) value);
+        else
+        {
+            if ( p_benchmark->type == PRIORITY_QUEUE_PRIORITY_U32 ) priority.u32 = (uint32_t) value;
+            else                                                    priority.u64 = value;
+            priority_queue_enqueue_priority(p_priority_queue, (void *) ( i + 1 ), priority);
+        }
+    }
+
+    // Time the dequeues
+    t1 = timer_high_precision();
+    for (size_t i = 0; i < how_many; i++)
+        priority_queue_dequeue(p_priority_queue, &p_key);
+    t2 = timer_high_precision();
+
+    // Print the times
+    printf("%-12s %10.1f ns/enqueue %10.1f ns/dequeue\n", p_benchmark->name, (double) ( t1 - t0 ) * 1e9 / divisor / (double) how_many, (double) ( t2 - t1 ) * 1e9 / divisor / (double) how_many);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+        failed_to_construct:
+            #ifndef NDEBUG
+                printf("[priority queue] [benchmark] Failed to construct \"%s\" in call to function \"%s\"\n", p_benchmark->name, __FUNCTION__);
+            #endif
+
+            // Error
+            return 0;
+    }
+}
+
+/** !
+ * Construct a priority queue for a workload
+ *
+ * @param p_queue           the kind of heap
+ * @param size              the quantity of keys
+ * @param pp_priority_queue return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_construct ( const struct priority_queue_workload_queue_s *const p_queue, size_t size, priority_queue **const pp_priority_queue )
+{
+
+    // Heaps of keys, ordered by the priority in the upper half of each key ...
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+        return priority_queue_construct_with_layout(pp_priority_queue, size, priority_queue_benchmark_compare, p_queue->layout);
+
+    // ... or typed heaps
+    return priority_queue_construct_typed(pp_priority_queue, size, p_queue->type, p_queue->arity, 0);
+}
+
+/** !
+ * Enqueue a vertex with a priority. Lower priorities come first
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue
+ * @param vertex           the vertex
+ * @param value            the priority
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_enqueue ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, uint32_t vertex, uint32_t value )
+{
+
+    // Initialized data
+    priority_queue_priority priority = { 0 };
+
+    // Compact heaps pack the vertex with its priority
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_INDEX ) return priority_queue_enqueue_index(p_priority_queue, vertex, value);
+
+    // Heaps of keys store the priority above the vertex. The vertex is offset by one, so no key is null
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_COMPARATOR ) return priority_queue_enqueue(p_priority_queue, (void *) (uintptr_t) ( (uint64_t) value << 32 | ( (uint64_t) vertex + 1 ) ));
+
+    // Typed heaps store the priority beside the vertex
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_U32 ) priority.u32 = value;
+    else                                                priority.u64 = value;
+
+    // Success
+    return priority_queue_enqueue_priority(p_priority_queue, (void *) (uintptr_t) ( (uint64_t) vertex + 1 ), priority);
+}
+
+/** !
+ * Dequeue the vertex with the lowest priority
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue
+ * @param p_vertex         return
+ * @param p_value          return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_dequeue ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, uint32_t *p_vertex, uint32_t *p_value )
+{
+
+    // Initialized data
+    priority_queue_priority  priority = { 0 };
+    void                    *p_key    = (void *) 0;
+
+    // Compact heaps unpack the vertex and its priority
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_INDEX ) return priority_queue_dequeue_index(p_priority_queue, p_vertex, p_value);
+
+    // Heaps of keys unpack the key
+    if ( p_queue->type == PRIORITY_QUEUE_PRIORITY_COMPARATOR )
+    {
+
+        // Dequeue the key
+        if ( priority_queue_dequeue(p_priority_queue, &p_key) == 0 ) return 0;
+
+        // Unpack the key
+        *p_vertex = (uint32_t) (uintptr_t) p_key - 1;
+        *p_value  = (uint32_t) ( (uint64_t) (uintptr_t) p_key >> 32 );
+
+        // Success
+        return 1;
+    }
+
+    // Typed heaps return the priority beside the vertex
+    if ( priority_queue_dequeue_priority(p_priority_queue, &p_key, &priority) == 0 ) return 0;
+
+    // Return the vertex and its priority
+    *p_vertex = (uint32_t) (uintptr_t) p_key - 1;
+    *p_value  = ( p_queue->type == PRIORITY_QUEUE_PRIORITY_U32 ) ? priority.u32 : (uint32_t) priority.u64;
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Construct a graph from a list of arcs, each a source, a target, and a weight
+ *
+ * @param p_graph  return
+ * @param vertices the quantity of vertices
+ * @param arcs     the quantity of arcs
+ * @param p_arcs   the arcs
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_graph_from_arcs ( struct priority_queue_graph_s *const p_graph, size_t vertices, size_t arcs, const uint32_t *const p_arcs )
+{
+
+    // Initialized data
+    size_t *p_next = PRIORITY_QUEUE_REALLOC(0, ( vertices + 1 ) * sizeof(size_t));
+
+    // Allocate the rows
+    p_graph->vertices = vertices;
+    p_graph->arcs     = arcs;
+    p_graph->p_first  = PRIORITY_QUEUE_REALLOC(0, ( vertices + 1 ) * sizeof(size_t));
+    p_graph->p_target = PRIORITY_QUEUE_REALLOC(0, ( arcs + 1 ) * sizeof(uint32_t));
+    p_graph->p_weight = PRIORITY_QUEUE_REALLOC(0, ( arcs + 1 ) * sizeof(uint32_t));
+
+    // Error checking
+    if ( p_next == (void *) 0 || p_graph->p_first == (void *) 0 || p_graph->p_target == (void *) 0 || p_graph->p_weight == (void *) 0 ) goto no_mem;
+
+    // Count the arcs out of each vertex
+    memset(p_graph->p_first, 0, ( vertices + 1 ) * sizeof(size_t));
+    for (size_t i = 0; i < arcs; i++) p_graph->p_first[p_arcs[3 * i] + 1]++;
+
+    // Find the first arc of each vertex
+    for (size_t v = 0; v < vertices; v++) p_graph->p_first[v + 1] += p_graph->p_first[v];
+    memcpy(p_next, p_graph->p_first, ( vertices + 1 ) * sizeof(size_t));
+
+    // Place each arc in the row of its source
+    for (size_t i = 0; i < arcs; i++)
+    {
+
+        // Initialized data
+        size_t slot = p_next[p_arcs[3 * i]]++;
+
+        // Store the arc
+        p_graph->p_target[slot] = p_arcs[3 * i + 1];
+        p_graph->p_weight[slot] = p_arcs[3 * i + 2];
+    }
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_next, 0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+
+        // Standard library errors
+        {
+            no_mem:
+                #ifndef NDEBUG
+                    printf("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+                #endif
+
+                // Clean up
+                PRIORITY_QUEUE_REALLOC(p_next, 0);
+
+                // Error
+                return 0;
+        }
+    }
+}
+
+/** !
+ * Add a road, as an arc each way
+ *
+ * @param p_arcs the arcs
+ * @param p_arcs_count the quantity of arcs
+ * @param from   one end of the road
+ * @param to     the other end of the road
+ * @param weight the length of the road
+ *
+ * @return void
+ */
+static void priority_queue_graph_road ( uint32_t *const p_arcs, size_t *const p_arcs_count, uint32_t from, uint32_t to, uint32_t weight )
+{
+
+    // Initialized data
+    uint32_t *p = &p_arcs[3 * *p_arcs_count];
+
+    // Store the arcs
+    p[0] = from, p[1] = to,   p[2] = weight;
+    p[3] = to,   p[4] = from, p[5] = weight;
+    *p_arcs_count += 2;
+
+    // Done
+    return;
+}
+
+/** !
+ * Generate a graph like a road network. Each vertex of a square grid joins its
+ * neighbours with a random weight, and a few random highways join distant vertices
+ *
+ * @param p_graph return
+ * @param size    the approximate quantity of vertices
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_graph_generate ( struct priority_queue_graph_s *const p_graph, size_t size )
+{
+
+    // Initialized data
+    uint64_t  state    = 0x853c49e6748fea9bULL;
+    size_t    side     = 1,
+              vertices = 0,
+              arcs     = 0;
+    uint32_t *p_arcs   = (void *) 0;
+    int       ret      = 0;
+
+    // Find the side of the grid
+    while ( ( side + 1 ) * ( side + 1 ) <= size ) side++;
+    vertices = side * side;
+
+    // Allocate two arcs for each road
+    p_arcs = PRIORITY_QUEUE_REALLOC(0, 2 * ( 2 * vertices + vertices / 16 ) * 3 * sizeof(uint32_t));
+
+    // Error checking
+    if ( p_arcs == (void *) 0 ) return 0;
+
+    // Join each vertex to its right and lower neighbours
+    for (size_t v = 0; v < vertices; v++)
+    {
+        if ( v % side != side - 1 ) priority_queue_graph_road(p_arcs, &arcs, (uint32_t) v, (uint32_t) ( v + 1    ), (uint32_t) ( priority_queue_benchmark_random(&state) % 1000 + 1 ));
+        if ( v / side != side - 1 ) priority_queue_graph_road(p_arcs, &arcs, (uint32_t) v, (uint32_t) ( v + side ), (uint32_t) ( priority_queue_benchmark_random(&state) % 1000 + 1 ));
+    }
+
+    // Add the highways
+    for (size_t i = 0; i < vertices / 16; i++)
+    {
+
+        // Initialized data
+        uint32_t from = (uint32_t) ( priority_queue_benchmark_random(&state) % vertices ),
+                 to   = (uint32_t) ( priority_queue_benchmark_random(&state) % vertices );
+
+        // Add the highway
+        priority_queue_graph_road(p_arcs, &arcs, from, to, (uint32_t) ( priority_queue_benchmark_random(&state) % 4000 + 1000 ));
+    }
+
+    // Construct the graph
+    ret = priority_queue_graph_from_arcs(p_graph, vertices, arcs, p_arcs);
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_arcs, 0);
+
+    // Done
+    return ret;
+}
+
+/** !
+ * Read a graph from a DIMACS shortest path file. Vertices are numbered from 1, and
+ * each line "a u v w" is an arc from u to v of weight w
+ *
+ * @param p_graph return
+ * @param path    the path to the file
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_graph_load ( struct priority_queue_graph_s *const p_graph, const char *const path )
+{
+
+    // Initialized data
+    FILE               *p_file     = fopen(path, "r");
+    char                line[256]  = { 0 };
+    unsigned long long  vertices   = 0,
+                        arcs       = 0,
+                        u          = 0,
+                        v          = 0,
+                        w          = 0;
+    size_t              count      = 0;
+    uint32_t           *p_arcs     = (void *) 0;
+    int                 ret        = 0;
+
+    // Error checking
+    if ( p_file == (void *) 0 ) goto failed_to_open_file;
+
+    // Read each line
+    while ( fgets(line, sizeof(line), p_file) )
+    {
+
+        // The problem line holds the quantity of vertices and arcs ...
+        if ( line[0] == 'p' && p_arcs == (void *) 0 )
+        {
+
+            // Parse the problem line
+            if ( sscanf(line, "p sp %llu %llu", &vertices, &arcs) != 2 || vertices == 0 || vertices >= UINT32_MAX ) goto invalid_file;
+
+            // Allocate the arcs
+            p_arcs = PRIORITY_QUEUE_REALLOC(0, ( arcs + 1 ) * 3 * sizeof(uint32_t));
+
+            // Error checking
+            if ( p_arcs == (void *) 0 ) goto invalid_file;
+        }
+
+        // ... and each arc line holds an arc
+        else if ( line[0] == 'a' )
+        {
+
+            // Parse the arc
+            if ( p_arcs == (void *) 0 || count >= arcs || sscanf(line, "a %llu %llu %llu", &u, &v, &w) != 3 ) goto invalid_file;
+            if ( u == 0 || u > vertices || v == 0 || v > vertices || w > UINT32_MAX ) goto invalid_file;
+
+            // Store the arc
+            p_arcs[3 * count + 0] = (uint32_t) ( u - 1 ),
+            p_arcs[3 * count + 1] = (uint32_t) ( v - 1 ),
+            p_arcs[3 * count + 2] = (uint32_t) w;
+            count++;
+        }
+    }
+
+    // Construct the graph
+    ret = ( p_arcs != (void *) 0 ) && priority_queue_graph_from_arcs(p_graph, (size_t) vertices, count, p_arcs);
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_arcs, 0);
+    fclose(p_file);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+        failed_to_open_file:
+            #ifndef NDEBUG
+                printf("[priority queue] [benchmark] Failed to open \"%s\" in call to function \"%s\"\n", path, __FUNCTION__);
+            #endif
+
+            // Error
+            return 0;
+
+        invalid_file:
+            #ifndef NDEBUG
+                printf("[priority queue] [benchmark] \"%s\" is not a DIMACS shortest path file in call to function \"%s\"\n", path, __FUNCTION__);
+            #endif
+
+            // Clean up
+            PRIORITY_QUEUE_REALLOC(p_arcs, 0);
+            fclose(p_file);
+
+            // Error
+            return 0;
+    }
+}
+
+/** !
+ * Dijkstra's shortest paths from vertex 0
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue, with room for an entry for each arc
+ * @param p_input          the graph
+ * @param p_count          return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_dijkstra ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, const struct priority_queue_workload_input_s *const p_input, struct priority_queue_workload_count_s *const p_count )
+{
+
+    // Initialized data
+    const struct priority_queue_graph_s *p_graph  = &p_input->graph;
+    uint32_t                            *p_dist   = PRIORITY_QUEUE_REALLOC(0, p_graph->vertices * sizeof(uint32_t)),
+                                         vertex   = 0,
+                                         value    = 0;
+    size_t                               queued   = 0;
+
+    // Error checking
+    if ( p_dist == (void *) 0 ) return 0;
+
+    // Start at vertex 0
+    memset(p_dist, 0xFF, p_graph->vertices * sizeof(uint32_t));
+    p_dist[0] = 0;
+    priority_queue_workload_enqueue(p_queue, p_priority_queue, 0, 0), queued++, p_count->enqueues++;
+
+    // Settle the closest vertex
+    while ( queued )
+    {
+
+        // Dequeue the closest vertex
+        priority_queue_workload_dequeue(p_queue, p_priority_queue, &vertex, &value), queued--, p_count->dequeues++;
+
+        // Skip a vertex that was reached again, by a shorter path
+        if ( value > p_dist[vertex] ) { p_count->stale++; continue; }
+
+        // Relax each arc
+        for (size_t a = p_graph->p_first[vertex]; a < p_graph->p_first[vertex + 1]; a++)
+        {
+
+            // Initialized data
+            uint32_t target = p_graph->p_target[a],
+                     dist   = value + p_graph->p_weight[a];
+
+            // Skip a longer path
+            if ( dist >= p_dist[target] ) continue;
+
+            // Decrease the key of a reached vertex, by enqueueing it again
+            if ( p_dist[target] != UINT32_MAX ) p_count->decreases++;
+            p_dist[target] = dist;
+            priority_queue_workload_enqueue(p_queue, p_priority_queue, target, dist), queued++, p_count->enqueues++;
+        }
+    }
+
+    // Sum the distances
+    for (size_t v = 0; v < p_graph->vertices; v++)
+        if ( p_dist[v] != UINT32_MAX ) p_count->checksum += p_dist[v];
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_dist, 0);
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Prim's minimum spanning tree, from vertex 0
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue, with room for an entry for each arc
+ * @param p_input          the graph
+ * @param p_count          return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_prim ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, const struct priority_queue_workload_input_s *const p_input, struct priority_queue_workload_count_s *const p_count )
+{
+
+    // Initialized data
+    const struct priority_queue_graph_s *p_graph  = &p_input->graph;
+    uint32_t                            *p_best   = PRIORITY_QUEUE_REALLOC(0, p_graph->vertices * sizeof(uint32_t)),
+                                         vertex   = 0,
+                                         value    = 0;
+    unsigned char                       *p_tree   = PRIORITY_QUEUE_REALLOC(0, p_graph->vertices);
+    size_t                               queued   = 0;
+
+    // Error checking
+    if ( p_best == (void *) 0 || p_tree == (void *) 0 ) goto no_mem;
+
+    // Start at vertex 0
+    memset(p_best, 0xFF, p_graph->vertices * sizeof(uint32_t));
+    memset(p_tree, 0, p_graph->vertices);
+    p_best[0] = 0;
+    priority_queue_workload_enqueue(p_queue, p_priority_queue, 0, 0), queued++, p_count->enqueues++;
+
+    // Add the closest vertex to the tree
+    while ( queued )
+    {
+
+        // Dequeue the closest vertex
+        priority_queue_workload_dequeue(p_queue, p_priority_queue, &vertex, &value), queued--, p_count->dequeues++;
+
+        // Skip a vertex that is already in the tree
+        if ( p_tree[vertex] ) { p_count->stale++; continue; }
+
+        // Add the vertex, and the weight of its arc
+        p_tree[vertex]     = 1;
+        p_count->checksum += value;
+
+        // Offer each arc out of the tree
+        for (size_t a = p_graph->p_first[vertex]; a < p_graph->p_first[vertex + 1]; a++)
+        {
+
+            // Initialized data
+            uint32_t target = p_graph->p_target[a],
+                     weight = p_graph->p_weight[a];
+
+            // Skip a vertex in the tree, or a heavier arc
+            if ( p_tree[target] || weight >= p_best[target] ) continue;
+
+            // Decrease the key of an offered vertex, by enqueueing it again
+            if ( p_best[target] != UINT32_MAX ) p_count->decreases++;
+            p_best[target] = weight;
+            priority_queue_workload_enqueue(p_queue, p_priority_queue, target, weight), queued++, p_count->enqueues++;
+        }
+    }
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_best, 0);
+    PRIORITY_QUEUE_REALLOC(p_tree, 0);
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+        no_mem:
+
+            // Clean up
+            PRIORITY_QUEUE_REALLOC(p_best, 0);
+            PRIORITY_QUEUE_REALLOC(p_tree, 0);
+
+            // Error
+            return 0;
+    }
+}
+
+/** !
+ * A* from the top left to the bottom right of a grid, moving between open cells
+ * that share an edge. Entering a cell costs its weight, and the heuristic is the 
+ * Manhattan distance, since the lowest weight is 1
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue, with room for 4 entries for each cell
+ * @param p_input          the grid
+ * @param p_count          return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_astar ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, const struct priority_queue_workload_input_s *const p_input, struct priority_queue_workload_count_s *const p_count )
+{
+
+    // Initialized data
+    size_t    side   = p_input->side,
+              cells  = side * side,
+              queued = 0;
+    uint32_t *p_cost = PRIORITY_QUEUE_REALLOC(0, cells * sizeof(uint32_t)),
+              cell   = 0,
+              value  = 0;
+
+    // Error checking
+    if ( p_cost == (void *) 0 ) return 0;
+
+    // Start at the top left
+    memset(p_cost, 0xFF, cells * sizeof(uint32_t));
+    p_cost[0] = 0;
+    priority_queue_workload_enqueue(p_queue, p_priority_queue, 0, (uint32_t) ( 2 * ( side - 1 ) )), queued++, p_count->enqueues++;
+
+    // Expand the most promising cell
+    while ( queued )
+    {
+
+        // Initialized data
+        size_t   x         = 0,
+                 y         = 0;
+        uint32_t neighbours[4] = { 0 },
+                 n             = 0;
+
+        // Dequeue the most promising cell
+        priority_queue_workload_dequeue(p_queue, p_priority_queue, &cell, &value), queued--, p_count->dequeues++;
+
+        // Stop at the bottom right
+        if ( cell == cells - 1 ) break;
+
+        // Skip a cell that was reached again, by a cheaper path
+        x = cell % side, y = cell / side;
+        if ( value - (uint32_t) ( ( side - 1 - x ) + ( side - 1 - y ) ) > p_cost[cell] ) { p_count->stale++; continue; }
+
+        // Find the neighbours
+        if ( x > 0        ) neighbours[n++] = cell - 1;
+        if ( x < side - 1 ) neighbours[n++] = cell + 1;
+        if ( y > 0        ) neighbours[n++] = cell - (uint32_t) side;
+        if ( y < side - 1 ) neighbours[n++] = cell + (uint32_t) side;
+
+        // Enter each open neighbour
+        for (uint32_t i = 0; i < n; i++)
+        {
+
+            // Initialized data
+            uint32_t next = neighbours[i],
+                     cost = p_cost[cell] + p_input->p_weight[next];
+
+            // Skip a wall, or a more expensive path
+            if ( p_input->p_weight[next] == 0 || cost >= p_cost[next] ) continue;
+
+            // Decrease the key of a reached cell, by enqueueing it again
+            if ( p_cost[next] != UINT32_MAX ) p_count->decreases++;
+            p_cost[next] = cost;
+            priority_queue_workload_enqueue(p_queue, p_priority_queue, next, cost + (uint32_t) ( ( side - 1 - next % side ) + ( side - 1 - next / side ) )), queued++, p_count->enqueues++;
+        }
+    }
+
+    // The cost of the path, if there is one
+    p_count->checksum = p_cost[cells - 1];
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(p_cost, 0);
+
+    // Success
+    return 1;
+}
+
+/** !
+ * The hold model of a discrete event simulation. Each step dequeues the next event,
+ * and schedules it again, a random time later. The times dequeued are the same for
+ * every kind of heap
+ *
+ * @param p_queue          the kind of heap
+ * @param p_priority_queue the priority queue, with room for an entry for each event
+ * @param p_input          the quantity of events
+ * @param p_count          return
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_hold ( const struct priority_queue_workload_queue_s *const p_queue, priority_queue *const p_priority_queue, const struct priority_queue_workload_input_s *const p_input, struct priority_queue_workload_count_s *const p_count )
+{
+
+    // Initialized data
+    uint64_t state = 0xda3e39cb94b95bdbULL;
+    uint32_t event = 0,
+             time  = 0;
+
+    // Schedule each event
+    for (size_t i = 0; i < p_input->events; i++)
+        priority_queue_workload_enqueue(p_queue, p_priority_queue, (uint32_t) i, (uint32_t) ( priority_queue_benchmark_random(&state) % 65536 )), p_count->enqueues++;
+
+    // Hold
+    for (size_t i = 0; i < 8 * p_input->events; i++)
+    {
+
+        // Dequeue the next event
+        priority_queue_workload_dequeue(p_queue, p_priority_queue, &event, &time), p_count->dequeues++;
+        p_count->checksum += time;
+
+        // Schedule it again
+        priority_queue_workload_enqueue(p_queue, p_priority_queue, event, time + (uint32_t) ( priority_queue_benchmark_random(&state) % 256 )), p_count->enqueues++;
+    }
+
+    // Success
+    return 1;
+}
+
+/** !
+ * Run a workload on one kind of heap, and print the wall time, the operations, and
+ * the growth of the resident set. On POSIX systems, the workload runs in its own 
+ * process, so the peak of each run is measured from the same baseline
+ *
+ * @param p_workload the workload
+ * @param p_queue    the kind of heap
+ * @param p_input    the input
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_run ( const struct priority_queue_workload_s *const p_workload, const struct priority_queue_workload_queue_s *const p_queue, const struct priority_queue_workload_input_s *const p_input )
+{
+
+    // Initialized data
+    priority_queue                         *p_priority_queue = (void *) 0;
+    struct priority_queue_workload_count_s  _count           = { 0 };
+    timestamp                               t0               = 0,
+                                            t1               = 0;
+    long                                    peak             = 0;
+
+    #ifndef _WIN64
+
+        // Initialized data
+        struct rusage _usage  = { 0 };
+        pid_t         pid     = 0;
+        int           status  = 0;
+
+        // Run the workload in a child process
+        fflush(stdout);
+        pid = fork();
+
+        // Error checking
+        if ( pid < 0 ) return 0;
+
+        // Wait for the child
+        if ( pid > 0 ) return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+        // The peak of the child starts at the resident set of the parent
+        getrusage(RUSAGE_SELF, &_usage);
+        peak = -_usage.ru_maxrss;
+    #endif
+
+    // Construct the priority queue
+    if ( priority_queue_workload_construct(p_queue, p_workload->pfn_size(p_input), &p_priority_queue) == 0 ) goto failed_to_construct;
+
+    // Run the workload
+    t0 = timer_high_precision();
+    if ( p_workload->pfn_run(p_queue, p_priority_queue, p_input, &_count) == 0 ) goto failed_to_construct;
+    t1 = timer_high_precision();
+
+    // Measure the growth of the resident set
+    #ifndef _WIN64
+        getrusage(RUSAGE_SELF, &_usage);
+        peak += _usage.ru_maxrss;
+    #endif
+
+    // Print the results
+    printf("%-10s %-12s %10.2f ms %12zu %12zu %12zu %12zu %10ld KiB %20llu\n",
+        p_workload->name, p_queue->name,
+        (double) ( t1 - t0 ) * 1e3 / (double) timer_seconds_divisor(),
+        _count.enqueues, _count.dequeues, _count.decreases, _count.stale,
+        peak, (unsigned long long) _count.checksum
+    );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Exit the child
+    #ifndef _WIN64
+        fflush(stdout);
+        _exit(0);
+    #endif
+
+    // Success
+    return 1;
+
+    // Error handling
+    {
+        failed_to_construct:
+            #ifndef NDEBUG
+                printf("[priority queue] [benchmark] Failed to run \"%s\" on \"%s\" in call to function \"%s\"\n", p_workload->name, p_queue->name, __FUNCTION__);
+            #endif
+
+            // Exit the child
+            #ifndef _WIN64
+                fflush(stdout);
+                _exit(1);
+            #endif
+
+            // Error
+            return 0;
+    }
+}
+
+// The quantity of keys each workload may enqueue
+static size_t priority_queue_workload_size_graph ( const struct priority_queue_workload_input_s *const p_input ) { return p_input->graph.arcs + 1; }
+static size_t priority_queue_workload_size_grid  ( const struct priority_queue_workload_input_s *const p_input ) { return 4 * p_input->side * p_input->side + 1; }
+static size_t priority_queue_workload_size_hold  ( const struct priority_queue_workload_input_s *const p_input ) { return p_input->events; }
+
+// Data
+static const struct priority_queue_workload_s workloads[] =
+{
+    { "dijkstra", priority_queue_workload_size_graph, priority_queue_workload_dijkstra },
+    { "prim",     priority_queue_workload_size_graph, priority_queue_workload_prim     },
+    { "astar",    priority_queue_workload_size_grid,  priority_queue_workload_astar    },
+    { "hold",     priority_queue_workload_size_hold,  priority_queue_workload_hold     }
+};
+
+/** !
+ * Run each workload on each kind of heap
+ *
+ * @param size the approximate quantity of vertices, of grid cells, and of events times 10
+ * @param path the path to a DIMACS shortest path file, or null to generate a graph
+ *
+ * @return 1 on success, 0 on error
+ */
+static int priority_queue_workload_main ( size_t size, const char *const path )
+{
+
+    // Initialized data
+    struct priority_queue_workload_input_s _input = { 0 };
+    uint64_t                               state  = 0x6a09e667f3bcc909ULL;
+    int                                    ret    = 1;
+
+    // Read or generate the graph
+    if ( ( path ? priority_queue_graph_load(&_input.graph, path) : priority_queue_graph_generate(&_input.graph, size) ) == 0 ) return 0;
+
+    // Find the side of the grid
+    for (_input.side = 1; ( _input.side + 1 ) * ( _input.side + 1 ) <= size; _input.side++);
+
+    // Make the grid. One cell in five is a wall, and the rest cost 1 to 9 to enter
+    _input.p_weight = PRIORITY_QUEUE_REALLOC(0, _input.side * _input.side);
+    if ( _input.p_weight == (void *) 0 ) goto no_mem;
+    for (size_t i = 0; i < _input.side * _input.side; i++)
+    {
+
+        // Initialized data
+        uint64_t r = priority_queue_benchmark_random(&state);
+
+        // Make a wall or an open cell
+        _input.p_weight[i] = ( r % 5 == 0 ) ? 0 : (unsigned char) ( r / 5 % 9 + 1 );
+    }
+
+    // Open a random monotone corridor from the first corner to the last, so the target 
+    // is reachable at every size, and A* searches instead of flooding the grid
+    for (size_t x = 0, y = 0; x + 1 < _input.side || y + 1 < _input.side;)
+    {
+
+        // Step right or down
+        if      ( x + 1 == _input.side                        ) y++;
+        else if ( y + 1 == _input.side                        ) x++;
+        else if ( priority_queue_benchmark_random(&state) & 1 ) x++;
+        else                                                    y++;
+
+        // Open the cell
+        if ( _input.p_weight[y * _input.side + x] == 0 ) _input.p_weight[y * _input.side + x] = (unsigned char) ( priority_queue_benchmark_random(&state) % 9 + 1 );
+    }
+    _input.p_weight[0] = _input.p_weight[_input.side * _input.side - 1] = 1;
+
+    // Store the quantity of events
+    _input.events = ( size / 10 ) ? size / 10 : 1;
+
+    // Print the inputs, and the columns
+    printf("graph: %zu vertices, %zu arcs; grid: %zu x %zu; hold: %zu events\n", _input.graph.vertices, _input.graph.arcs, _input.side, _input.side, _input.events);
+    printf("%-10s %-12s %13s %12s %12s %12s %12s %14s %20s\n", "workload", "heap", "time", "enqueues", "dequeues", "decreases", "stale", "peak", "checksum");
+
+    // Run each workload on each kind of heap
+    for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++)
+        for (size_t q = 0; q < sizeof(workload_queues) / sizeof(workload_queues[0]); q++)
+            if ( priority_queue_workload_run(&workloads[w], &workload_queues[q], &_input) == 0 ) ret = 0;
+
+    // Clean up
+    PRIORITY_QUEUE_REALLOC(_input.p_weight, 0);
+    PRIORITY_QUEUE_REALLOC(_input.graph.p_first, 0);
+    PRIORITY_QUEUE_REALLOC(_input.graph.p_target, 0);
+    PRIORITY_QUEUE_REALLOC(_input.graph.p_weight, 0);
+
+    // Done
+    return ret;
+
+    // Error handling
+    {
+        no_mem:
+            #ifndef NDEBUG
+                printf("[Standard Library] Failed to allocate memory in call to function \"%s\"\n", __FUNCTION__);
+            #endif
+
+            // Clean up
+            PRIORITY_QUEUE_REALLOC(_input.graph.p_first, 0);
+            PRIORITY_QUEUE_REALLOC(_input.graph.p_target, 0);
+            PRIORITY_QUEUE_REALLOC(_input.graph.p_weight, 0);
+
+            // Error
+            return 0;
+    }
+}
+
+// Entry point
+int main ( int argc, const char *argv[] )
+{
+
+    // Initialized data
+    size_t how_many = ( argc > 1 ) ? (size_t) strtoull(argv[1], (void *) 0, 10) : 1000000;
+
+    // Initialize the timer
+    timer_init();
+
+    // Run the workloads
+    if ( argc > 1 && strcmp(argv[1], "workload") == 0 )
+    {
+
+        // Initialized data
+        size_t size = ( argc > 2 ) ? (size_t) strtoull(argv[2], (void *) 0, 10) : 1000000;
+
+        // Argument check
+        if ( size < 4 ) goto usage;
+
+        // Run each workload on each kind of heap
+        return priority_queue_workload_main(size, ( argc > 3 ) ? argv[3] : (void *) 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Argument check
+    if ( how_many == 0 ) goto usage;
+
+    // Time each heap
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+        if ( priority_queue_benchmark_run(&benchmarks[i], how_many) == 0 ) return EXIT_FAILURE;
+
+    // Success
+    return EXIT_SUCCESS;
+
+    // Error handling
+    {
+        usage:
+
+            // Print a usage message
+            fprintf(stderr, "Usage: %s [quantity of keys]\n       %s workload [quantity of vertices] [graph.gr]\n", argv[0], argv[0]);
+
+            // Error
+            return EXIT_FAILURE;
+    }
+}
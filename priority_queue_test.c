@@ -11,7 +11,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#ifndef _WIN64
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include <priority_queue/priority_queue.h>
+#include <priority_queue/priority_queue_inline.h>
 #include <log/log.h>
 
 // Possible keys ( A is highest, G is lowest, X will never occor)
@@ -31,6 +39,8 @@ const void * G_keys       [] = {7, 0x0};
 const void * DG_keys      [] = {4, 7, 0x0};
 const void * AD_keys      [] = {1, 4, 0x0};
 const void * ABCDEFG_keys [] = {1, 2, 3, 4, 5, 6, 7, 0x0};
+const void * ABCDF_keys   [] = {1, 2, 3, 4, 6, 0x0};
+const void * ACDF_keys    [] = {1, 3, 4, 6, 0x0};
 
 // Test results
 enum result_e
@@ -72,6 +82,67 @@ int empty_insertrandom_ABCDEFG    ( priority_queue **pp_priority_queue );
 
 bool test_enqueue ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), void     *value, result_t expected);
 bool test_isempty ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), result_t  expected);
+bool test_drain   ( priority_queue *p_priority_queue, const void **expected_keys );
+
+int test_mapped_priority_queue ( char *name );
+int test_save_load_priority_queue ( char *name );
+int test_drain_sorted_priority_queue ( char *name );
+int test_blocked_priority_queue ( char *name );
+int test_typed_priority_queue ( char *name );
+int test_external_priority_queue ( char *name );
+int test_sequence_priority_queue ( char *name );
+int test_stats_priority_queue ( char *name );
+int test_histograms_priority_queue ( char *name );
+int test_trace_priority_queue ( char *name );
+int test_unchecked_priority_queue ( char *name );
+int test_from_keys_priority_queue ( char *name );
+int test_sorted_copy_priority_queue ( char *name );
+int test_notify_priority_queue ( char *name );
+int test_aging_priority_queue ( char *name );
+int test_bucket_priority_queue ( char *name );
+int test_invalidate_priority_queue ( char *name );
+int test_reprioritize_priority_queue ( char *name );
+int test_snapshot_priority_queue ( char *name );
+bool test_compact_invalidate ( double threshold )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    uint32_t        index            = 0,
+                    priority         = 0;
+    bool            result           = true;
+
+    // Build the priority queue
+    compact_1009(&p_priority_queue);
+    priority_queue_compact_threshold_set(p_priority_queue, threshold);
+
+    // Invalidate every index with a priority that is not 2 mod 3, which includes the front
+    for (uint32_t i = 0; result && i < 1009; i++)
+        if ( i * 7919 % 1009 % 3 != 2 ) result = priority_queue_invalidate(p_priority_queue, (void *) (uintptr_t) i);
+
+    // The front is the first live index
+    if ( result ) result = priority_queue_peek(p_priority_queue, &p_value) && ( (uintptr_t) p_value * 7919 % 1009 == 2 );
+
+    // Only the live indices come out, in order of priority
+    for (uint32_t p = 2; result && p < 1009; p += 3)
+        result = priority_queue_dequeue_index(p_priority_queue, &index, &priority)
+              && ( priority == p ) && ( (uint64_t) index * 7919 % 1009 == p );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue) && ( priority_queue_dequeue_index(p_priority_queue, &index, 0) == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_compact_priority_queue ( char *name );
+int test_branchless_priority_queue ( char *name );
+int test_fair_priority_queue ( char *name );
+int test_delay_priority_queue ( char *name );
 bool test_dequeue ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), void     *value, size_t how_many, result_t expected);
 
 extern int priority_queue_heapify         ( priority_queue *const p_priority_queue , size_t   i );
@@ -231,6 +302,75 @@ int run_tests()
     // [] -> insert(D, F, A, C, E, B, G) -> [A, B, C, D, E, F, G]
     test_seven_element_priority_queue(empty_insertrandom_ABCDEFG, "empty_insertrandom_ABCDEFG", ABCDEFG_keys);
 
+    // [] -> insert(D, F, A, C) -> checkpoint() -> insert(B) -> destroy() -> map() -> [A, B, C, D, F]
+    test_mapped_priority_queue("mapped");
+
+    // [D, F, A, C, E, B, G] -> save() -> load() -> [A, B, C, D, E, F, G]
+    test_save_load_priority_queue("save_load");
+
+    // [D, F, A, C, E, B, G] -> drain_sorted() -> []
+    test_drain_sorted_priority_queue("drain_sorted");
+
+    // [] -> insert(2000 ... 1) -> [1 ... 2000], with the blocked layout
+    test_blocked_priority_queue("blocked");
+
+    // [] -> enqueue_priority(random) -> [lowest ... highest], with u32, u64, and float priorities
+    test_typed_priority_queue("typed");
+
+    // [] -> insert(5000 keys) -> spill() -> merge() -> [1 ... 5000], with a 4 KB memory budget
+    test_external_priority_queue("external");
+
+    // [] -> insert(100000 keys) -> [1 ... 100000], with the sequence layout
+    test_sequence_priority_queue("sequence");
+
+    // [] -> enqueue(ABCDEFG) -> dequeue(7) -> stats() -> stats_reset() -> stats()
+    test_stats_priority_queue("stats");
+
+    // [] -> enqueue(1000 keys) -> dequeue(1000) -> histogram_snapshot() -> histogram_merge()
+    test_histograms_priority_queue("histograms");
+
+    // [] -> trace_set() -> enqueue(ABCDEFG) -> dequeue(7) -> trace_set(0)
+    test_trace_priority_queue("trace");
+
+    // [] -> enqueue_unchecked(1000 keys) -> [1 ... 1000], with the binary and blocked layouts
+    test_unchecked_priority_queue("unchecked");
+
+    // [D, F, A, C, E, B, G] -> from_keys() -> [A, B, C, D, E, F, G], and 200000 keys on 4 threads
+    test_from_keys_priority_queue("from_keys");
+
+    // [1 ... 200000] -> sorted_copy_parallel() -> [1 ... 200000], and the priority queue keeps its keys
+    test_sorted_copy_priority_queue("sorted_copy");
+
+    // [] -> get_fd() -> enqueue(A, B, C) -> readable -> dequeue(3) -> not readable
+    test_notify_priority_queue("notify");
+
+    // [] -> aging_set(2) -> enqueue(101, then 200 x 50) -> 101 is dequeued after 25 keys, not 200
+    test_aging_priority_queue("aging");
+
+    // [] -> enqueue(10000 keys, across 256 levels) -> [level 0 ... level 255], first in, first out within a level
+    test_bucket_priority_queue("bucket");
+
+    // [1 ... 2000] -> invalidate(every third key) -> [the other keys], with and without compaction
+    test_invalidate_priority_queue("invalidate");
+
+    // [1 ... N] -> reprioritize(k -> 2(N + 1 - k)) -> [2, 4, ... 2N], with a linear rebuild
+    test_reprioritize_priority_queue("reprioritize");
+
+    // [1 ... N] -> for_each / snapshot -> modify -> the snapshot still holds [1 ... N]
+    test_snapshot_priority_queue("snapshot");
+
+    // [] -> enqueue_index(i, 7919i mod N) -> dequeue_index -> [in order of priority], in 8 bytes per entry
+    test_compact_priority_queue("compact");
+
+    // [] -> enqueue(random priorities, with ties and the largest priorities) -> dequeue -> [in order of priority], at each arity
+    test_branchless_priority_queue("branchless");
+
+    // [tenant 0: 1 ... N, tenant 1: 1 ... N, ...] -> fair_dequeue -> [shared by weight and cost, each tenant in order]
+    test_fair_priority_queue("fair");
+
+    // [1 ready now, 2 ready later, ...] -> delay_dequeue -> [each key once ready, in order of priority]
+    test_delay_priority_queue("delay");
+
     // Success
     return 1;
 }
@@ -594,4 +734,2599 @@ bool test_isempty(int (*priority_queue_constructor)(priority_queue **pp_priority
 
     // Return result
     return (result == expected);
-}
\ No newline at end of file
+}
+
+bool test_drain_sorted ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), const void **expected_keys )
+{
+
+    // Initialized data
+    priority_queue  *p_priority_queue = 0;
+    void           **pp_keys          = 0;
+    size_t           count            = 0;
+    bool             result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Drain the priority queue
+    if ( priority_queue_drain_sorted(p_priority_queue, &pp_keys, &count) == 0 ) result = false;
+
+    // Check each key
+    for (size_t i = 0; result && expected_keys[i]; i++)
+        if ( i >= count || pp_keys[i] != expected_keys[i] ) result = false;
+
+    // Check the priority queue is empty, and still usable
+    if ( result ) result = priority_queue_empty(p_priority_queue) && priority_queue_enqueue(p_priority_queue, A_key);
+
+    // Free the keys and the priority queue
+    PRIORITY_QUEUE_REALLOC(pp_keys, 0);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_drain_sorted_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Drain an empty priority queue
+    print_test(name, "priority_queue_drain_sorted_empty", test_drain_sorted(construct_empty, _keys));
+
+    // Drain a full priority queue
+    print_test(name, "priority_queue_drain_sorted_ABCDEFG", test_drain_sorted(empty_insertrandom_ABCDEFG, ABCDEFG_keys));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int blocked_insertrandom_ABCDEFG ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a blocked priority queue
+    priority_queue_construct_with_layout(pp_priority_queue, 10, 0, PRIORITY_QUEUE_LAYOUT_BLOCKED);
+
+    // insert random values
+    priority_queue_insert(*pp_priority_queue, D_key);
+    priority_queue_insert(*pp_priority_queue, F_key);
+    priority_queue_insert(*pp_priority_queue, A_key);
+    priority_queue_insert(*pp_priority_queue, C_key);
+    priority_queue_insert(*pp_priority_queue, E_key);
+    priority_queue_insert(*pp_priority_queue, B_key);
+    priority_queue_insert(*pp_priority_queue, G_key);
+
+    // priority queue = [A, B, C, D, E, F, G]
+    return 1;
+}
+
+int blocked_insertdecending_2000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a blocked priority queue, spanning several pages
+    priority_queue_construct_with_layout(pp_priority_queue, 2000, 0, PRIORITY_QUEUE_LAYOUT_BLOCKED);
+
+    // insert decending values
+    for (size_t i = 2000; i > 0; i--)
+        priority_queue_enqueue(*pp_priority_queue, (void *) i);
+
+    // priority queue = [1 ... 2000]
+    return 1;
+}
+
+bool test_dequeue_ascending ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Dequeue 1 ... how_many
+    for (size_t i = 1; result && i <= how_many; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_blocked_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven keys, in one block
+    print_test(name, "priority_queue_dequeue_ABCDEFG", test_dequeue(blocked_insertrandom_ABCDEFG, D_key, 4, match));
+
+    // two thousand keys, across blocks
+    print_test(name, "priority_queue_dequeue_2000", test_dequeue_ascending(blocked_insertdecending_2000, 2000));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int sequence_insertrandom_ABCDEFG ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a sequence heap
+    priority_queue_construct_with_layout(pp_priority_queue, 10, 0, PRIORITY_QUEUE_LAYOUT_SEQUENCE);
+
+    // insert random values
+    priority_queue_insert(*pp_priority_queue, D_key);
+    priority_queue_insert(*pp_priority_queue, F_key);
+    priority_queue_insert(*pp_priority_queue, A_key);
+    priority_queue_insert(*pp_priority_queue, C_key);
+    priority_queue_insert(*pp_priority_queue, E_key);
+    priority_queue_insert(*pp_priority_queue, B_key);
+    priority_queue_insert(*pp_priority_queue, G_key);
+
+    // priority queue = [A, B, C, D, E, F, G]
+    return 1;
+}
+
+int sequence_insertrandom_100000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a sequence heap, with enough keys to fill more than one group
+    priority_queue_construct_with_layout(pp_priority_queue, 100000, 0, PRIORITY_QUEUE_LAYOUT_SEQUENCE);
+
+    // insert a permutation of 1 ... 100000
+    for (size_t i = 0; i < 100000; i++)
+        priority_queue_enqueue(*pp_priority_queue, (void *) ( ( i * 7919 ) % 100000 + 1 ));
+
+    // priority queue = [1 ... 100000]
+    return 1;
+}
+
+bool test_sequence_interleaved ( void )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Construct a sequence heap with room for 10000 keys
+    priority_queue_construct_with_layout(&p_priority_queue, 10000, 0, PRIORITY_QUEUE_LAYOUT_SEQUENCE);
+
+    // Fill it with a permutation of 1 ... 10000
+    for (size_t i = 0; result && i < 10000; i++)
+        result = priority_queue_enqueue(p_priority_queue, (void *) ( ( i * 7919 ) % 10000 + 1 ));
+
+    // Check it is full
+    if ( result ) result = ( priority_queue_enqueue(p_priority_queue, A_key) == 0 );
+
+    // Dequeue 1 ... 3000
+    for (size_t i = 1; result && i <= 3000; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Enqueue 1 ... 3000 again, ahead of the sorted sequences
+    for (size_t i = 1; result && i <= 3000; i++)
+        result = priority_queue_enqueue(p_priority_queue, (void *) i);
+
+    // Dequeue 1 ... 10000
+    for (size_t i = 1; result && i <= 10000; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_sequence_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven keys, in the insertion heap
+    print_test(name, "priority_queue_dequeue_ABCDEFG", test_dequeue(sequence_insertrandom_ABCDEFG, D_key, 4, match));
+
+    // one hundred thousand keys, across groups
+    print_test(name, "priority_queue_dequeue_100000", test_dequeue_ascending(sequence_insertrandom_100000, 100000));
+
+    // Keys enqueued while others are in sequences
+    print_test(name, "priority_queue_dequeue_interleaved", test_sequence_interleaved());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_stats ( void )
+{
+
+    // Initialized data
+    priority_queue            *p_priority_queue = 0;
+    priority_queue_statistics  _statistics      = { 0 };
+    void                      *p_value          = 0;
+    bool                       result           = true;
+
+    // Construct a priority queue
+    priority_queue_construct(&p_priority_queue, 10, 0);
+
+    #ifdef PRIORITY_QUEUE_STATS
+
+        // Enqueue seven keys, and dequeue them
+        priority_queue_enqueue(p_priority_queue, D_key);
+        priority_queue_enqueue(p_priority_queue, F_key);
+        priority_queue_enqueue(p_priority_queue, A_key);
+        priority_queue_enqueue(p_priority_queue, C_key);
+        priority_queue_enqueue(p_priority_queue, E_key);
+        priority_queue_enqueue(p_priority_queue, B_key);
+        priority_queue_enqueue(p_priority_queue, G_key);
+        for (size_t i = 0; i < 7; i++) priority_queue_dequeue(p_priority_queue, &p_value);
+
+        // Check the counters
+        result = priority_queue_stats(p_priority_queue, &_statistics) &&
+                 _statistics.enqueues          == 7 &&
+                 _statistics.dequeues          == 7 &&
+                 _statistics.comparisons        > 0 &&
+                 _statistics.high_water        == 7 &&
+                 _statistics.lock_acquisitions >= 14;
+
+        // Reset the counters, and check they are zero
+        if ( result ) result = priority_queue_stats_reset(p_priority_queue) && priority_queue_stats(p_priority_queue, &_statistics);
+        if ( result ) result = _statistics.enqueues == 0 && _statistics.comparisons == 0 && _statistics.high_water == 0;
+    #else
+
+        // Statistics are not compiled in
+        (void) p_value;
+        result = ( priority_queue_stats(p_priority_queue, &_statistics) == 0 );
+    #endif
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_stats_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven enqueues and dequeues
+    print_test(name, "priority_queue_stats", test_stats());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_histograms ( void )
+{
+
+    // Initialized data
+    priority_queue           *p_priority_queue = 0;
+    priority_queue_histogram  _dequeues        = { 0 },
+                              _holds           = { 0 },
+                              _merged          = { 0 };
+    void                     *p_value          = 0;
+    bool                      result           = true;
+
+    // Construct a priority queue
+    priority_queue_construct(&p_priority_queue, 1000, 0);
+
+    #ifdef PRIORITY_QUEUE_HISTOGRAMS
+
+        // Enqueue a permutation of 1 ... 1000, and dequeue it
+        for (size_t i = 0; i < 1000; i++) priority_queue_enqueue(p_priority_queue, (void *) ( ( i * 7919 ) % 1000 + 1 ));
+        for (size_t i = 0; i < 1000; i++) priority_queue_dequeue(p_priority_queue, &p_value);
+
+        // Check every dequeue, and every lock hold, was timed
+        result = priority_queue_histogram_snapshot(p_priority_queue, PRIORITY_QUEUE_OPERATION_DEQUEUE, &_dequeues) &&
+                 priority_queue_histogram_snapshot(p_priority_queue, PRIORITY_QUEUE_OPERATION_LOCK_HOLD, &_holds) &&
+                 _dequeues.count == 1000 &&
+                 _holds.count    == 2000;
+
+        // Check the percentiles are in order
+        if ( result ) result = _dequeues.min                                          <= priority_queue_histogram_percentile(&_dequeues, 50.0) &&
+                               priority_queue_histogram_percentile(&_dequeues, 50.0)  <= priority_queue_histogram_percentile(&_dequeues, 99.9) &&
+                               priority_queue_histogram_percentile(&_dequeues, 99.9)  <= _dequeues.max;
+
+        // Merge the snapshot twice, and check the percentiles are unchanged
+        if ( result ) result = priority_queue_histogram_merge(&_merged, &_dequeues) && priority_queue_histogram_merge(&_merged, &_dequeues);
+        if ( result ) result = _merged.count == 2000 &&
+                               _merged.min   == _dequeues.min &&
+                               priority_queue_histogram_percentile(&_merged, 99.9) == priority_queue_histogram_percentile(&_dequeues, 99.9);
+    #else
+
+        // Histograms are not compiled in, but merging and percentiles still work
+        (void) p_value, (void) _holds;
+        result = priority_queue_histogram_snapshot(p_priority_queue, PRIORITY_QUEUE_OPERATION_DEQUEUE, &_dequeues) == 0 &&
+                 priority_queue_histogram_merge(&_merged, &_dequeues) &&
+                 priority_queue_histogram_percentile(&_merged, 99.9) == 0;
+    #endif
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_histograms_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // one thousand enqueues and dequeues
+    print_test(name, "priority_queue_histogram", test_histograms());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+struct trace_counts_s
+{
+    size_t enqueues,
+           dequeues,
+           heapifies,
+           acquires,
+           releases;
+};
+
+void trace_enqueue ( const priority_queue *const p_priority_queue, const void *const p_key, void *const p_context )
+{
+
+    // Unused
+    (void) p_priority_queue, (void) p_key;
+
+    // Count the tracepoint
+    ( (struct trace_counts_s *) p_context )->enqueues++;
+}
+
+void trace_dequeue ( const priority_queue *const p_priority_queue, const void *const p_key, void *const p_context )
+{
+
+    // Unused
+    (void) p_priority_queue, (void) p_key;
+
+    // Count the tracepoint
+    ( (struct trace_counts_s *) p_context )->dequeues++;
+}
+
+void trace_heapify ( const priority_queue *const p_priority_queue, size_t index, size_t levels, void *const p_context )
+{
+
+    // Unused
+    (void) p_priority_queue, (void) index, (void) levels;
+
+    // Count the tracepoint
+    ( (struct trace_counts_s *) p_context )->heapifies++;
+}
+
+void trace_acquire ( const priority_queue *const p_priority_queue, void *const p_context )
+{
+
+    // Unused
+    (void) p_priority_queue;
+
+    // Count the tracepoint
+    ( (struct trace_counts_s *) p_context )->acquires++;
+}
+
+void trace_release ( const priority_queue *const p_priority_queue, void *const p_context )
+{
+
+    // Unused
+    (void) p_priority_queue;
+
+    // Count the tracepoint
+    ( (struct trace_counts_s *) p_context )->releases++;
+}
+
+bool test_trace ( void )
+{
+
+    // Initialized data
+    priority_queue        *p_priority_queue = 0;
+    struct trace_counts_s  _counts          = { 0 };
+    priority_queue_trace   _trace           = 
+    {
+        .pfn_enqueue      = trace_enqueue,
+        .pfn_dequeue      = trace_dequeue,
+        .pfn_heapify      = trace_heapify,
+        .pfn_lock_acquire = trace_acquire,
+        .pfn_lock_release = trace_release,
+        .p_context        = &_counts
+    };
+    void                  *p_value          = 0;
+    bool                   result           = true;
+
+    #ifdef PRIORITY_QUEUE_TRACE
+
+        // Set the callbacks
+        result = priority_queue_trace_set(&_trace);
+
+        // Enqueue seven keys, and dequeue them
+        priority_queue_construct(&p_priority_queue, 10, 0);
+        priority_queue_enqueue(p_priority_queue, D_key);
+        priority_queue_enqueue(p_priority_queue, F_key);
+        priority_queue_enqueue(p_priority_queue, A_key);
+        priority_queue_enqueue(p_priority_queue, C_key);
+        priority_queue_enqueue(p_priority_queue, E_key);
+        priority_queue_enqueue(p_priority_queue, B_key);
+        priority_queue_enqueue(p_priority_queue, G_key);
+        for (size_t i = 0; i < 7; i++) priority_queue_dequeue(p_priority_queue, &p_value);
+
+        // Remove the callbacks
+        priority_queue_trace_set(0);
+
+        // Check each tracepoint fired
+        if ( result ) result = _counts.enqueues  == 7 &&
+                               _counts.dequeues  == 7 &&
+                               _counts.heapifies >= 6 &&
+                               _counts.acquires  == _counts.releases &&
+                               _counts.acquires  >= 14;
+
+        // Check no tracepoint fires after the callbacks are removed
+        _counts.enqueues = 0;
+        priority_queue_enqueue(p_priority_queue, A_key);
+        if ( result ) result = _counts.enqueues == 0;
+
+        // Free the priority queue
+        priority_queue_destroy(&p_priority_queue);
+    #else
+
+        // Tracepoints are not compiled in
+        (void) p_priority_queue, (void) p_value;
+        result = ( priority_queue_trace_set(&_trace) == 0 );
+    #endif
+
+    // Return result
+    return result;
+}
+
+int test_trace_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven enqueues and dequeues
+    print_test(name, "priority_queue_trace_set", test_trace());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_unchecked ( priority_queue_layout layout, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Construct a priority queue
+    if ( priority_queue_construct_with_layout(&p_priority_queue, how_many, 0, layout) == 0 ) return false;
+
+    // Enqueue a permutation of 1 ... how_many
+    for (size_t i = 0; result && i < how_many; i++)
+        result = priority_queue_enqueue_unchecked(p_priority_queue, (void *) ( ( i * 7919 ) % how_many + 1 ));
+
+    // Check it is full, and the front is 1
+    if ( result ) result = ( priority_queue_enqueue_unchecked(p_priority_queue, A_key) == 0 );
+    if ( result ) result = priority_queue_peek_unchecked(p_priority_queue, &p_value) && ( p_value == (void *) 1 );
+
+    // Dequeue 1 ... how_many
+    for (size_t i = 1; result && i <= how_many; i++)
+        result = priority_queue_dequeue_unchecked(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check it is empty
+    if ( result ) result = ( priority_queue_dequeue_unchecked(p_priority_queue, &p_value) == 0 );
+    if ( result ) result = ( priority_queue_peek_unchecked(p_priority_queue, &p_value) == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+#ifndef _WIN64
+void *test_unchecked_producer ( void *p_parameter )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = p_parameter;
+
+    // Enqueue 1 ... 20000 through the unchecked path, waiting while the priority queue is full
+    for (size_t i = 1; i <= 20000; i++)
+        while ( priority_queue_enqueue_unchecked(p_priority_queue, (void *) i) == 0 );
+
+    // Done
+    return 0;
+}
+
+bool test_unchecked_concurrent ( void )
+{
+
+    // Initialized data
+    priority_queue  *p_priority_queue = 0;
+    void           **p_keys           = 0;
+    pthread_t        producer;
+    size_t           count            = 0,
+                     sum              = 0,
+                     total            = 0;
+    bool             result           = true;
+
+    // Construct a priority queue
+    if ( priority_queue_construct(&p_priority_queue, 1000, 0) == 0 ) return false;
+
+    // Start the producer
+    pthread_create(&producer, 0, test_unchecked_producer, p_priority_queue);
+
+    // Drain the priority queue while the producer fills it. Each drain replaces the 
+    // entries, and the eventfd disables the unchecked path part way through
+    for (size_t i = 0; result && total < 20000; i++)
+    {
+
+        // Take an eventfd
+        if ( i == 100 ) result = ( priority_queue_get_fd(p_priority_queue) != -1 );
+
+        // Drain every key
+        result = result && priority_queue_drain_sorted(p_priority_queue, &p_keys, &count);
+
+        // Sum the keys, and free the old entries
+        for (size_t j = 0; result && j < count; j++) sum += (size_t) p_keys[j];
+        total += count;
+        if ( result ) PRIORITY_QUEUE_REALLOC(p_keys, 0);
+    }
+
+    // Wait for the producer
+    pthread_join(producer, 0);
+
+    // Every key was drained once
+    result = result && ( total == 20000 ) && ( sum == (size_t) 20000 * 20001 / 2 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+#endif
+
+int test_unchecked_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // one thousand keys, inline
+    print_test(name, "priority_queue_dequeue_unchecked_binary", test_unchecked(PRIORITY_QUEUE_LAYOUT_BINARY, 1000));
+
+    // one thousand keys, through the checked path
+    print_test(name, "priority_queue_dequeue_unchecked_blocked", test_unchecked(PRIORITY_QUEUE_LAYOUT_BLOCKED, 1000));
+
+    #ifndef _WIN64
+
+        // unchecked enqueues race drains, which replace the entries, and an eventfd, which disables the unchecked path
+        print_test(name, "priority_queue_enqueue_unchecked_concurrent", test_unchecked_concurrent());
+    #endif
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int from_keys_ABCDEFG ( priority_queue **pp_priority_queue )
+{
+
+    // Initialized data
+    const char *keys[] = { D_key, F_key, A_key, C_key, E_key, B_key, G_key, 0 };
+
+    // Build a priority queue from null terminated keys, with room for more
+    priority_queue_from_keys((const priority_queue **) pp_priority_queue, keys, 10, 0);
+
+    // priority queue = [A, B, C, D, E, F, G]
+    return 1;
+}
+
+int from_keys_parallel_200000 ( priority_queue **pp_priority_queue )
+{
+
+    // Initialized data
+    const char **keys = malloc(200000 * sizeof(const char *));
+
+    // Make a permutation of 1 ... 200000
+    for (size_t i = 0; i < 200000; i++)
+        keys[i] = (const char *) ( ( i * 7919 ) % 200000 + 1 );
+
+    // Build a priority queue on four threads
+    priority_queue_from_keys_parallel((const priority_queue **) pp_priority_queue, keys, 200000, 0, 4);
+
+    // Free the keys
+    free(keys);
+
+    // priority queue = [1 ... 200000]
+    return 1;
+}
+
+int test_from_keys_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven keys
+    print_test(name, "priority_queue_dequeue_ABCDEFG", test_dequeue(from_keys_ABCDEFG, D_key, 4, match));
+
+    // two hundred thousand keys, built in parallel
+    print_test(name, "priority_queue_dequeue_200000", test_dequeue_ascending(from_keys_parallel_200000, 200000));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_sorted_copy ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many, size_t threads )
+{
+
+    // Initialized data
+    priority_queue  *p_priority_queue = 0;
+    void           **p_keys           = 0,
+                    *p_value          = 0;
+    size_t           count            = 0;
+    bool             result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Copy the keys
+    result = priority_queue_sorted_copy_parallel(p_priority_queue, &p_keys, &count, threads) && ( count == how_many );
+
+    // Check the copy is 1 ... how_many
+    for (size_t i = 0; result && i < count; i++)
+        result = ( p_keys[i] == (void *) ( i + 1 ) );
+
+    // Free the copy
+    PRIORITY_QUEUE_REALLOC(p_keys, 0);
+
+    // Check the priority queue still holds every key
+    for (size_t i = 1; result && i <= how_many; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_sorted_copy_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // two thousand keys, in blocks, on one thread
+    print_test(name, "priority_queue_sorted_copy_parallel_2000", test_sorted_copy(blocked_insertdecending_2000, 2000, 1));
+
+    // two hundred thousand keys, on four threads
+    print_test(name, "priority_queue_sorted_copy_parallel_200000", test_sorted_copy(from_keys_parallel_200000, 200000, 4));
+
+    // two hundred thousand keys, on one thread per processor
+    print_test(name, "priority_queue_sorted_copy_parallel_200000_nprocs", test_sorted_copy(from_keys_parallel_200000, 200000, 0));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+#ifndef _WIN64
+bool fd_readable ( int fd )
+{
+
+    // Initialized data
+    struct pollfd _pollfd = { .fd = fd, .events = POLLIN };
+
+    // Check the file descriptor, without waiting
+    return ( poll(&_pollfd, 1, 0) == 1 ) && ( _pollfd.revents & POLLIN );
+}
+
+int test_notify_priority_queue ( char *name )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    int             fd               = -1;
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Construct an empty priority queue, and get its eventfd
+    priority_queue_construct(&p_priority_queue, 10, 0);
+    fd = priority_queue_get_fd(p_priority_queue);
+
+    // An empty priority queue is not readable
+    print_test(name, "priority_queue_get_fd_empty", fd != -1 && fd_readable(fd) == false);
+
+    // A burst of enqueues makes it readable
+    priority_queue_enqueue(p_priority_queue, (void *) A_key);
+    priority_queue_enqueue(p_priority_queue, (void *) B_key);
+    priority_queue_enqueue(p_priority_queue, (void *) C_key);
+    print_test(name, "priority_queue_get_fd_enqueue", fd_readable(fd));
+
+    // The same eventfd is returned again
+    print_test(name, "priority_queue_get_fd_again", priority_queue_get_fd(p_priority_queue) == fd);
+
+    // It stays readable until the last key is removed
+    priority_queue_dequeue(p_priority_queue, &p_value);
+    priority_queue_dequeue(p_priority_queue, &p_value);
+    print_test(name, "priority_queue_get_fd_dequeue", fd_readable(fd));
+    priority_queue_dequeue(p_priority_queue, &p_value);
+    print_test(name, "priority_queue_get_fd_drained", fd_readable(fd) == false);
+
+    // The unchecked path keeps it up to date
+    priority_queue_enqueue_unchecked(p_priority_queue, (void *) D_key);
+    print_test(name, "priority_queue_get_fd_unchecked", fd_readable(fd));
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+#else
+int test_notify_priority_queue ( char *name )
+{
+
+    // Not supported
+    (void) name;
+
+    // Success
+    return 1;
+}
+#endif
+
+bool test_aging_rejected ( void )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    bool            result           = false;
+
+    // A priority queue ordered by a compare function can not age
+    priority_queue_construct(&p_priority_queue, 8, 0);
+    result = ( priority_queue_aging_set(p_priority_queue, 1) == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_aging_starvation ( uint64_t rate, size_t expected_position )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_priority  priority         = { 0 };
+    void                    *p_value          = 0;
+    size_t                   position         = 0;
+    bool                     result           = true;
+
+    // Construct a priority queue of 64 bit priorities, which ages keys by rate
+    priority_queue_construct_typed(&p_priority_queue, 256, PRIORITY_QUEUE_PRIORITY_U64, 2, 0);
+    priority_queue_aging_set(p_priority_queue, rate);
+
+    // One low priority key, then a flood of higher priority keys
+    priority_queue_enqueue_priority(p_priority_queue, (void *) 1, (priority_queue_priority) { .u64 = 101 });
+    for (size_t i = 0; i < 200; i++)
+        priority_queue_enqueue_priority(p_priority_queue, (void *) 2, (priority_queue_priority) { .u64 = 50 });
+
+    // Find when the low priority key is dequeued
+    for (size_t i = 1; result && i <= 201; i++)
+    {
+        result = priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority);
+        if ( p_value == (void *) 1 ) position = i;
+    }
+
+    // Check the position
+    result = result && ( position == expected_position ) && priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_aging_fifo ( uint64_t rate, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Construct a priority queue of 64 bit priorities, which ages keys by rate
+    priority_queue_construct_typed(&p_priority_queue, 8, PRIORITY_QUEUE_PRIORITY_U64, 4, 0);
+    priority_queue_aging_set(p_priority_queue, rate);
+
+    // Keep three keys of equal priority in the queue
+    for (size_t i = 1; i <= 3; i++)
+        priority_queue_enqueue_priority(p_priority_queue, (void *) i, (priority_queue_priority) { .u64 = 5 });
+
+    // Equal priorities come out first in, first out, across rebases of the bias
+    for (size_t i = 1; result && i <= how_many; i++)
+    {
+        priority_queue_enqueue_priority(p_priority_queue, (void *) ( i + 3 ), (priority_queue_priority) { .u64 = 5 });
+        result = priority_queue_dequeue_priority(p_priority_queue, &p_value, 0) && ( p_value == (void *) i );
+    }
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_aging_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // without aging, the low priority key starves until the end
+    print_test(name, "priority_queue_aging_set_0", test_aging_starvation(0, 201));
+
+    // with aging, it overtakes every key enqueued more than 25 enqueues after it
+    print_test(name, "priority_queue_aging_set_2", test_aging_starvation(2, 26));
+
+    // the bias overflows every eight enqueues, and is rebased
+    print_test(name, "priority_queue_aging_set_rebase", test_aging_fifo(UINT64_C(1) << 61, 100));
+
+    // only 64 bit priorities can age
+    print_test(name, "priority_queue_aging_set_comparator", test_aging_rejected());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_bucket_dequeue ( size_t levels, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_priority  priority         = { 0 },
+                             last             = { 0 };
+    void                    *p_value          = 0,
+                            *p_last           = 0;
+    bool                     result           = true;
+
+    // Construct a bucket queue
+    result = priority_queue_construct_bucket(&p_priority_queue, how_many, levels, 0);
+
+    // Enqueue 1 ... how_many, scattered across the levels
+    for (size_t i = 1; result && i <= how_many; i++)
+        result = priority_queue_enqueue_priority(p_priority_queue, (void *) i, (priority_queue_priority) { .u32 = (uint32_t) ( ( i * 7919 ) % levels ) });
+
+    // The queue is full
+    if ( result ) result = ( priority_queue_enqueue_priority(p_priority_queue, (void *) 1, (priority_queue_priority) { .u32 = 0 }) == 0 );
+
+    // Check the front
+    if ( result ) result = priority_queue_peek(p_priority_queue, &p_value) && ( p_value == (void *) levels );
+
+    // Levels come out in order, and keys of a level in the order they were enqueued
+    for (size_t i = 0; result && i < how_many; i++)
+    {
+        result = priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority) 
+              && ( ( (size_t) p_value * 7919 ) % levels == priority.u32 )
+              && ( i == 0 || priority.u32 > last.u32 || ( priority.u32 == last.u32 && p_value > p_last ) );
+        last   = priority;
+        p_last = p_value;
+    }
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int bucket_ABCDEFG ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a bucket queue of 8 levels, where each key is its own level
+    priority_queue_construct_bucket(pp_priority_queue, 8, 8, 0);
+
+    // insert(D, F, A, C, E, B, G)
+    priority_queue_enqueue(*pp_priority_queue, (void *) D_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) F_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) A_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) C_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) E_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) B_key);
+    priority_queue_enqueue(*pp_priority_queue, (void *) G_key);
+
+    // priority queue = [A, B, C, D, E, F, G]
+    return 1;
+}
+
+int test_bucket_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // seven keys, each its own level
+    print_test(name, "priority_queue_dequeue_ABCDEFG", test_dequeue(bucket_ABCDEFG, D_key, 4, match));
+
+    // seven keys, drained in order
+    print_test(name, "priority_queue_drain_sorted_ABCDEFG", test_drain_sorted(bucket_ABCDEFG, ABCDEFG_keys));
+
+    // ten thousand keys, across 256 levels
+    print_test(name, "priority_queue_dequeue_priority_256", test_bucket_dequeue(256, 10000));
+
+    // ten thousand keys, across every level
+    print_test(name, "priority_queue_dequeue_priority_4096", test_bucket_dequeue(PRIORITY_QUEUE_BUCKET_LEVELS_MAX, 10000));
+
+    // one level is first in, first out
+    print_test(name, "priority_queue_dequeue_priority_1", test_bucket_dequeue(1, 1000));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_invalidate ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many, size_t stride, double threshold )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+    priority_queue_compact_threshold_set(p_priority_queue, threshold);
+
+    // Invalidate every key that is not a multiple of the stride, which includes the front
+    for (size_t i = 1; result && i <= how_many; i++)
+        if ( i % stride ) result = priority_queue_invalidate(p_priority_queue, (void *) i);
+
+    // The front is the first live key
+    if ( result ) result = priority_queue_peek(p_priority_queue, &p_value) && ( p_value == (void *) stride );
+
+    // Only the multiples of the stride come out
+    for (size_t i = stride; result && i <= how_many; i += stride)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_invalidate_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // dead keys are skipped at the front, and never compacted
+    print_test(name, "priority_queue_invalidate_skip", test_invalidate(blocked_insertdecending_2000, 2000, 3, 1));
+
+    // the heap is compacted when half of the keys are dead
+    print_test(name, "priority_queue_invalidate_compact", test_invalidate(blocked_insertdecending_2000, 2000, 3, 0));
+
+    // the heap is compacted often
+    print_test(name, "priority_queue_invalidate_compact_often", test_invalidate(from_keys_parallel_200000, 200000, 7, 0.01));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+void *test_reprioritize_reverse ( void *p_key, priority_queue_priority *p_priority, void *p_context )
+{
+
+    // Initialized data
+    size_t how_many = *(size_t *) p_context;
+
+    // Reverse the priority of typed keys ...
+    if ( p_priority ) return p_priority->u64 = how_many + 1 - p_priority->u64, p_key;
+
+    // ... and replace other keys
+    return (void *) ( 2 * ( how_many + 1 - (size_t) p_key ) );
+}
+
+bool test_reprioritize ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many, size_t threads )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Reverse the order of the keys
+    result = priority_queue_reprioritize_parallel(p_priority_queue, test_reprioritize_reverse, &how_many, threads);
+
+    // The replaced keys come out in order
+    for (size_t i = 1; result && i <= how_many; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) ( 2 * i ) );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_reprioritize_typed ( size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_priority  priority         = { 0 };
+    void                    *p_value          = 0;
+    bool                     result           = true;
+
+    // Construct a priority queue of 64 bit priorities, where each key is its priority
+    priority_queue_construct_typed(&p_priority_queue, how_many, PRIORITY_QUEUE_PRIORITY_U64, 4, 0);
+    for (size_t i = 1; i <= how_many; i++)
+        priority_queue_enqueue_priority(p_priority_queue, (void *) i, (priority_queue_priority) { .u64 = i });
+
+    // Reverse the priorities
+    result = priority_queue_reprioritize(p_priority_queue, test_reprioritize_reverse, &how_many);
+
+    // The keys come out from last to first, with their new priorities
+    for (size_t i = how_many; result && i >= 1; i--)
+        result = priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority)
+              && ( p_value == (void *) i ) && ( priority.u64 == how_many + 1 - i );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_reprioritize_rejected ( void )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    size_t          how_many         = 7;
+    bool            result           = true;
+
+    // Bucket priority queues can not be reprioritized
+    bucket_ABCDEFG(&p_priority_queue);
+    result = ( priority_queue_reprioritize(p_priority_queue, test_reprioritize_reverse, &how_many) == 0 );
+
+    // Null callbacks are rejected
+    result = result && ( priority_queue_reprioritize(p_priority_queue, 0, &how_many) == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_reprioritize_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // a blocked heap is rebuilt in its physical slots
+    print_test(name, "priority_queue_reprioritize_blocked", test_reprioritize(blocked_insertdecending_2000, 2000, 1));
+
+    // a large heap is swept and rebuilt by four threads
+    print_test(name, "priority_queue_reprioritize_parallel", test_reprioritize(from_keys_parallel_200000, 200000, 4));
+
+    // typed keys are given new priorities
+    print_test(name, "priority_queue_reprioritize_typed", test_reprioritize_typed(1001));
+
+    // bucket priority queues are rejected
+    print_test(name, "priority_queue_reprioritize_rejected", test_reprioritize_rejected());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+struct test_sum_s
+{
+    size_t count,
+           sum,
+           stop; // Stop after this many keys, or 0
+};
+
+int test_sum ( void *p_key, void *p_context )
+{
+
+    // Initialized data
+    struct test_sum_s *p_sum = p_context;
+
+    // Count the key
+    p_sum->count++;
+    p_sum->sum += (size_t) p_key;
+
+    // Continue until the stop
+    return p_sum->count != p_sum->stop;
+}
+
+bool test_for_each ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many, size_t stop )
+{
+
+    // Initialized data
+    priority_queue    *p_priority_queue = 0;
+    struct test_sum_s  _sum             = { .stop = stop };
+    bool               result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Visit the keys
+    result = priority_queue_for_each(p_priority_queue, test_sum, &_sum);
+
+    // Every key is visited once, unless the callback stops
+    if ( stop ) result = result && ( _sum.count == stop );
+    else        result = result && ( _sum.count == how_many ) && ( _sum.sum == how_many * ( how_many + 1 ) / 2 );
+
+    // The keys are not removed
+    result = result && priority_queue_empty(p_priority_queue) == false;
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_snapshot_sum ( const priority_queue_snapshot *p_snapshot, size_t how_many )
+{
+
+    // Initialized data
+    struct test_sum_s _sum = { 0 };
+
+    // Visit the keys
+    priority_queue_snapshot_for_each(p_snapshot, test_sum, &_sum);
+
+    // Check for 1 ... how_many
+    return ( priority_queue_snapshot_count(p_snapshot) == how_many ) && ( _sum.count == how_many ) && ( _sum.sum == how_many * ( how_many + 1 ) / 2 );
+}
+
+bool test_snapshot ( int (*priority_queue_constructor)(priority_queue **pp_priority_queue), size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_snapshot *p_a              = 0,
+                            *p_b              = 0,
+                            *p_c              = 0;
+    void                    *p_value          = 0;
+    bool                     result           = true;
+
+    // Build the priority queue
+    priority_queue_constructor(&p_priority_queue);
+
+    // Snapshots taken before a modification share the entries
+    result = priority_queue_snapshot_acquire(p_priority_queue, &p_a)
+          && priority_queue_snapshot_acquire(p_priority_queue, &p_b)
+          && ( p_a == p_b );
+
+    // Modify the priority queue, through the checked and the unchecked paths
+    for (size_t i = 1; result && i <= how_many / 2; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+    if ( result ) result = priority_queue_enqueue_unchecked(p_priority_queue, (void *) ( how_many + 1 ));
+    if ( result ) result = priority_queue_dequeue_unchecked(p_priority_queue, &p_value) && ( p_value == (void *) ( how_many / 2 + 1 ) );
+
+    // The snapshots still hold every key
+    result = result && test_snapshot_sum(p_a, how_many) && test_snapshot_sum(p_b, how_many);
+    priority_queue_snapshot_release(&p_a);
+
+    // A new snapshot sees the modifications, and outlives the priority queue
+    if ( result ) result = priority_queue_snapshot_acquire(p_priority_queue, &p_c) && ( p_c != p_b );
+    if ( result ) result = ( priority_queue_snapshot_count(p_c) == how_many - how_many / 2 );
+    priority_queue_destroy(&p_priority_queue);
+    result = result && ( priority_queue_snapshot_count(p_c) == how_many - how_many / 2 );
+
+    // Release the snapshots
+    result = result && priority_queue_snapshot_release(&p_b) && priority_queue_snapshot_release(&p_c) && ( p_b == 0 ) && ( p_c == 0 );
+
+    // Return result
+    return result;
+}
+
+bool test_snapshot_invalidate ( void )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_snapshot *p_snapshot       = 0;
+    void                    *p_front          = 0,
+                            *p_value          = 0;
+    bool                     result           = true;
+
+    // Construct a priority queue of 1 ... 10
+    result = priority_queue_construct(&p_priority_queue, 10, 0);
+    for (size_t i = 1; result && i <= 10; i++)
+        result = priority_queue_enqueue(p_priority_queue, (void *) i);
+
+    // Invalidate the front key, then take a snapshot
+    result = result && priority_queue_peek(p_priority_queue, &p_front) && priority_queue_invalidate(p_priority_queue, p_front);
+    result = result && priority_queue_snapshot_acquire(p_priority_queue, &p_snapshot);
+
+    // A peek removes the dead front key ...
+    result = result && priority_queue_peek(p_priority_queue, &p_value) && ( p_value != p_front );
+
+    // ... but the snapshot still holds every key
+    result = result && test_snapshot_sum(p_snapshot, 10);
+
+    // Release the snapshot, and free the priority queue
+    if ( p_snapshot ) priority_queue_snapshot_release(&p_snapshot);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_snapshot_rejected ( void )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_snapshot *p_snapshot       = 0;
+    bool                     result           = true;
+
+    // Bucket priority queues can not be snapshot
+    bucket_ABCDEFG(&p_priority_queue);
+    result = ( priority_queue_snapshot_acquire(p_priority_queue, &p_snapshot) == 0 ) && ( p_snapshot == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+#ifndef _WIN64
+void *test_snapshot_producer ( void *p_parameter )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = p_parameter;
+    void           *p_value          = 0;
+
+    // Take the front key, and put it back
+    for (size_t i = 0; i < 20000; i++)
+        if ( priority_queue_dequeue(p_priority_queue, &p_value) ) priority_queue_enqueue(p_priority_queue, p_value);
+
+    // Done
+    return 0;
+}
+
+bool test_snapshot_concurrent ( size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_snapshot *p_snapshot       = 0;
+    pthread_t                producer;
+    bool                     result           = true;
+
+    // Construct a priority queue of 1 ... how_many
+    priority_queue_construct(&p_priority_queue, how_many, 0);
+    for (size_t i = 1; i <= how_many; i++)
+        priority_queue_enqueue(p_priority_queue, (void *) i);
+
+    // Start the producer
+    pthread_create(&producer, 0, test_snapshot_producer, p_priority_queue);
+
+    // Every snapshot is taken between operations, so it holds every key, or every key 
+    // but the one the producer is putting back
+    for (size_t i = 0; result && i < 200; i++)
+    {
+
+        // Initialized data
+        struct test_sum_s _sum = { 0 };
+
+        // Visit the keys of a snapshot
+        result = priority_queue_snapshot_acquire(p_priority_queue, &p_snapshot) && priority_queue_snapshot_for_each(p_snapshot, test_sum, &_sum);
+        priority_queue_snapshot_release(&p_snapshot);
+
+        // Check the keys
+        if      ( _sum.count == how_many     ) result = result && ( _sum.sum == how_many * ( how_many + 1 ) / 2 );
+        else if ( _sum.count == how_many - 1 ) result = result && ( how_many * ( how_many + 1 ) / 2 - _sum.sum <= how_many );
+        else                                   result = false;
+    }
+
+    // Wait for the producer
+    pthread_join(producer, 0);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+void *test_snapshot_releaser ( void *p_parameter )
+{
+
+    // Release the snapshot
+    return (void *) (size_t) priority_queue_snapshot_release((priority_queue_snapshot **) p_parameter);
+}
+
+bool test_snapshot_release_destroy ( size_t how_many )
+{
+
+    // Initialized data
+    bool result = true;
+
+    // Release a snapshot on one thread, while the priority queue is destroyed on another
+    for (size_t i = 0; result && i < how_many; i++)
+    {
+
+        // Initialized data
+        priority_queue          *p_priority_queue = 0;
+        priority_queue_snapshot *p_snapshot       = 0;
+        pthread_t                releaser;
+        void                    *p_released       = 0;
+
+        // Construct a priority queue, and take a snapshot
+        result = priority_queue_construct(&p_priority_queue, 16, 0) &&
+                 priority_queue_enqueue(p_priority_queue, (void *) 1) &&
+                 priority_queue_enqueue(p_priority_queue, (void *) 2) &&
+                 priority_queue_snapshot_acquire(p_priority_queue, &p_snapshot);
+
+        // Race the release against the destruction
+        if ( result ) pthread_create(&releaser, 0, test_snapshot_releaser, &p_snapshot);
+        priority_queue_destroy(&p_priority_queue);
+        if ( result ) pthread_join(releaser, &p_released);
+
+        // Check the release
+        result = result && ( p_released == (void *) 1 ) && ( p_snapshot == 0 );
+    }
+
+    // Return result
+    return result;
+}
+#endif
+
+int test_snapshot_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // every key of a blocked heap is visited once
+    print_test(name, "priority_queue_for_each", test_for_each(blocked_insertdecending_2000, 2000, 0));
+
+    // the callback stops the visit
+    print_test(name, "priority_queue_for_each_stop", test_for_each(blocked_insertdecending_2000, 2000, 10));
+
+    // every level of a bucket queue is visited
+    print_test(name, "priority_queue_for_each_bucket", test_for_each(bucket_ABCDEFG, 7, 0));
+
+    // snapshots keep their keys across modifications, and after destruction
+    print_test(name, "priority_queue_snapshot_blocked", test_snapshot(blocked_insertdecending_2000, 2000));
+    print_test(name, "priority_queue_snapshot_binary", test_snapshot(from_keys_parallel_200000, 200000));
+
+    // a peek that removes dead keys does not change a snapshot
+    print_test(name, "priority_queue_snapshot_invalidate", test_snapshot_invalidate());
+
+    // bucket priority queues are rejected
+    print_test(name, "priority_queue_snapshot_rejected", test_snapshot_rejected());
+
+    #ifndef _WIN64
+
+        // snapshots are taken while another thread modifies the priority queue
+        print_test(name, "priority_queue_snapshot_concurrent", test_snapshot_concurrent(1000));
+
+        // a snapshot is released while its priority queue is destroyed
+        print_test(name, "priority_queue_snapshot_release_destroy", test_snapshot_release_destroy(2000));
+    #endif
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int compact_1009 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a compact priority queue, with the children of each entry in one cache line
+    priority_queue_construct_typed(pp_priority_queue, 1009, PRIORITY_QUEUE_PRIORITY_INDEX, 8, 0);
+
+    // Index i has priority 7919i mod 1009, so the priorities are a permutation
+    for (uint32_t i = 0; i < 1009; i++)
+        priority_queue_enqueue_index(*pp_priority_queue, i, i * 7919 % 1009);
+
+    // priority queue = [0 ... 1008], by priority
+    return 1;
+}
+
+bool test_compact_dequeue ( size_t arity, uint32_t how_many )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    uint32_t        index            = 0,
+                    priority         = 0;
+    bool            result           = true;
+
+    // Construct a compact priority queue
+    if ( priority_queue_construct_typed(&p_priority_queue, how_many, PRIORITY_QUEUE_PRIORITY_INDEX, arity, 0) == 0 ) return false;
+
+    // Enqueue every index, with a permutation of the priorities
+    for (uint32_t i = 0; result && i < how_many; i++)
+        result = priority_queue_enqueue_index(p_priority_queue, i, (uint32_t) ( (uint64_t) i * 7919 % how_many ));
+
+    // The priorities come out in order, each with its index
+    for (uint32_t p = 0; result && p < how_many; p++)
+        result = priority_queue_dequeue_index(p_priority_queue, &index, &priority)
+              && ( priority == p ) && ( (uint64_t) index * 7919 % how_many == p );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_compact_ties ( void )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    uint32_t        index            = 0;
+    bool            result           = true;
+
+    // Construct a compact priority queue
+    priority_queue_construct_typed(&p_priority_queue, 16, PRIORITY_QUEUE_PRIORITY_INDEX, 4, 0);
+
+    // Equal priorities, enqueued out of order
+    for (uint32_t i = 10; i > 0; i--)
+        priority_queue_enqueue_index(p_priority_queue, i, 5);
+
+    // The front is the lowest index
+    result = priority_queue_peek(p_priority_queue, &p_value) && ( p_value == (void *) 1 );
+
+    // Equal priorities come out in order of index
+    for (uint32_t i = 1; result && i <= 10; i++)
+        result = priority_queue_dequeue_index(p_priority_queue, &index, 0) && ( index == i );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_compact_drain ( void )
+{
+
+    // Initialized data
+    priority_queue  *p_priority_queue = 0;
+    void           **p_keys           = 0;
+    size_t           count            = 0;
+    bool             result           = true;
+
+    // Build the priority queue
+    compact_1009(&p_priority_queue);
+
+    // Drain the indices
+    result = priority_queue_drain_sorted(p_priority_queue, &p_keys, &count) && ( count == 1009 );
+
+    // The indices come out in order of priority
+    for (size_t p = 0; result && p < count; p++)
+        result = ( (uintptr_t) p_keys[p] * 7919 % 1009 == p );
+
+    // The priority queue is empty, and reusable
+    result = result && priority_queue_empty(p_priority_queue) && priority_queue_enqueue_index(p_priority_queue, 3, 3);
+
+    // Free the keys and the priority queue
+    if ( p_keys ) PRIORITY_QUEUE_REALLOC(p_keys, 0);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+void *test_compact_reverse ( void *p_key, priority_queue_priority *p_priority, void *p_context )
+{
+
+    // Unused
+    (void) p_context;
+
+    // Reverse the priority
+    p_priority->u32 = 1008 - p_priority->u32;
+
+    // Keep the index
+    return p_key;
+}
+
+bool test_compact_bulk ( void )
+{
+
+    // Initialized data
+    priority_queue           *p_priority_queue = 0;
+    priority_queue_snapshot  *p_snapshot       = 0;
+    struct test_sum_s         _sum             = { 0 };
+    uint32_t                  index            = 0,
+                              priority         = 0;
+    bool                      result           = true;
+
+    // Build the priority queue
+    compact_1009(&p_priority_queue);
+
+    // Visit every index
+    result = priority_queue_for_each(p_priority_queue, test_sum, &_sum) && ( _sum.count == 1009 ) && ( _sum.sum == 1008 * 1009 / 2 );
+
+    // Reverse the priorities
+    result = result && priority_queue_reprioritize(p_priority_queue, test_compact_reverse, 0);
+
+    // The highest priority comes out first
+    result = result && priority_queue_dequeue_index(p_priority_queue, &index, &priority) && ( priority == 0 ) && ( (uint64_t) index * 7919 % 1009 == 1008 );
+
+    // Compact priority queues can not be snapshot, and other priority queues do not store indices
+    result = result && ( priority_queue_snapshot_acquire(p_priority_queue, &p_snapshot) == 0 );
+    priority_queue_destroy(&p_priority_queue);
+    priority_queue_construct_typed(&p_priority_queue, 4, PRIORITY_QUEUE_PRIORITY_U32, 2, 0);
+    result = result && ( priority_queue_enqueue_index(p_priority_queue, 1, 1) == 0 );
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_compact_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // every arity orders the packed entries
+    print_test(name, "priority_queue_dequeue_index_2", test_compact_dequeue(2, 1009));
+    print_test(name, "priority_queue_dequeue_index_4", test_compact_dequeue(4, 1009));
+    print_test(name, "priority_queue_dequeue_index_8", test_compact_dequeue(8, 100003));
+
+    // equal priorities come out in order of index
+    print_test(name, "priority_queue_dequeue_index_ties", test_compact_ties());
+
+    // the indices are drained in order of priority
+    print_test(name, "priority_queue_drain_sorted_compact", test_compact_drain());
+
+    // the indices are visited and reprioritized
+    print_test(name, "priority_queue_compact_bulk", test_compact_bulk());
+
+    // dead indices are skipped at the front, and compacted
+    print_test(name, "priority_queue_invalidate_index_skip", test_compact_invalidate(1));
+    print_test(name, "priority_queue_invalidate_index_compact", test_compact_invalidate(0));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+uint64_t test_branchless_priority ( priority_queue_priority_type type, uint64_t *p_state )
+{
+
+    // Step the generator
+    *p_state ^= *p_state << 13, *p_state ^= *p_state >> 7, *p_state ^= *p_state << 17;
+
+    // One in four priorities is one of the 4 largest, so some equal the padding
+    if ( ( *p_state & 3 ) == 0 ) return ( ( type == PRIORITY_QUEUE_PRIORITY_U32 ) ? UINT32_MAX : UINT64_MAX ) - ( *p_state >> 2 & 3 );
+
+    // The rest fall in a small range, with many ties
+    return *p_state >> 8 & 255;
+}
+
+bool test_branchless_dequeue ( priority_queue_priority_type type, size_t arity, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    uint64_t                *p_priorities     = PRIORITY_QUEUE_REALLOC(0, how_many * sizeof(uint64_t)),
+                             state            = 0x2545f4914f6cdd1dULL,
+                             last             = 0;
+    priority_queue_priority  priority         = { 0 };
+    void                    *p_value          = 0;
+    size_t                   count            = 0,
+                             left             = 0;
+    bool                     result           = ( p_priorities != 0 );
+
+    // Construct a typed priority queue
+    if ( result ) result = priority_queue_construct_typed(&p_priority_queue, how_many, type, arity, 0);
+
+    // Enqueue half of the keys and dequeue half of those, then enqueue the rest and dequeue every key
+    for (size_t round = 0; result && round < 2; round++)
+    {
+
+        // Enqueue keys, none with a higher priority than the last key dequeued
+        for (size_t i = 0; result && i < how_many / 2; i++, count++, left++)
+        {
+
+            // Make a priority
+            p_priorities[count] = test_branchless_priority(type, &state);
+            if ( p_priorities[count] < last ) p_priorities[count] = last;
+            if ( type == PRIORITY_QUEUE_PRIORITY_U32 ) priority.u32 = (uint32_t) p_priorities[count];
+            else                                       priority.u64 = p_priorities[count];
+
+            // Enqueue the key
+            result = priority_queue_enqueue_priority(p_priority_queue, (void *) ( count + 1 ), priority);
+        }
+
+        // Dequeue keys, checking the priorities never decrease, and each key kept its priority
+        for (size_t i = ( round ? 0 : left / 2 ); result && i < left; left--)
+        {
+
+            // Initialized data
+            uint64_t value = 0;
+
+            // Dequeue a key
+            result = priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority) && p_value;
+
+            // Check the priority
+            value  = ( type == PRIORITY_QUEUE_PRIORITY_U32 ) ? priority.u32 : priority.u64;
+            result = result && ( value >= last ) && ( value == p_priorities[(size_t) p_value - 1] );
+            last   = value;
+        }
+    }
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priorities and the priority queue
+    if ( p_priorities ) PRIORITY_QUEUE_REALLOC(p_priorities, 0);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+bool test_branchless_drain ( void )
+{
+
+    // Initialized data
+    priority_queue           *p_priority_queue = 0;
+    priority_queue_priority   priority         = { 0 };
+    void                    **p_keys           = 0,
+                             *p_value          = 0;
+    size_t                    count            = 0;
+    bool                      result           = true;
+
+    // Construct a typed priority queue, and enqueue keys with priorities 999 ... 0
+    priority_queue_construct_typed(&p_priority_queue, 1000, PRIORITY_QUEUE_PRIORITY_U32, 4, 0);
+    for (size_t i = 0; result && i < 1000; i++)
+        priority.u32 = (uint32_t) ( 999 - i ), result = priority_queue_enqueue_priority(p_priority_queue, (void *) ( 1000 - i ), priority);
+
+    // Drain the keys, in order of priority
+    result = result && priority_queue_drain_sorted(p_priority_queue, &p_keys, &count) && ( count == 1000 );
+    for (size_t i = 0; result && i < count; i++)
+        result = ( p_keys[i] == (void *) ( i + 1 ) );
+
+    // The emptied priority queue orders a single key, then a larger priority after a smaller one
+    priority.u32 = UINT32_MAX;
+    result       = result && priority_queue_enqueue_priority(p_priority_queue, (void *) 1, priority);
+    result       = result && priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority) && ( p_value == (void *) 1 ) && ( priority.u32 == UINT32_MAX );
+    result       = result && priority_queue_empty(p_priority_queue);
+    priority.u32 = 7, result = result && priority_queue_enqueue_priority(p_priority_queue, (void *) 7, priority);
+    priority.u32 = 3, result = result && priority_queue_enqueue_priority(p_priority_queue, (void *) 3, priority);
+    result       = result && priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) 3 );
+    result       = result && priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) 7 );
+
+    // Free the keys and the priority queue
+    if ( p_keys ) PRIORITY_QUEUE_REALLOC(p_keys, 0);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_branchless_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // every arity orders ties, and priorities equal to the padding
+    print_test(name, "priority_queue_branchless_u32_2", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U32, 2, 4001));
+    print_test(name, "priority_queue_branchless_u32_4", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U32, 4, 4001));
+    print_test(name, "priority_queue_branchless_u32_8", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U32, 8, 4001));
+    print_test(name, "priority_queue_branchless_u64_2", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U64, 2, 4001));
+    print_test(name, "priority_queue_branchless_u64_4", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U64, 4, 4001));
+    print_test(name, "priority_queue_branchless_u64_8", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U64, 8, 4001));
+    print_test(name, "priority_queue_branchless_small", test_branchless_dequeue(PRIORITY_QUEUE_PRIORITY_U64, 8, 9));
+
+    // a drained priority queue is padded again, and reusable
+    print_test(name, "priority_queue_branchless_drain", test_branchless_drain());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_fair_weights ( void )
+{
+
+    // Initialized data
+    priority_queue_fair *p_fair     = 0;
+    void                *p_key      = 0,
+                        *p_last[3]  = { 0 };
+    size_t               tenant     = 0,
+                         counts[3]  = { 0 };
+    bool                 result     = true;
+
+    // Construct a fair queue of 3 tenants, with weights 1, 2, and 4
+    result = priority_queue_fair_construct(&p_fair, 3, 1000, 0)
+          && priority_queue_fair_weight_set(p_fair, 1, 2)
+          && priority_queue_fair_weight_set(p_fair, 2, 4);
+
+    // Each tenant enqueues 1000 keys of equal cost, in descending order
+    for (size_t i = 1000; result && i > 0; i--)
+        for (size_t t = 0; result && t < 3; t++)
+            result = priority_queue_fair_enqueue(p_fair, t, (void *) i, 1);
+
+    // Dequeue 700 keys, each tenant in order of priority
+    for (size_t i = 0; result && i < 700; i++)
+    {
+        result = priority_queue_fair_dequeue(p_fair, &p_key, &tenant) && ( tenant < 3 ) && ( p_key > p_last[tenant] );
+        if ( result ) counts[tenant]++, p_last[tenant] = p_key;
+    }
+
+    // The dequeues are shared 1 : 2 : 4
+    result = result && ( counts[0] >= 99 && counts[0] <= 101 ) && ( counts[1] >= 199 && counts[1] <= 201 ) && ( counts[2] >= 399 && counts[2] <= 401 );
+
+    // Free the fair queue
+    if ( p_fair ) priority_queue_fair_destroy(&p_fair);
+
+    // Return result
+    return result;
+}
+
+bool test_fair_isolation ( void )
+{
+
+    // Initialized data
+    priority_queue_fair *p_fair    = 0;
+    void                *p_key     = 0;
+    size_t               tenant    = 0,
+                         quiet     = 0,
+                         costly    = 0;
+    bool                 result    = true;
+
+    // Construct a fair queue of 2 tenants, with equal weights
+    result = priority_queue_fair_construct(&p_fair, 2, 1000, 0);
+
+    // A noisy tenant enqueues 1000 keys before a quiet tenant enqueues 10
+    for (size_t i = 1; result && i <= 1000; i++) result = priority_queue_fair_enqueue(p_fair, 0, (void *) i, 1);
+    for (size_t i = 1; result && i <= 10;   i++) result = priority_queue_fair_enqueue(p_fair, 1, (void *) i, 1);
+
+    // The quiet tenant is done within the first 21 dequeues
+    for (size_t i = 0; result && i < 21; i++)
+        if ( ( result = priority_queue_fair_dequeue(p_fair, &p_key, &tenant) ) && tenant == 1 ) quiet++;
+    result = result && ( quiet == 10 );
+
+    // Drain the noisy tenant
+    while ( result && priority_queue_fair_empty(p_fair) == false ) result = priority_queue_fair_dequeue(p_fair, &p_key, 0);
+
+    // A tenant whose keys cost 3 times as much gets a third of the keys, and an idle
+    // tenant does not save up a share while it is idle
+    for (size_t i = 1; result && i <= 300; i++)
+        result = priority_queue_fair_enqueue(p_fair, 0, (void *) i, 3) && priority_queue_fair_enqueue(p_fair, 1, (void *) i, 1);
+    for (size_t i = 0; result && i < 200; i++)
+        if ( ( result = priority_queue_fair_dequeue(p_fair, &p_key, &tenant) ) && tenant == 0 ) costly++;
+    result = result && ( costly >= 49 && costly <= 51 );
+
+    // Free the fair queue
+    if ( p_fair ) priority_queue_fair_destroy(&p_fair);
+
+    // Return result
+    return result;
+}
+
+bool test_fair_mixed_costs ( void )
+{
+
+    // Initialized data
+    priority_queue_fair *p_fair     = 0;
+    void                *p_key      = 0,
+                        *p_last[2]  = { 0 };
+    size_t               tenant     = 0,
+                         left[2]    = { 200, 200 };
+    uint64_t             served[2]  = { 0 };
+    bool                 result     = true;
+
+    // Construct a fair queue of 2 tenants, with equal weights
+    result = priority_queue_fair_construct(&p_fair, 2, 200, 0);
+
+    // Tenant 0 enqueues 100 low priority keys of cost 1, then 100 high priority keys 
+    // of cost 1000, so its keys leave in a different order than they arrived ...
+    for (size_t i = 1001; result && i <= 1100; i++) result = priority_queue_fair_enqueue(p_fair, 0, (void *) i, 1);
+    for (size_t i = 1;    result && i <= 100;  i++) result = priority_queue_fair_enqueue(p_fair, 0, (void *) i, 1000);
+
+    // ... and tenant 1 enqueues 200 keys of cost 1000
+    for (size_t i = 1; result && i <= 200; i++) result = priority_queue_fair_enqueue(p_fair, 1, (void *) i, 1000);
+
+    // While both tenants have keys, each is charged the cost of the keys it takes, so
+    // their shares never differ by more than one key
+    while ( result && left[0] && left[1] )
+    {
+
+        // Take a key, in order of priority for its tenant
+        result = priority_queue_fair_dequeue(p_fair, &p_key, &tenant) && ( tenant < 2 ) && ( p_key > p_last[tenant] );
+        if ( result == false ) break;
+
+        // Charge the tenant
+        served[tenant] += ( tenant == 0 && (size_t) p_key > 1000 ) ? 1 : 1000;
+        p_last[tenant]  = p_key;
+        left[tenant]--;
+
+        // Check the shares
+        result = ( ( served[0] > served[1] ) ? served[0] - served[1] : served[1] - served[0] ) <= 1000;
+    }
+
+    // Tenant 0 finishes first, when tenant 1 took about as many costly keys
+    result = result && ( left[0] == 0 ) && ( left[1] == 100 );
+
+    // Free the fair queue
+    if ( p_fair ) priority_queue_fair_destroy(&p_fair);
+
+    // Return result
+    return result;
+}
+
+bool test_fair_errors ( void )
+{
+
+    // Initialized data
+    priority_queue_fair *p_fair = 0;
+    void                *p_key  = 0;
+    bool                 result = true;
+
+    // Construct a fair queue of 2 tenants, each holding 2 keys
+    result = priority_queue_fair_construct(&p_fair, 2, 2, 0);
+
+    // An empty fair queue has no keys
+    result = result && priority_queue_fair_empty(p_fair) && ( priority_queue_fair_dequeue(p_fair, &p_key, 0) == 0 );
+
+    // Tenants and weights are checked, and a full tenant does not fill the others
+    result = result && ( priority_queue_fair_enqueue(p_fair, 2, (void *) 1, 1) == 0 ) && ( priority_queue_fair_weight_set(p_fair, 0, 0) == 0 );
+    result = result && priority_queue_fair_enqueue(p_fair, 0, (void *) 1, 1) && priority_queue_fair_enqueue(p_fair, 0, (void *) 2, 1);
+    result = result && ( priority_queue_fair_enqueue(p_fair, 0, (void *) 3, 1) == 0 ) && priority_queue_fair_enqueue(p_fair, 1, (void *) 3, 1);
+
+    // Zero tenants, or zero keys, is an error
+    result = result && ( priority_queue_fair_construct(&p_fair, 0, 2, 0) == 0 ) && ( priority_queue_fair_construct(&p_fair, 2, 0, 0) == 0 );
+
+    // Free the fair queue
+    if ( p_fair ) priority_queue_fair_destroy(&p_fair);
+
+    // Return result
+    return result;
+}
+
+int test_fair_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // tenants share dequeues by weight, each in order of priority
+    print_test(name, "priority_queue_fair_weights", test_fair_weights());
+
+    // a noisy tenant does not delay a quiet one, and costly keys use more of the share
+    print_test(name, "priority_queue_fair_isolation", test_fair_isolation());
+
+    // each key is charged its own cost, when keys leave in a different order than they arrive
+    print_test(name, "priority_queue_fair_mixed_costs", test_fair_mixed_costs());
+
+    // tenants, weights, and capacity are checked
+    print_test(name, "priority_queue_fair_errors", test_fair_errors());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+#ifndef _WIN64
+bool test_delay_order ( void )
+{
+
+    // Initialized data
+    priority_queue_delay *p_delay = 0;
+    void                 *p_key   = 0;
+    timestamp             ms      = timer_seconds_divisor() / 1000,
+                          now     = timer_high_precision(),
+                          ready   = 0;
+    bool                  result  = true;
+
+    // Construct a delay queue
+    result = priority_queue_delay_construct(&p_delay, 10, 0);
+
+    // Two keys are ready, and one is ready in 200 milliseconds
+    result = result && priority_queue_delay_enqueue(p_delay, (void *) 3, now - 1)
+                    && priority_queue_delay_enqueue(p_delay, (void *) 1, now + 200 * ms)
+                    && priority_queue_delay_enqueue(p_delay, (void *) 2, 0);
+
+    // The ready keys are dequeued in order of priority, and the other key is not
+    result = result && priority_queue_delay_dequeue(p_delay, &p_key) && ( p_key == (void *) 2 );
+    result = result && priority_queue_delay_dequeue(p_delay, &p_key) && ( p_key == (void *) 3 );
+    result = result && ( priority_queue_delay_dequeue(p_delay, &p_key) == 0 );
+
+    // The next key is ready at its ready time
+    result = result && priority_queue_delay_next(p_delay, &ready) && ( ready == now + 200 * ms );
+
+    // A blocking dequeue sleeps until then
+    result = result && priority_queue_delay_dequeue_wait(p_delay, &p_key, 0) && ( p_key == (void *) 1 ) && ( timer_high_precision() >= ready );
+
+    // The delay queue is empty
+    result = result && ( priority_queue_delay_next(p_delay, &ready) == 0 );
+
+    // Free the delay queue
+    if ( p_delay ) priority_queue_delay_destroy(&p_delay);
+
+    // Return result
+    return result;
+}
+
+bool test_delay_batch ( void )
+{
+
+    // Initialized data
+    priority_queue_delay *p_delay  = 0;
+    void                 *p_key    = 0;
+    timestamp             ms       = timer_seconds_divisor() / 1000,
+                          now      = timer_high_precision(),
+                          deadline = 0;
+    bool                  result   = true;
+
+    // Construct a delay queue
+    result = priority_queue_delay_construct(&p_delay, 10, 0);
+
+    // Keys become ready in a different order than their priorities, and one much later
+    result = result && priority_queue_delay_enqueue(p_delay, (void *) 5, now + 10 * ms)
+                    && priority_queue_delay_enqueue(p_delay, (void *) 1, now + 30 * ms)
+                    && priority_queue_delay_enqueue(p_delay, (void *) 3, now + 20 * ms)
+                    && priority_queue_delay_enqueue(p_delay, (void *) 4, now + 100000 * ms);
+
+    // Once all three are ready, one dequeue moves them together, and they leave in order of priority
+    usleep(60000);
+    result = result && priority_queue_delay_dequeue(p_delay, &p_key) && ( p_key == (void *) 1 );
+    result = result && priority_queue_delay_dequeue(p_delay, &p_key) && ( p_key == (void *) 3 );
+    result = result && priority_queue_delay_dequeue(p_delay, &p_key) && ( p_key == (void *) 5 );
+    result = result && ( priority_queue_delay_dequeue(p_delay, &p_key) == 0 );
+
+    // A blocking dequeue gives up at its deadline
+    deadline = timer_high_precision() + 20 * ms;
+    result   = result && ( priority_queue_delay_dequeue_wait(p_delay, &p_key, deadline) == 0 ) && ( timer_high_precision() >= deadline );
+
+    // Free the delay queue
+    if ( p_delay ) priority_queue_delay_destroy(&p_delay);
+
+    // Return result
+    return result;
+}
+
+void *test_delay_waiter ( void *p_parameter )
+{
+
+    // Initialized data
+    priority_queue_delay *p_delay = p_parameter;
+    void                 *p_key   = 0;
+
+    // Sleep until a key is ready
+    if ( priority_queue_delay_dequeue_wait(p_delay, &p_key, 0) == 0 ) p_key = 0;
+
+    // Done
+    return p_key;
+}
+
+bool test_delay_wake ( void )
+{
+
+    // Initialized data
+    priority_queue_delay *p_delay = 0;
+    void                 *p_key   = 0;
+    pthread_t             waiter;
+    timestamp             ms      = timer_seconds_divisor() / 1000,
+                          start   = timer_high_precision();
+    bool                  result  = true;
+
+    // Construct a delay queue, with a key ready in 100 seconds
+    result = priority_queue_delay_construct(&p_delay, 10, 0)
+          && priority_queue_delay_enqueue(p_delay, (void *) 9, start + 100000 * ms);
+
+    // Start a thread that sleeps until a key is ready
+    if ( result ) pthread_create(&waiter, 0, test_delay_waiter, p_delay);
+
+    // A key that is ready wakes the thread, long before the other key
+    usleep(20000);
+    result = result && priority_queue_delay_enqueue(p_delay, (void *) 7, 0);
+    if ( p_delay ) pthread_join(waiter, &p_key);
+    result = result && ( p_key == (void *) 7 ) && ( timer_high_precision() - start < 10000 * ms );
+
+    // Free the delay queue
+    if ( p_delay ) priority_queue_delay_destroy(&p_delay);
+
+    // Return result
+    return result;
+}
+
+bool test_delay_errors ( void )
+{
+
+    // Initialized data
+    priority_queue_delay *p_delay = 0;
+    void                 *p_key   = 0;
+    timestamp             ready   = 0;
+    bool                  result  = true;
+
+    // Construct a delay queue of 2 keys
+    result = priority_queue_delay_construct(&p_delay, 2, 0);
+
+    // An empty delay queue has no keys
+    result = result && ( priority_queue_delay_dequeue(p_delay, &p_key) == 0 ) && ( priority_queue_delay_next(p_delay, &ready) == 0 );
+
+    // Delayed keys and ready keys share the capacity
+    result = result && priority_queue_delay_enqueue(p_delay, (void *) 1, 0) && priority_queue_delay_enqueue(p_delay, (void *) 2, timer_high_precision() + timer_seconds_divisor());
+    result = result && ( priority_queue_delay_enqueue(p_delay, (void *) 3, 0) == 0 );
+
+    // Null keys, and zero keys, are errors
+    result = result && ( priority_queue_delay_enqueue(p_delay, 0, 0) == 0 ) && ( priority_queue_delay_dequeue(p_delay, 0) == 0 );
+    result = result && ( priority_queue_delay_construct(&p_delay, 0, 0) == 0 ) && ( priority_queue_delay_construct(0, 2, 0) == 0 );
+
+    // Free the delay queue
+    if ( p_delay ) priority_queue_delay_destroy(&p_delay);
+
+    // Return result
+    return result;
+}
+#endif
+
+int test_delay_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    #ifndef _WIN64
+
+        // keys are dequeued in order of priority once ready, and a blocking dequeue sleeps until then
+        print_test(name, "priority_queue_delay_order", test_delay_order());
+
+        // every key that became ready is moved at once, and a blocking dequeue gives up at the deadline
+        print_test(name, "priority_queue_delay_batch", test_delay_batch());
+
+        // an enqueue wakes a sleeping thread
+        print_test(name, "priority_queue_delay_wake", test_delay_wake());
+
+        // capacity and arguments are checked
+        print_test(name, "priority_queue_delay_errors", test_delay_errors());
+    #endif
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_typed_dequeue ( priority_queue_priority_type type, size_t arity, size_t how_many )
+{
+
+    // Initialized data
+    priority_queue          *p_priority_queue = 0;
+    priority_queue_priority  priority         = { 0 },
+                             last             = { 0 };
+    void                    *p_value          = 0;
+    bool                     result           = true;
+    uint64_t                 state            = 0x9e3779b97f4a7c15ULL;
+
+    // Construct a typed priority queue
+    if ( priority_queue_construct_typed(&p_priority_queue, how_many, type, arity, 0) == 0 ) return false;
+
+    // Enqueue pseudo random priorities
+    for (size_t i = 1; result && i <= how_many; i++)
+    {
+
+        // Step the generator
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+
+        // Make a priority of the right type
+        if      ( type == PRIORITY_QUEUE_PRIORITY_U32   ) priority.u32 = (uint32_t) state;
+        else if ( type == PRIORITY_QUEUE_PRIORITY_U64   ) priority.u64 = state;
+        else                                              priority.f32 = (float) (int32_t) state / 65536.f;
+
+        // Enqueue the key
+        result = priority_queue_enqueue_priority(p_priority_queue, (void *) i, priority);
+    }
+
+    // Dequeue every key, checking the priorities never decrease
+    for (size_t i = 0; result && i < how_many; i++)
+    {
+
+        // Dequeue a key
+        result = priority_queue_dequeue_priority(p_priority_queue, &p_value, &priority) && p_value;
+
+        // Compare with the last priority
+        if ( result && i )
+        {
+            if      ( type == PRIORITY_QUEUE_PRIORITY_U32 ) result = last.u32 <= priority.u32;
+            else if ( type == PRIORITY_QUEUE_PRIORITY_U64 ) result = last.u64 <= priority.u64;
+            else                                            result = last.f32 <= priority.f32;
+        }
+
+        // Store the priority
+        last = priority;
+    }
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int typed_insertdecending_2000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct a typed priority queue, ordered by the value of each key
+    priority_queue_construct_typed(pp_priority_queue, 2000, PRIORITY_QUEUE_PRIORITY_U64, 8, 0);
+
+    // insert decending values
+    for (size_t i = 2000; i > 0; i--)
+        priority_queue_enqueue(*pp_priority_queue, (void *) i);
+
+    // priority queue = [1 ... 2000]
+    return 1;
+}
+
+int test_typed_priority_queue ( char *name )
+{
+
+    // Initialized data
+    const char *type_names[] = { 0, "u32", "u64", "float" };
+    char        test_name[64] = { 0 };
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Each type, and each arity
+    for (priority_queue_priority_type type = PRIORITY_QUEUE_PRIORITY_U32; type <= PRIORITY_QUEUE_PRIORITY_FLOAT; type++)
+        for (size_t arity = 2; arity <= 8; arity *= 2)
+        {
+
+            // Name the test
+            snprintf(test_name, sizeof(test_name), "priority_queue_dequeue_priority_%s_%zu", type_names[type], arity);
+
+            // Dequeue an odd number of keys, so the last group of children is partial
+            print_test(name, test_name, test_typed_dequeue(type, arity, 1001));
+        }
+
+    // Keys without an explicit priority are ordered by value
+    print_test(name, "priority_queue_dequeue_2000", test_dequeue_ascending(typed_insertdecending_2000, 2000));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+bool test_drain ( priority_queue *p_priority_queue, const void **expected_keys )
+{
+
+    // Initialized data
+    void *p_value = 0;
+
+    // Dequeue each expected key in order
+    for (size_t i = 0; expected_keys[i]; i++)
+    {
+
+        // Dequeue a value
+        if ( priority_queue_dequeue(p_priority_queue, &p_value) == 0 ) return false;
+
+        // Check for a match
+        if ( p_value != expected_keys[i] ) return false;
+    }
+
+    // The priority queue must now be empty
+    return priority_queue_empty(p_priority_queue);
+}
+
+#ifndef _WIN64
+int mapped_DFAC_checkpoint_B ( const char *path )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+
+    // Start from an empty file
+    remove(path);
+
+    // Construct a memory mapped priority queue
+    if ( priority_queue_construct_mapped(&p_priority_queue, path, 10, 0) == 0 ) return 0;
+
+    // insert(D, F, A, C)
+    priority_queue_enqueue(p_priority_queue, D_key);
+    priority_queue_enqueue(p_priority_queue, F_key);
+    priority_queue_enqueue(p_priority_queue, A_key);
+    priority_queue_enqueue(p_priority_queue, C_key);
+
+    // checkpoint()
+    priority_queue_checkpoint(p_priority_queue);
+
+    // insert(B)
+    priority_queue_enqueue(p_priority_queue, B_key);
+
+    // destroy() commits [A, B, C, D, F]
+    return priority_queue_destroy(&p_priority_queue);
+}
+
+int corrupt_mapped_header ( const char *path, long offset )
+{
+
+    // Initialized data
+    FILE *f = fopen(path, "r+b");
+    char  garbage[8] = { 0 };
+
+    // Error check
+    if ( f == (void *) 0 ) return 0;
+
+    // Overwrite the magic number of the header
+    fseek(f, offset, SEEK_SET);
+    fwrite(garbage, sizeof(garbage), 1, f);
+    fclose(f);
+
+    // Success
+    return 1;
+}
+
+int test_mapped_priority_queue ( char *name )
+{
+
+    // Initialized data
+    const char     *path             = "priority_queue_test.map";
+    priority_queue *p_priority_queue = 0;
+    bool            result           = false;
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Reopen the file, and check the last commit survived
+    mapped_DFAC_checkpoint_B(path);
+    result = priority_queue_construct_mapped(&p_priority_queue, path, 0, 0) && test_drain(p_priority_queue, ABCDF_keys);
+    priority_queue_destroy(&p_priority_queue);
+    print_test(name, "priority_queue_construct_mapped_reopen", result);
+
+    // Tear the most recent header, and check the previous checkpoint survived
+    mapped_DFAC_checkpoint_B(path);
+    corrupt_mapped_header(path, 0);
+    result = priority_queue_construct_mapped(&p_priority_queue, path, 0, 0) && test_drain(p_priority_queue, ACDF_keys);
+    priority_queue_destroy(&p_priority_queue);
+    print_test(name, "priority_queue_construct_mapped_torn_header", result);
+
+    // Tear both headers, and check the file is rejected
+    corrupt_mapped_header(path, 0);
+    corrupt_mapped_header(path, sysconf(_SC_PAGESIZE));
+    result = ( priority_queue_construct_mapped(&p_priority_queue, path, 0, 0) == 0 );
+    print_test(name, "priority_queue_construct_mapped_corrupt", result);
+
+    // Clean up
+    remove(path);
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+size_t serialize_decimal ( void *const p_buffer, size_t size, const void *const p_key )
+{
+
+    // Initialized data
+    char   text[32] = { 0 };
+    size_t len      = (size_t) snprintf(text, sizeof(text), "%zu", (size_t) p_key);
+
+    // Write the key as decimal text, without a null terminator, if it fits
+    if ( len <= size ) memcpy(p_buffer, text, len);
+
+    // Return the size of the record
+    return len;
+}
+
+int deserialize_decimal ( void **const pp_key, const void *const p_buffer, size_t size )
+{
+
+    // Initialized data
+    char   text[32] = { 0 };
+    size_t value    = 0;
+
+    // Error check
+    if ( size >= sizeof(text) ) return 0;
+
+    // Parse the key
+    memcpy(text, p_buffer, size);
+    if ( sscanf(text, "%zu", &value) != 1 ) return 0;
+
+    // Return the key
+    *pp_key = (void *) value;
+
+    // Success
+    return 1;
+}
+
+bool test_save_load ( const char *path, priority_queue_serialize_fn pfn_serialize, priority_queue_deserialize_fn pfn_deserialize )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0,
+                   *p_loaded         = 0;
+    int             fd               = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    bool            result           = false;
+
+    // Error check
+    if ( fd == -1 ) return false;
+
+    // Construct a [A, B, C, D, E, F, G] priority queue, and save it
+    empty_insertrandom_ABCDEFG(&p_priority_queue);
+    priority_queue_save(p_priority_queue, fd, pfn_serialize);
+    priority_queue_destroy(&p_priority_queue);
+
+    // Load the priority queue
+    lseek(fd, 0, SEEK_SET);
+    if ( priority_queue_load(&p_loaded, fd, 0, pfn_deserialize) )
+    {
+
+        // Check the keys come out in order
+        result = test_drain(p_loaded, ABCDEFG_keys);
+
+        // Free the priority queue
+        priority_queue_destroy(&p_loaded);
+    }
+
+    // Clean up
+    close(fd);
+    remove(path);
+
+    // Return result
+    return result;
+}
+
+int test_save_load_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Keys saved by value
+    print_test(name, "priority_queue_save_load_by_value", test_save_load("priority_queue_test.save", 0, 0));
+
+    // Keys saved through a serializer
+    print_test(name, "priority_queue_save_load_serialized", test_save_load("priority_queue_test.save", serialize_decimal, deserialize_decimal));
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+
+int external_insertdecending_5000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct an external priority queue, with room for 256 keys and 4 runs in memory
+    priority_queue_construct_external(pp_priority_queue, 4096, 512, 0, 0, 0, 0);
+
+    // insert decending values
+    for (size_t i = 5000; i > 0; i--)
+        priority_queue_enqueue(*pp_priority_queue, (void *) i);
+
+    // priority queue = [1 ... 5000]
+    return 1;
+}
+
+int external_insertrandom_5000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct an external priority queue, that serializes keys as text
+    priority_queue_construct_external(pp_priority_queue, 4096, 512, 0, 0, serialize_decimal, deserialize_decimal);
+
+    // insert a permutation of 1 ... 5000
+    for (size_t i = 0; i < 5000; i++)
+        priority_queue_enqueue(*pp_priority_queue, (void *) ( ( i * 7919 ) % 5000 + 1 ));
+
+    // priority queue = [1 ... 5000]
+    return 1;
+}
+
+int external_insertrandom_100000 ( priority_queue **pp_priority_queue )
+{
+
+    // Construct an external priority queue, with room for 256 keys and 4 runs in memory
+    priority_queue_construct_external(pp_priority_queue, 4096, 512, 0, 0, 0, 0);
+
+    // insert a permutation of 1 ... 100000, which spills runs across several levels
+    for (size_t i = 0; i < 100000; i++)
+        priority_queue_enqueue(*pp_priority_queue, (void *) ( ( i * 7919 ) % 100000 + 1 ));
+
+    // priority queue = [1 ... 100000]
+    return 1;
+}
+
+bool test_external_interleaved ( void )
+{
+
+    // Initialized data
+    priority_queue *p_priority_queue = 0;
+    void           *p_value          = 0;
+    bool            result           = true;
+
+    // Construct a [1 ... 5000] priority queue, with keys in memory and on disk
+    external_insertrandom_5000(&p_priority_queue);
+
+    // Dequeue 1 ... 1000
+    for (size_t i = 1; result && i <= 1000; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Enqueue 1 ... 1000 again, ahead of the keys on disk
+    for (size_t i = 1; result && i <= 1000; i++)
+        result = priority_queue_enqueue(p_priority_queue, (void *) i);
+
+    // Dequeue 1 ... 5000
+    for (size_t i = 1; result && i <= 5000; i++)
+        result = priority_queue_dequeue(p_priority_queue, &p_value) && ( p_value == (void *) i );
+
+    // Check the priority queue is empty
+    if ( result ) result = priority_queue_empty(p_priority_queue);
+
+    // Free the priority queue
+    priority_queue_destroy(&p_priority_queue);
+
+    // Return result
+    return result;
+}
+
+int test_external_priority_queue ( char *name )
+{
+
+    // Print the scenario name
+    log_info("Scenario: %s\n", name);
+
+    // Keys spilled by value
+    print_test(name, "priority_queue_dequeue_5000_by_value", test_dequeue_ascending(external_insertdecending_5000, 5000));
+
+    // Keys spilled through a serializer
+    print_test(name, "priority_queue_dequeue_5000_serialized", test_dequeue_ascending(external_insertrandom_5000, 5000));
+
+    // Runs merged level by level
+    print_test(name, "priority_queue_dequeue_100000_levels", test_dequeue_ascending(external_insertrandom_100000, 100000));
+
+    // Keys enqueued while others are on disk
+    print_test(name, "priority_queue_dequeue_interleaved", test_external_interleaved());
+
+    // Print the results
+    print_final_summary();
+
+    // Success
+    return 1;
+}
+#else
+int test_save_load_priority_queue ( char *name )
+{
+
+    // Not supported
+    (void) name;
+
+    // Success
+    return 1;
+}
+
+int test_mapped_priority_queue ( char *name )
+{
+
+    // Not supported
+    (void) name;
+
+    // Success
+    return 1;
+}
+
+int test_external_priority_queue ( char *name )
+{
+
+    // Not supported
+    (void) name;
+
+    // Success
+    return 1;
+}
+#endif